@@ -0,0 +1,123 @@
+#include "AccumulationBuffer.h"
+
+#include "Simd.h"
+#include "VariableCache.h"
+
+#include <algorithm>
+
+namespace
+{
+	// Radical inverse of index in base, the Halton sequence spreads samples evenly for any count
+	float Halton(int index, int base)
+	{
+		float result = 0.0f;
+		float fraction = 1.0f / base;
+		while (index > 0)
+		{
+			result += (index % base) * fraction;
+			index /= base;
+			fraction /= base;
+		}
+		return result;
+	}
+}
+
+AccumulationBuffer* AccumulationBuffer::Get()
+{
+	static AccumulationBuffer sInstance;
+	return &sInstance;
+}
+
+void AccumulationBuffer::OnNewFrame()
+{
+	mSamplesPerFrame = 0;
+	mMaxSamples = 0;
+
+	const uint32_t variableVersion = VariableCache::Get()->GetVersion();
+	if (variableVersion != mVariableVersion)
+	{
+		mVariableVersion = variableVersion;
+		Reset();
+	}
+}
+
+void AccumulationBuffer::SetAccumulation(int samplesPerFrame, int maxSamples)
+{
+	mSamplesPerFrame = std::max(samplesPerFrame, 0);
+	mMaxSamples = std::max(maxSamples, 1);
+}
+
+Vector2 AccumulationBuffer::GetJitter() const
+{
+	if (!IsEnabled() || IsConverged())
+		return Vector2();
+
+	// Index 0 would put the first sample on a pixel corner
+	return Vector2(Halton(mSampleCount + 1, 2) - 0.5f, Halton(mSampleCount + 1, 3) - 0.5f);
+}
+
+void AccumulationBuffer::AddSample(const uint32_t* pixels, int width, int height)
+{
+	if (width != mWidth || height != mHeight)
+	{
+		mWidth = width;
+		mHeight = height;
+		Reset();
+	}
+
+	if (IsConverged())
+		return;
+
+	const int count = mWidth * mHeight;
+	float* sum = mSum.data();
+#if PIX_SSE
+	const __m128i zero = _mm_setzero_si128();
+	for (int i = 0; i < count; ++i)
+	{
+		const __m128i bytes = _mm_cvtsi32_si128(static_cast<int>(pixels[i]));
+		const __m128 channels = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+		_mm_storeu_ps(sum + i * 4, _mm_add_ps(_mm_loadu_ps(sum + i * 4), channels));
+	}
+#else
+	for (int i = 0; i < count; ++i)
+	{
+		for (int c = 0; c < 4; ++c)
+			sum[i * 4 + c] += static_cast<float>((pixels[i] >> (c * 8)) & 0xff);
+	}
+#endif
+	++mSampleCount;
+}
+
+void AccumulationBuffer::Resolve(uint32_t* pixels) const
+{
+	if (mSampleCount == 0)
+		return;
+
+	// Samples are already in display range, so the average only needs rounding back to 8 bits
+	const int count = mWidth * mHeight;
+	const float scale = 1.0f / mSampleCount;
+	const float* sum = mSum.data();
+#if PIX_SSE
+	const __m128 scale4 = _mm_set1_ps(scale);
+	for (int i = 0; i < count; ++i)
+	{
+		__m128i values = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(sum + i * 4), scale4));
+		values = _mm_packs_epi32(values, values);
+		pixels[i] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(values, values)));
+	}
+#else
+	for (int i = 0; i < count; ++i)
+	{
+		uint32_t color = 0;
+		for (int c = 0; c < 4; ++c)
+			color |= static_cast<uint32_t>(std::min(sum[i * 4 + c] * scale + 0.5f, 255.0f)) << (c * 8);
+		pixels[i] = color;
+	}
+#endif
+}
+
+void AccumulationBuffer::Reset()
+{
+	mSum.assign(static_cast<size_t>(mWidth) * mHeight * 4, 0.0f);
+	mSampleCount = 0;
+}
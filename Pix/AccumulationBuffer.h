@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Vector2.h"
+
+#include <cstdint>
+#include <vector>
+
+// Running sum of the frames rendered while the scene stays the same, so iterative renders converge
+// over several editor frames instead of blocking one. Every sample is drawn with a different subpixel
+// jitter and the average of the samples so far is what gets presented. The sum starts over when a
+// script variable changes, when the script is recompiled (which clears the variables) or on a resize.
+class AccumulationBuffer
+{
+public:
+	static AccumulationBuffer* Get();
+
+public:
+	void OnNewFrame();
+
+	// Off with 0 samples per frame, reset every frame so only scripts that ask for it accumulate.
+	// Stops adding samples once it has maxSamples.
+	void SetAccumulation(int samplesPerFrame, int maxSamples);
+
+	bool IsEnabled() const { return mSamplesPerFrame > 0; }
+	bool IsConverged() const { return mSampleCount >= mMaxSamples; }
+	int GetSamplesPerFrame() const { return mSamplesPerFrame; }
+	int GetSampleCount() const { return mSampleCount; }
+	int GetMaxSamples() const { return mMaxSamples; }
+
+	// Pixel offset to render the next sample at, zero when not accumulating
+	Vector2 GetJitter() const;
+
+	// Adds a resolved frame, ignored once converged
+	void AddSample(const uint32_t* pixels, int width, int height);
+
+	// Writes the average of the samples so far back as RGBA8
+	void Resolve(uint32_t* pixels) const;
+
+	void Reset();
+
+private:
+	std::vector<float> mSum;	// Premultiplied RGBA in 0..255, 4 floats per pixel
+	int mWidth = 0;
+	int mHeight = 0;
+	int mSampleCount = 0;
+	int mSamplesPerFrame = 0;
+	int mMaxSamples = 0;
+	uint32_t mVariableVersion = 0;
+};
@@ -0,0 +1,239 @@
+#include "Blend.h"
+
+#include "Simd.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	const float kInv255 = 1.0f / 255.0f;
+
+	// Exact round(x / 255) for x in 0..255*255
+	uint32_t Div255(uint32_t x)
+	{
+		x += 128;
+		return (x + (x >> 8)) >> 8;
+	}
+
+	uint32_t BlendChannel(BlendMode mode, uint32_t dest, uint32_t source, uint32_t destAlpha, uint32_t sourceAlpha)
+	{
+		uint32_t result = 0;
+		switch (mode)
+		{
+		case BlendMode::Over:
+			result = source + Div255(dest * (255 - sourceAlpha));
+			break;
+		case BlendMode::Add:
+			result = source + dest;
+			break;
+		case BlendMode::Multiply:
+			result = Div255(source * dest + source * (255 - destAlpha) + dest * (255 - sourceAlpha));
+			break;
+		case BlendMode::Screen:
+			result = source + dest - Div255(source * dest);
+			break;
+		}
+		return std::min(result, 255u);
+	}
+
+#if PIX_SSE
+	__m128i Div255(__m128i x)
+	{
+		x = _mm_add_epi16(x, _mm_set1_epi16(128));
+		return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+	}
+
+	// Copies the alpha of each pixel to its four 16 bit lanes
+	__m128i BroadcastAlpha(__m128i color)
+	{
+		return _mm_shufflehi_epi16(_mm_shufflelo_epi16(color, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	}
+
+	// Blends two pixels widened to 16 bits per channel
+	template <BlendMode mode>
+	__m128i BlendWide(__m128i dest, __m128i source)
+	{
+		const __m128i k255 = _mm_set1_epi16(255);
+		const __m128i sourceAlpha = BroadcastAlpha(source);
+		if (mode == BlendMode::Over)
+			return _mm_add_epi16(source, Div255(_mm_mullo_epi16(dest, _mm_sub_epi16(k255, sourceAlpha))));
+		if (mode == BlendMode::Multiply)
+		{
+			const __m128i destAlpha = BroadcastAlpha(dest);
+			__m128i sum = _mm_mullo_epi16(source, dest);
+			sum = _mm_add_epi16(sum, _mm_mullo_epi16(source, _mm_sub_epi16(k255, destAlpha)));
+			sum = _mm_add_epi16(sum, _mm_mullo_epi16(dest, _mm_sub_epi16(k255, sourceAlpha)));
+			return Div255(sum);
+		}
+		return _mm_sub_epi16(_mm_add_epi16(source, dest), Div255(_mm_mullo_epi16(source, dest)));
+	}
+
+	template <BlendMode mode>
+	__m128i Blend4(__m128i dest, __m128i source)
+	{
+		// Saturating byte add is the whole of additive blending
+		if (mode == BlendMode::Add)
+			return _mm_adds_epu8(dest, source);
+
+		if (mode == BlendMode::Over)
+		{
+			// Opaque sources replace, transparent ones leave the dest alone
+			const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xff000000));
+			const __m128i alpha = _mm_and_si128(source, alphaMask);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask)) == 0xffff)
+				return source;
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, _mm_setzero_si128())) == 0xffff)
+				return dest;
+		}
+
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i low = BlendWide<mode>(_mm_unpacklo_epi8(dest, zero), _mm_unpacklo_epi8(source, zero));
+		const __m128i high = BlendWide<mode>(_mm_unpackhi_epi8(dest, zero), _mm_unpackhi_epi8(source, zero));
+		return _mm_packus_epi16(low, high);
+	}
+#endif
+
+	template <BlendMode mode>
+	void BlendLoop(uint32_t* dest, const uint32_t* source, int count)
+	{
+		int i = 0;
+#if PIX_SSE
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest + i));
+			const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), Blend4<mode>(d, s));
+		}
+#endif
+		for (; i < count; ++i)
+			dest[i] = Blend::BlendPixel(mode, dest[i], source[i]);
+	}
+}
+
+uint32_t Blend::PackPremultiplied(const X::Color& color)
+{
+	const float scale = X::Math::Clamp(color.w, 0.0f, 1.0f) * 255.0f;
+	const uint32_t r = static_cast<uint32_t>(X::Math::Clamp(color.x, 0.0f, 1.0f) * scale + 0.5f);
+	const uint32_t g = static_cast<uint32_t>(X::Math::Clamp(color.y, 0.0f, 1.0f) * scale + 0.5f);
+	const uint32_t b = static_cast<uint32_t>(X::Math::Clamp(color.z, 0.0f, 1.0f) * scale + 0.5f);
+	const uint32_t a = static_cast<uint32_t>(scale + 0.5f);
+	return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+uint32_t Blend::PackColor(const X::Color& color)
+{
+	const uint32_t r = static_cast<uint32_t>(X::Math::Clamp(color.x, 0.0f, 1.0f) * 255.0f + 0.5f);
+	const uint32_t g = static_cast<uint32_t>(X::Math::Clamp(color.y, 0.0f, 1.0f) * 255.0f + 0.5f);
+	const uint32_t b = static_cast<uint32_t>(X::Math::Clamp(color.z, 0.0f, 1.0f) * 255.0f + 0.5f);
+	const uint32_t a = static_cast<uint32_t>(X::Math::Clamp(color.w, 0.0f, 1.0f) * 255.0f + 0.5f);
+	return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+X::Color Blend::UnpackColor(uint32_t color)
+{
+	return X::Color(
+		(color & 0xff) * kInv255,
+		((color >> 8) & 0xff) * kInv255,
+		((color >> 16) & 0xff) * kInv255,
+		(color >> 24) * kInv255);
+}
+
+uint32_t Blend::LerpColor(uint32_t from, uint32_t to, float t)
+{
+	uint32_t result = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		const float a = static_cast<float>((from >> shift) & 0xff);
+		const float b = static_cast<float>((to >> shift) & 0xff);
+		result |= static_cast<uint32_t>(a + (b - a) * t + 0.5f) << shift;
+	}
+	return result;
+}
+
+void Blend::BlendPixels(BlendMode mode, uint32_t* dest, const uint32_t* source, int count)
+{
+	switch (mode)
+	{
+	case BlendMode::Over:		BlendLoop<BlendMode::Over>(dest, source, count); break;
+	case BlendMode::Add:		BlendLoop<BlendMode::Add>(dest, source, count); break;
+	case BlendMode::Multiply:	BlendLoop<BlendMode::Multiply>(dest, source, count); break;
+	case BlendMode::Screen:		BlendLoop<BlendMode::Screen>(dest, source, count); break;
+	}
+}
+
+uint32_t Blend::BlendPixel(BlendMode mode, uint32_t dest, uint32_t source)
+{
+	const uint32_t sourceAlpha = source >> 24;
+	if (mode == BlendMode::Over && sourceAlpha == 255)
+		return source;
+
+	const uint32_t destAlpha = dest >> 24;
+	uint32_t result = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+		result |= BlendChannel(mode, (dest >> shift) & 0xff, (source >> shift) & 0xff, destAlpha, sourceAlpha) << shift;
+	return result;
+}
+
+void Blend::BlendPixelsReference(BlendMode mode, uint32_t* dest, const uint32_t* source, int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		const uint32_t destAlpha = dest[i] >> 24;
+		const uint32_t sourceAlpha = source[i] >> 24;
+		uint32_t result = 0;
+		for (int shift = 0; shift < 32; shift += 8)
+			result |= BlendChannel(mode, (dest[i] >> shift) & 0xff, (source[i] >> shift) & 0xff, destAlpha, sourceAlpha) << shift;
+		dest[i] = result;
+	}
+}
+
+uint32_t Blend::CheckKernels()
+{
+	// Odd count so the scalar tail is covered too
+	const int kCount = 4099;
+
+	// Premultiplied pixels from a fixed LCG, with fully transparent and opaque runs mixed in
+	uint32_t seed = 12345;
+	auto random = [&seed]()
+	{
+		seed = seed * 1664525u + 1013904223u;
+		return seed >> 24;
+	};
+	auto randomPixel = [&random](int index)
+	{
+		uint32_t alpha = random();
+		if ((index / 8) % 4 == 1)
+			alpha = 255;
+		else if ((index / 8) % 4 == 2)
+			alpha = 0;
+
+		uint32_t pixel = alpha << 24;
+		for (int shift = 0; shift < 24; shift += 8)
+			pixel |= (alpha > 0 ? random() % (alpha + 1) : 0) << shift;
+		return pixel;
+	};
+
+	std::vector<uint32_t> source(kCount);
+	std::vector<uint32_t> dest(kCount);
+	for (int i = 0; i < kCount; ++i)
+	{
+		source[i] = randomPixel(i);
+		dest[i] = randomPixel(i + 16);
+	}
+
+	uint32_t mismatches = 0;
+	for (BlendMode mode : { BlendMode::Over, BlendMode::Add, BlendMode::Multiply, BlendMode::Screen })
+	{
+		std::vector<uint32_t> simd = dest;
+		std::vector<uint32_t> reference = dest;
+		BlendPixels(mode, simd.data(), source.data(), kCount);
+		BlendPixelsReference(mode, reference.data(), source.data(), kCount);
+		for (int i = 0; i < kCount; ++i)
+		{
+			if (simd[i] != reference[i])
+				++mismatches;
+		}
+	}
+	return mismatches;
+}
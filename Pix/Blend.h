@@ -0,0 +1,37 @@
+#pragma once
+
+#include <XEngine.h>
+
+#include <cstdint>
+
+enum class BlendMode
+{
+	Over,
+	Add,
+	Multiply,
+	Screen
+};
+
+// Blending of packed RGBA8 colors, red in the low byte. All colors are premultiplied by alpha,
+// so every mode is one formula applied to all four channels and opaque results stay opaque.
+namespace Blend
+{
+	// Clamps to 0..1 and premultiplies by alpha
+	uint32_t PackPremultiplied(const X::Color& color);
+
+	// Clamps to 0..1 for colors that are already premultiplied
+	uint32_t PackColor(const X::Color& color);
+	X::Color UnpackColor(uint32_t color);
+	uint32_t LerpColor(uint32_t from, uint32_t to, float t);
+
+	// Blends count source pixels onto dest, 4 pixels per instruction where SSE2 is available
+	void BlendPixels(BlendMode mode, uint32_t* dest, const uint32_t* source, int count);
+	uint32_t BlendPixel(BlendMode mode, uint32_t dest, uint32_t source);
+
+	// Scalar version of BlendPixels, the reference the SIMD kernels must match exactly
+	void BlendPixelsReference(BlendMode mode, uint32_t* dest, const uint32_t* source, int count);
+
+	// Compares BlendPixels against BlendPixelsReference on generated pixels for every mode,
+	// returns the number of mismatching pixels
+	uint32_t CheckKernels();
+}
@@ -0,0 +1,58 @@
+#include "Camera.h"
+
+#include "MathHelper.h"
+
+#include <XEngine.h>
+
+Camera* Camera::Get()
+{
+	static Camera sInstance;
+	return &sInstance;
+}
+
+void Camera::OnNewFrame()
+{
+	// Default to looking down +z from the origin
+	SetCamera(Vector3(), Vector3(0.0f, 0.0f, 1.0f));
+	SetProjection(60.0f, 0.1f, 100.0f);
+}
+
+void Camera::SetCamera(const Vector3& position, const Vector3& target)
+{
+	// Fall back to a different up vector when looking straight up or down
+	const Vector3 look = MathHelper::Normalize(target - position);
+	const Vector3 up = std::abs(look.y) > 0.999f ? Vector3(0.0f, 0.0f, 1.0f) : Vector3(0.0f, 1.0f, 0.0f);
+	const Vector3 right = MathHelper::Normalize(MathHelper::Cross(up, look));
+	const Vector3 cameraUp = MathHelper::Cross(look, right);
+
+	mView = Matrix4(
+		right.x, cameraUp.x, look.x, 0.0f,
+		right.y, cameraUp.y, look.y, 0.0f,
+		right.z, cameraUp.z, look.z, 0.0f,
+		-MathHelper::Dot(right, position), -MathHelper::Dot(cameraUp, position), -MathHelper::Dot(look, position), 1.0f);
+	mPosition = position;
+	mRight = right;
+	mUp = cameraUp;
+	mLook = look;
+	++mVersion;
+}
+
+void Camera::SetProjection(float fovDegrees, float nearPlane, float farPlane)
+{
+	mFov = X::Math::Clamp(fovDegrees, 1.0f, 179.0f);
+	mNearPlane = X::Math::Max(nearPlane, 0.001f);
+	mFarPlane = X::Math::Max(farPlane, mNearPlane + 0.001f);
+	++mVersion;
+}
+
+Matrix4 Camera::GetProjectionMatrix(float aspectRatio) const
+{
+	const float h = 1.0f / tanf(mFov * 0.5f * X::Math::kDegToRad);
+	const float w = h / aspectRatio;
+	const float zScale = mFarPlane / (mFarPlane - mNearPlane);
+	return Matrix4(
+		w, 0.0f, 0.0f, 0.0f,
+		0.0f, h, 0.0f, 0.0f,
+		0.0f, 0.0f, zScale, 1.0f,
+		0.0f, 0.0f, -mNearPlane * zScale, 0.0f);
+}
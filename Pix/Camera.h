@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Matrix4.h"
+
+#include <cstdint>
+
+class Camera
+{
+public:
+	static Camera* Get();
+
+public:
+	void OnNewFrame();
+
+	void SetCamera(const Vector3& position, const Vector3& target);
+	void SetProjection(float fovDegrees, float nearPlane, float farPlane);
+
+	const Matrix4& GetViewMatrix() const { return mView; }
+
+	// World space position and axes, look points at the target
+	const Vector3& GetPosition() const { return mPosition; }
+	const Vector3& GetRight() const { return mRight; }
+	const Vector3& GetUp() const { return mUp; }
+	const Vector3& GetLook() const { return mLook; }
+	float GetFov() const { return mFov; }
+
+	// Left handed, depth maps to [0, 1], aspect ratio is given by the caller
+	Matrix4 GetProjectionMatrix(float aspectRatio) const;
+
+	// Bumped whenever the camera changes so users can cache what they derive from it
+	uint32_t GetVersion() const { return mVersion; }
+
+private:
+	Matrix4 mView;
+	Vector3 mPosition;
+	Vector3 mRight;
+	Vector3 mUp;
+	Vector3 mLook;
+	float mFov = 60.0f;
+	float mNearPlane = 0.1f;
+	float mFarPlane = 100.0f;
+	uint32_t mVersion = 0;
+};
@@ -0,0 +1,248 @@
+#include "Clipper.h"
+
+#include "Blend.h"
+#include "Viewport.h"
+
+namespace
+{
+	// Triangles inside the clip rect grown by this many pixels are only scissored by the rasterizer
+	const float kGuardBand = 2048.0f;
+
+	// Smallest w kept in front of the eye
+	const float kNearW = 1e-5f;
+
+	// Cohen-Sutherland region codes
+	const int kInside = 0;
+	const int kLeft = 1 << 0;
+	const int kRight = 1 << 1;
+	const int kTop = 1 << 2;
+	const int kBottom = 1 << 3;
+
+	int GetOutCode(float x, float y, const ClipRect& rect)
+	{
+		int code = kInside;
+		if (x < rect.minX)
+			code |= kLeft;
+		else if (x > rect.maxX)
+			code |= kRight;
+		if (y < rect.minY)
+			code |= kTop;
+		else if (y > rect.maxY)
+			code |= kBottom;
+		return code;
+	}
+
+	Vertex LerpVertex(const Vertex& a, const Vertex& b, float t)
+	{
+		Vertex v;
+		v.pos = a.pos + (b.pos - a.pos) * t;
+		v.w = a.w + (b.w - a.w) * t;
+		v.color = Blend::LerpColor(a.color, b.color, t);
+		v.uv = a.uv + (b.uv - a.uv) * t;
+		return v;
+	}
+
+	// Homogeneous clip plane: a * x + b * y + c * w + d >= 0 is inside
+	struct ClipPlane
+	{
+		float a, b, c, d;
+
+		float GetDistance(const Vertex& v) const
+		{
+			return a * v.pos.x + b * v.pos.y + c * v.w + d;
+		}
+	};
+
+	void ClipPolygon(const ClipPlane& plane, const std::vector<Vertex>& input, std::vector<Vertex>& output)
+	{
+		output.clear();
+
+		const size_t count = input.size();
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Vertex& current = input[i];
+			const Vertex& next = input[(i + 1) % count];
+			const float currentDist = plane.GetDistance(current);
+			const float nextDist = plane.GetDistance(next);
+
+			if (currentDist >= 0.0f)
+				output.push_back(current);
+
+			// Edge crosses the plane, emit the intersection
+			if ((currentDist >= 0.0f) != (nextDist >= 0.0f))
+			{
+				const float t = currentDist / (currentDist - nextDist);
+				output.push_back(LerpVertex(current, next, t));
+			}
+		}
+	}
+}
+
+Clipper* Clipper::Get()
+{
+	static Clipper sInstance;
+	return &sInstance;
+}
+
+ClipRect Clipper::GetClipRect() const
+{
+	const Viewport* viewport = Viewport::Get();
+
+	ClipRect rect;
+	if (viewport->IsClipping())
+	{
+		rect.minX = static_cast<int>(std::ceil(viewport->GetMinX()));
+		rect.minY = static_cast<int>(std::ceil(viewport->GetMinY()));
+		rect.maxX = static_cast<int>(std::ceil(viewport->GetMaxX())) - 1;
+		rect.maxY = static_cast<int>(std::ceil(viewport->GetMaxY())) - 1;
+	}
+	else
+	{
+		rect.maxX = viewport->GetScreenWidth() - 1;
+		rect.maxY = viewport->GetScreenHeight() - 1;
+	}
+	return rect;
+}
+
+bool Clipper::ClipPoint(int x, int y) const
+{
+	const ClipRect rect = GetClipRect();
+	return x >= rect.minX && x <= rect.maxX && y >= rect.minY && y <= rect.maxY;
+}
+
+bool Clipper::ClipLine(Vertex& v0, Vertex& v1) const
+{
+	const ClipRect rect = GetClipRect();
+	if (rect.IsEmpty())
+		return false;
+
+	const float minX = static_cast<float>(rect.minX);
+	const float minY = static_cast<float>(rect.minY);
+	const float maxX = static_cast<float>(rect.maxX);
+	const float maxY = static_cast<float>(rect.maxY);
+
+	int code0 = GetOutCode(v0.pos.x, v0.pos.y, rect);
+	int code1 = GetOutCode(v1.pos.x, v1.pos.y, rect);
+	while (true)
+	{
+		// Both ends inside, trivially accept
+		if ((code0 | code1) == kInside)
+			return true;
+
+		// Both ends share an outside region, trivially reject
+		if ((code0 & code1) != kInside)
+			return false;
+
+		// Move the outside end point onto the boundary it crossed
+		const int code = (code0 != kInside) ? code0 : code1;
+		const float dx = v1.pos.x - v0.pos.x;
+		const float dy = v1.pos.y - v0.pos.y;
+		float t = 0.0f;
+		if (code & kTop)
+			t = (minY - v0.pos.y) / dy;
+		else if (code & kBottom)
+			t = (maxY - v0.pos.y) / dy;
+		else if (code & kLeft)
+			t = (minX - v0.pos.x) / dx;
+		else
+			t = (maxX - v0.pos.x) / dx;
+
+		Vertex v = LerpVertex(v0, v1, t);
+		if (code & (kTop | kBottom))
+			v.pos.y = (code & kTop) ? minY : maxY;
+		else
+			v.pos.x = (code & kLeft) ? minX : maxX;
+
+		if (code == code0)
+		{
+			v0 = v;
+			code0 = GetOutCode(v0.pos.x, v0.pos.y, rect);
+		}
+		else
+		{
+			v1 = v;
+			code1 = GetOutCode(v1.pos.x, v1.pos.y, rect);
+		}
+	}
+}
+
+bool Clipper::ClipPointNear(const Vertex& v) const
+{
+	return v.w >= kNearW;
+}
+
+bool Clipper::ClipLineNear(Vertex& v0, Vertex& v1) const
+{
+	const bool inside0 = v0.w >= kNearW;
+	const bool inside1 = v1.w >= kNearW;
+	if (inside0 && inside1)
+		return true;
+	if (!inside0 && !inside1)
+		return false;
+
+	// Move the end point behind the eye onto the near plane
+	const float t = (kNearW - v0.w) / (v1.w - v0.w);
+	Vertex& outside = inside0 ? v1 : v0;
+	outside = LerpVertex(v0, v1, t);
+	return true;
+}
+
+bool Clipper::ClipTriangle(std::vector<Vertex>& vertices) const
+{
+	const ClipRect rect = GetClipRect();
+	if (rect.IsEmpty() || vertices.size() < 3)
+		return false;
+
+	// Pixel centers sit on integer coordinates, so the covered area reaches half a pixel out
+	const float minX = rect.minX - 0.5f;
+	const float minY = rect.minY - 0.5f;
+	const float maxX = rect.maxX + 0.5f;
+	const float maxY = rect.maxY + 0.5f;
+
+	const ClipPlane rectPlanes[] =
+	{
+		{ 1.0f, 0.0f, -minX, 0.0f },
+		{ -1.0f, 0.0f, maxX, 0.0f },
+		{ 0.0f, 1.0f, -minY, 0.0f },
+		{ 0.0f, -1.0f, maxY, 0.0f }
+	};
+	const ClipPlane guardBandPlanes[] =
+	{
+		{ 1.0f, 0.0f, -(minX - kGuardBand), 0.0f },
+		{ -1.0f, 0.0f, maxX + kGuardBand, 0.0f },
+		{ 0.0f, 1.0f, -(minY - kGuardBand), 0.0f },
+		{ 0.0f, -1.0f, maxY + kGuardBand, 0.0f },
+		{ 0.0f, 0.0f, 1.0f, -kNearW }
+	};
+
+	// Trivially reject if every vertex is outside the same edge of the clip rect
+	for (const ClipPlane& plane : rectPlanes)
+	{
+		bool allOutside = true;
+		for (const Vertex& v : vertices)
+			allOutside = allOutside && plane.GetDistance(v) < 0.0f;
+		if (allOutside)
+			return false;
+	}
+
+	// Inside the guard band the rasterizer scissor is enough, skip the polygon clip
+	bool insideGuardBand = true;
+	for (const Vertex& v : vertices)
+	{
+		for (const ClipPlane& plane : guardBandPlanes)
+			insideGuardBand = insideGuardBand && plane.GetDistance(v) >= 0.0f;
+	}
+	if (insideGuardBand)
+		return true;
+
+	// Sutherland-Hodgman against the guard band and near planes
+	static std::vector<Vertex> sScratch;
+	for (const ClipPlane& plane : guardBandPlanes)
+	{
+		ClipPolygon(plane, vertices, sScratch);
+		vertices.swap(sScratch);
+		if (vertices.size() < 3)
+			return false;
+	}
+	return true;
+}
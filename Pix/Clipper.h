@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Vertex.h"
+
+#include <vector>
+
+// Inclusive pixel bounds that every rasterized pixel is guaranteed to fall in
+struct ClipRect
+{
+	int minX = 0;
+	int minY = 0;
+	int maxX = -1;
+	int maxY = -1;
+
+	bool IsEmpty() const { return maxX < minX || maxY < minY; }
+};
+
+class Clipper
+{
+public:
+	static Clipper* Get();
+
+public:
+	// Viewport rect when clipping is on, otherwise the full screen
+	ClipRect GetClipRect() const;
+
+	// Screen space tests, run once per primitive so fill loops can skip bounds checks
+	bool ClipPoint(int x, int y) const;
+	bool ClipLine(Vertex& v0, Vertex& v1) const;
+
+	// Homogeneous space clips, done before the perspective divide
+	bool ClipPointNear(const Vertex& v) const;
+	bool ClipLineNear(Vertex& v0, Vertex& v1) const;
+	bool ClipTriangle(std::vector<Vertex>& vertices) const;
+};
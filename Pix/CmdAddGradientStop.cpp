@@ -0,0 +1,21 @@
+#include "CmdAddGradientStop.h"
+
+#include "Rasterizer.h"
+#include "VariableCache.h"
+
+bool CmdAddGradientStop::Execute(const std::vector<std::string>& params)
+{
+	// Need 4 params for offset, r, g, b
+	if (params.size() < 4)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const float offset = vc->GetFloat(params[0]);
+	const float r = vc->GetFloat(params[1]);
+	const float g = vc->GetFloat(params[2]);
+	const float b = vc->GetFloat(params[3]);
+	const float a = params.size() > 4 ? vc->GetFloat(params[4]) : 1.0f;
+
+	Rasterizer::Get()->AddGradientStop(offset, X::Color(r, g, b, a));
+	return true;
+}
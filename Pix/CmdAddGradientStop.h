@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdAddGradientStop : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "AddGradientStop";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"AddGradientStop(offset, r, g, b, <a>)\n"
+			"\n"
+			"- Adds a color to the current gradient at offset 0 to 1 along it.\n"
+			"- Colors between two stops are blended, two stops at the same offset\n"
+			"  make a hard edge.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,14 @@
+#include "CmdAddMesh.h"
+
+#include "MeshCache.h"
+#include "RayTracer.h"
+
+bool CmdAddMesh::Execute(const std::vector<std::string>& /*params*/)
+{
+	const Mesh* mesh = MeshCache::Get()->GetCurrentMesh();
+	if (mesh == nullptr)
+		return false;
+
+	RayTracer::Get()->AddMesh(*mesh);
+	return true;
+}
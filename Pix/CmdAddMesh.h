@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdAddMesh : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "AddMesh";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"AddMesh()\n"
+			"\n"
+			"- Adds the triangles of the last loaded mesh to the ray traced scene.\n"
+			"- The vertices go through the matrix stack, the mesh takes the current color.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
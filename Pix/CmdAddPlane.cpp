@@ -0,0 +1,19 @@
+#include "CmdAddPlane.h"
+
+#include "RayTracer.h"
+#include "VariableCache.h"
+
+bool CmdAddPlane::Execute(const std::vector<std::string>& params)
+{
+	// Need 4 params for normal and distance
+	if (params.size() < 4)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const float nx = vc->GetFloat(params[0]);
+	const float ny = vc->GetFloat(params[1]);
+	const float nz = vc->GetFloat(params[2]);
+	const float distance = vc->GetFloat(params[3]);
+	RayTracer::Get()->AddPlane(Vector3(nx, ny, nz), distance);
+	return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdAddPlane : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "AddPlane";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"AddPlane(nx, ny, nz, distance)\n"
+			"\n"
+			"- Adds the plane of points p with dot(n, p) = distance to the ray traced scene.\n"
+			"- Planes are in world space and take the current color.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
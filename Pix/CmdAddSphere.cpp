@@ -0,0 +1,19 @@
+#include "CmdAddSphere.h"
+
+#include "RayTracer.h"
+#include "VariableCache.h"
+
+bool CmdAddSphere::Execute(const std::vector<std::string>& params)
+{
+	// Need 4 params for center and radius
+	if (params.size() < 4)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const float x = vc->GetFloat(params[0]);
+	const float y = vc->GetFloat(params[1]);
+	const float z = vc->GetFloat(params[2]);
+	const float radius = vc->GetFloat(params[3]);
+	RayTracer::Get()->AddSphere(Vector3(x, y, z), radius);
+	return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdAddSphere : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "AddSphere";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"AddSphere(x, y, z, radius)\n"
+			"\n"
+			"- Adds a sphere to the ray traced scene in the current color.\n"
+			"- The center goes through the matrix stack, the radius takes its x axis scale.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
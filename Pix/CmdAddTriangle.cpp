@@ -0,0 +1,22 @@
+#include "CmdAddTriangle.h"
+
+#include "RayTracer.h"
+#include "VariableCache.h"
+
+bool CmdAddTriangle::Execute(const std::vector<std::string>& params)
+{
+	// Need 9 params for three corners
+	if (params.size() < 9)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	Vector3 corners[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		corners[i].x = vc->GetFloat(params[i * 3]);
+		corners[i].y = vc->GetFloat(params[i * 3 + 1]);
+		corners[i].z = vc->GetFloat(params[i * 3 + 2]);
+	}
+	RayTracer::Get()->AddTriangle(corners[0], corners[1], corners[2]);
+	return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdAddTriangle : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "AddTriangle";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"AddTriangle(x0, y0, z0, x1, y1, z1, x2, y2, z2)\n"
+			"\n"
+			"- Adds a triangle to the ray traced scene in the current color.\n"
+			"- The corners go through the matrix stack.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
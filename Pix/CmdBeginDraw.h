@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdBeginDraw : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "BeginDraw";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"BeginDraw(topology, <applyTransform>)\n"
+			"\n"
+			"- Begins collecting vertices for drawing.\n"
+			"- Topology can be point, line or triangle.\n"
+			"- Optional applyTransform (true or false) sends vertices through the matrix stack and camera.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
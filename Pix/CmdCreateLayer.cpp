@@ -0,0 +1,30 @@
+#include "CmdCreateLayer.h"
+
+#include "LayerStack.h"
+#include "VariableCache.h"
+
+bool CmdCreateLayer::Execute(const std::vector<std::string>& params)
+{
+	// Need at least 1 param for name
+	if (params.size() < 1)
+		return false;
+
+	const float opacity = params.size() > 1 ? VariableCache::Get()->GetFloat(params[1]) : 1.0f;
+
+	BlendMode blendMode = BlendMode::Over;
+	if (params.size() > 2)
+	{
+		if (params[2] == "over")
+			blendMode = BlendMode::Over;
+		else if (params[2] == "add")
+			blendMode = BlendMode::Add;
+		else if (params[2] == "multiply")
+			blendMode = BlendMode::Multiply;
+		else if (params[2] == "screen")
+			blendMode = BlendMode::Screen;
+		else
+			return false;
+	}
+
+	return LayerStack::Get()->CreateLayer(params[0], opacity, blendMode);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdCreateLayer : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "CreateLayer";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"CreateLayer(name, <opacity>, <blendMode>)\n"
+			"\n"
+			"- Adds a layer above the ones created so far, composited over the frame at the end.\n"
+			"- opacity is 0 to 1, blendMode is over, add, multiply or screen. Defaults to 1 and over.\n"
+			"- Layers start transparent every frame, see SetLayer to draw into one.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
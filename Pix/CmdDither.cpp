@@ -0,0 +1,35 @@
+#include "CmdDither.h"
+
+#include "Dither.h"
+
+bool CmdDither::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for method
+	if (params.size() < 1)
+		return false;
+
+	DitherMethod method = DitherMethod::Bayer;
+	if (params[0] == "bayer")
+		method = DitherMethod::Bayer;
+	else if (params[0] == "floyd")
+		method = DitherMethod::FloydSteinberg;
+	else if (params[0] == "atkinson")
+		method = DitherMethod::Atkinson;
+	else
+		return false;
+
+	// Optional second param for colors
+	DitherColors colors = DitherColors::Rgb332;
+	if (params.size() > 1)
+	{
+		if (params[1] == "rgb332")
+			colors = DitherColors::Rgb332;
+		else if (params[1] == "palette")
+			colors = DitherColors::Palette;
+		else
+			return false;
+	}
+
+	Dither::Get()->SetDither(method, colors);
+	return true;
+}
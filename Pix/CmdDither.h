@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdDither : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "Dither";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"Dither(method, <colors>)\n"
+			"\n"
+			"- Reduces the frame to a few colors after the post effects, for this frame.\n"
+			"- bayer: ordered 8x8 pattern, every pixel on its own.\n"
+			"- floyd: Floyd-Steinberg error diffusion.\n"
+			"- atkinson: Atkinson error diffusion, diffuses 3/4 of the error for more contrast.\n"
+			"- colors is rgb332 (default), 8 bit color, or palette for the colors set\n"
+			"  with SetPaletteColor. Palette mode already matches pixels as they are drawn,\n"
+			"  dither a full color frame to the palette instead.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,20 @@
+#include "CmdDrawBezier.h"
+
+#include "PrimitivesManager.h"
+#include "VariableCache.h"
+
+bool CmdDrawBezier::Execute(const std::vector<std::string>& params)
+{
+	// Need 7 params for width and 3 control points, or 9 for 4 control points
+	if (params.size() != 7 && params.size() != 9)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const float width = vc->GetFloat(params[0]);
+
+	std::vector<Vector2> controlPoints;
+	for (size_t i = 1; i < params.size(); i += 2)
+		controlPoints.push_back(Vector2(vc->GetFloat(params[i]), vc->GetFloat(params[i + 1])));
+
+	return PrimitivesManager::Get()->DrawBezier(controlPoints, width);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdDrawBezier : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "DrawBezier";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"DrawBezier(width, x0, y0, x1, y1, x2, y2, <x3, y3>)\n"
+			"\n"
+			"- Draws a quadratic Bezier curve through 3 control points or a cubic through 4.\n"
+			"- Width is in pixels, the curve is split into lines within a quarter pixel of it.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+
+	bool IsDrawCommand() override
+	{
+		return true;
+	}
+};
@@ -0,0 +1,22 @@
+#include "CmdDrawCapsule.h"
+
+#include "Rasterizer.h"
+#include "Shapes.h"
+#include "VariableCache.h"
+
+bool CmdDrawCapsule::Execute(const std::vector<std::string>& params)
+{
+	// Need 5 params for x0, y0, x1, y1, width
+	if (params.size() < 5)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const Vector2 from(vc->GetFloat(params[0]), vc->GetFloat(params[1]));
+	const Vector2 to(vc->GetFloat(params[2]), vc->GetFloat(params[3]));
+	const float width = vc->GetFloat(params[4]);
+	if (width <= 0.0f)
+		return false;
+
+	Rasterizer::Get()->DrawShape(Shape::Capsule(from, to, width * 0.5f));
+	return true;
+}
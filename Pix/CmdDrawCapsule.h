@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdDrawCapsule : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "DrawCapsule";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"DrawCapsule(x0, y0, x1, y1, width)\n"
+			"\n"
+			"- Draws a line of the given width with round ends with the current color.\n"
+			"- Edges are anti-aliased at any size, the same points twice draw a disc.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+
+	bool IsDrawCommand() override
+	{
+		return true;
+	}
+};
@@ -0,0 +1,27 @@
+#include "CmdDrawImage.h"
+
+#include "ImageCache.h"
+#include "Rasterizer.h"
+#include "VariableCache.h"
+
+bool CmdDrawImage::Execute(const std::vector<std::string>& params)
+{
+	// Need at least 3 params for file name, x, y
+	if (params.size() < 3)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const float x = vc->GetFloat(params[1]);
+	const float y = vc->GetFloat(params[2]);
+	const float scale = params.size() > 3 ? vc->GetFloat(params[3]) : 1.0f;
+	const float rotation = params.size() > 4 ? vc->GetFloat(params[4]) : 0.0f;
+	if (scale <= 0.0f)
+		return false;
+
+	const Image* image = ImageCache::Get()->GetImage(params[0]);
+	if (image == nullptr)
+		return false;
+
+	Rasterizer::Get()->DrawImage(*image, x, y, scale, rotation);
+	return true;
+}
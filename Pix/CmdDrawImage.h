@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdDrawImage : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "DrawImage";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"DrawImage(fileName, x, y, <scale>, <rotation>)\n"
+			"\n"
+			"- Blends an image with its top left corner at (x, y) using the current blend mode.\n"
+			"- scale and rotation in degrees are about the image center, transformed images are filtered.\n"
+			"- Images are decoded once and kept while Pix runs.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+
+	bool IsDrawCommand() override
+	{
+		return true;
+	}
+};
@@ -0,0 +1,13 @@
+#include "CmdDrawMesh.h"
+
+#include "MeshCache.h"
+#include "PrimitivesManager.h"
+
+bool CmdDrawMesh::Execute(const std::vector<std::string>& /*params*/)
+{
+	const Mesh* mesh = MeshCache::Get()->GetCurrentMesh();
+	if (mesh == nullptr)
+		return false;
+
+	return PrimitivesManager::Get()->DrawMesh(*mesh);
+}
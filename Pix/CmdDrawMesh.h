@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdDrawMesh : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "DrawMesh";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"DrawMesh()\n"
+			"\n"
+			"- Draws the current mesh through the matrix stack and camera.\n"
+			"- Uses the current color, texture coordinates come from the mesh.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+
+	bool IsDrawCommand() override
+	{
+		return true;
+	}
+};
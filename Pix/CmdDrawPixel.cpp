@@ -1,5 +1,6 @@
 #include "CmdDrawPixel.h"
 
+#include "Clipper.h"
 #include "Rasterizer.h"
 
 bool CmdDrawPixel::Execute(const std::vector<std::string>& params)
@@ -11,7 +12,8 @@ bool CmdDrawPixel::Execute(const std::vector<std::string>& params)
 	int positionX = stoi(params[0]);
 	int positionY = stoi(params[1]);
 
-	// Draw the pixel
-	Rasterizer::Get()->DrawPoint(positionX, positionY);
+	// Draw the pixel if it is inside the clip rect
+	if (Clipper::Get()->ClipPoint(positionX, positionY))
+		Rasterizer::Get()->DrawPoint(positionX, positionY);
 	return true;
 }
@@ -19,4 +19,9 @@ public:
 	}
 
 	bool Execute(const std::vector<std::string>& params) override;
+
+	bool IsDrawCommand() override
+	{
+		return true;
+	}
 };
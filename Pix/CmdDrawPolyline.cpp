@@ -0,0 +1,20 @@
+#include "CmdDrawPolyline.h"
+
+#include "PrimitivesManager.h"
+#include "VariableCache.h"
+
+bool CmdDrawPolyline::Execute(const std::vector<std::string>& params)
+{
+	// Need at least 3 params for width and one point
+	if (params.size() < 3 || params.size() % 2 == 0)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const float width = vc->GetFloat(params[0]);
+
+	std::vector<Vector2> points;
+	for (size_t i = 1; i < params.size(); i += 2)
+		points.push_back(Vector2(vc->GetFloat(params[i]), vc->GetFloat(params[i + 1])));
+
+	return PrimitivesManager::Get()->DrawPolyline(points, width);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdDrawPolyline : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "DrawPolyline";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"DrawPolyline(width, x0, y0, x1, y1, ...)\n"
+			"\n"
+			"- Draws connected lines through the screen space points with the current color.\n"
+			"- Width is in pixels, joins and ends are round.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+
+	bool IsDrawCommand() override
+	{
+		return true;
+	}
+};
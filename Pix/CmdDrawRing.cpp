@@ -0,0 +1,23 @@
+#include "CmdDrawRing.h"
+
+#include "Rasterizer.h"
+#include "Shapes.h"
+#include "VariableCache.h"
+
+bool CmdDrawRing::Execute(const std::vector<std::string>& params)
+{
+	// Need 4 params for x, y, radius, width
+	if (params.size() < 4)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const float x = vc->GetFloat(params[0]);
+	const float y = vc->GetFloat(params[1]);
+	const float radius = vc->GetFloat(params[2]);
+	const float width = vc->GetFloat(params[3]);
+	if (radius < 0.0f || width <= 0.0f)
+		return false;
+
+	Rasterizer::Get()->DrawShape(Shape::Ring(Vector2(x, y), radius, width));
+	return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdDrawRing : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "DrawRing";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"DrawRing(x, y, radius, width)\n"
+			"\n"
+			"- Draws a circle of the given radius around (x, y) with the current color.\n"
+			"- width is the thickness of the ring, edges are anti-aliased at any size.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+
+	bool IsDrawCommand() override
+	{
+		return true;
+	}
+};
@@ -0,0 +1,27 @@
+#include "CmdDrawRoundedRect.h"
+
+#include "Rasterizer.h"
+#include "Shapes.h"
+#include "VariableCache.h"
+
+bool CmdDrawRoundedRect::Execute(const std::vector<std::string>& params)
+{
+	// Need at least 4 params for x, y, width, height
+	if (params.size() < 4)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const float x = vc->GetFloat(params[0]);
+	const float y = vc->GetFloat(params[1]);
+	const float width = vc->GetFloat(params[2]);
+	const float height = vc->GetFloat(params[3]);
+	const float radius = params.size() > 4 ? vc->GetFloat(params[4]) : 0.0f;
+	if (width <= 0.0f || height <= 0.0f)
+		return false;
+
+	// Pixel centers are on whole numbers, so the edges are half a pixel before the first pixel and after the last
+	const Vector2 halfSize(width * 0.5f, height * 0.5f);
+	const Vector2 center(x - 0.5f + halfSize.x, y - 0.5f + halfSize.y);
+	Rasterizer::Get()->DrawShape(Shape::RoundedRect(center, halfSize, radius));
+	return true;
+}
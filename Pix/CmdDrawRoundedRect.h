@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdDrawRoundedRect : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "DrawRoundedRect";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"DrawRoundedRect(x, y, width, height, <radius>)\n"
+			"\n"
+			"- Fills the pixels from (x, y) over width x height with the current color.\n"
+			"- radius rounds the corners, edges are anti-aliased at any size.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+
+	bool IsDrawCommand() override
+	{
+		return true;
+	}
+};
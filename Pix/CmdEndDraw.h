@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdEndDraw : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "EndDraw";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"EndDraw()\n"
+			"\n"
+			"- Clips and rasterizes all vertices added since BeginDraw.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
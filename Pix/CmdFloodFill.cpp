@@ -0,0 +1,31 @@
+#include "CmdFloodFill.h"
+
+#include "Clipper.h"
+#include "Rasterizer.h"
+#include "VariableCache.h"
+
+bool CmdFloodFill::Execute(const std::vector<std::string>& params)
+{
+	// Need at least 2 params for x, y
+	if (params.size() < 2)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const int x = static_cast<int>(vc->GetFloat(params[0]));
+	const int y = static_cast<int>(vc->GetFloat(params[1]));
+
+	// Optional third param for connectivity
+	bool eightConnected = false;
+	if (params.size() > 2)
+	{
+		if (params[2] == "8")
+			eightConnected = true;
+		else if (params[2] != "4")
+			return false;
+	}
+
+	// Fill from the pixel if it is inside the clip rect
+	if (Clipper::Get()->ClipPoint(x, y))
+		Rasterizer::Get()->FloodFill(x, y, eightConnected);
+	return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdFloodFill : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "FloodFill";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"FloodFill(x, y, <connectivity>)\n"
+			"\n"
+			"- Fills the region of pixels around (x, y) that share its color with the current color.\n"
+			"- Optional connectivity 4 or 8, default 4. The fill stays inside the clip rect.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+
+	bool IsDrawCommand() override
+	{
+		return true;
+	}
+};
@@ -0,0 +1,12 @@
+#include "CmdLoadMesh.h"
+
+#include "MeshCache.h"
+
+bool CmdLoadMesh::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for file name
+	if (params.size() < 1)
+		return false;
+
+	return MeshCache::Get()->LoadMesh(params[0]);
+}
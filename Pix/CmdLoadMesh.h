@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdLoadMesh : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "LoadMesh";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"LoadMesh(fileName)\n"
+			"\n"
+			"- Loads a Wavefront OBJ mesh and makes it the current mesh.\n"
+			"- Files are loaded once and kept for later frames.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
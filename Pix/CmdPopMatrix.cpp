@@ -0,0 +1,8 @@
+#include "CmdPopMatrix.h"
+
+#include "MatrixStack.h"
+
+bool CmdPopMatrix::Execute(const std::vector<std::string>& /*params*/)
+{
+	return MatrixStack::Get()->PopMatrix();
+}
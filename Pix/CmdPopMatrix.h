@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdPopMatrix : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "PopMatrix";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"PopMatrix()\n"
+			"\n"
+			"- Restores the transform saved by the matching PushMatrix.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,35 @@
+#include "CmdPostEffect.h"
+
+#include "PostEffects.h"
+#include "VariableCache.h"
+
+bool CmdPostEffect::Execute(const std::vector<std::string>& params)
+{
+	// Need 2 params for type and radius
+	if (params.size() < 2)
+		return false;
+
+	PostEffect effect;
+	if (params[0] == "blur")
+		effect.type = PostEffectType::Blur;
+	else if (params[0] == "box")
+		effect.type = PostEffectType::BoxBlur;
+	else if (params[0] == "sharpen")
+		effect.type = PostEffectType::Sharpen;
+	else if (params[0] == "bloom")
+		effect.type = PostEffectType::Bloom;
+	else
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	effect.radius = static_cast<int>(vc->GetFloat(params[1]));
+	if (effect.radius < 0)
+		return false;
+
+	// Optional third param for amount, fourth for threshold
+	effect.amount = params.size() > 2 ? vc->GetFloat(params[2]) : 1.0f;
+	effect.threshold = params.size() > 3 ? vc->GetFloat(params[3]) : 0.8f;
+
+	PostEffects::Get()->AddEffect(effect);
+	return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdPostEffect : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "PostEffect";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"PostEffect(type, radius, <amount>, <threshold>)\n"
+			"\n"
+			"- Adds a filter applied to the whole frame after the script, in the order added.\n"
+			"- blur: Gaussian blur. box: box blur, the same cost for any radius.\n"
+			"- sharpen: adds amount (default 1) times the detail lost by a blur of radius.\n"
+			"- bloom: blurs the color above threshold (0..1, default 0.8) and adds amount (default 1) times it.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
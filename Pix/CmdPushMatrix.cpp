@@ -0,0 +1,9 @@
+#include "CmdPushMatrix.h"
+
+#include "MatrixStack.h"
+
+bool CmdPushMatrix::Execute(const std::vector<std::string>& /*params*/)
+{
+	MatrixStack::Get()->PushMatrix();
+	return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdPushMatrix : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "PushMatrix";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"PushMatrix()\n"
+			"\n"
+			"- Saves a copy of the current transform on the matrix stack.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,15 @@
+#include "CmdRayTrace.h"
+
+#include "RayTracer.h"
+#include "VariableCache.h"
+
+bool CmdRayTrace::Execute(const std::vector<std::string>& params)
+{
+	// Optional param for thread count
+	const int threads = params.empty() ? 0 : static_cast<int>(VariableCache::Get()->GetFloat(params[0]));
+	if (threads < 0)
+		return false;
+
+	RayTracer::Get()->Render(threads);
+	return true;
+}
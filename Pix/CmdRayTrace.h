@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdRayTrace : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "RayTrace";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"RayTrace(<threads>)\n"
+			"\n"
+			"- Traces the scene added with AddSphere, AddPlane, AddTriangle and AddMesh from the camera.\n"
+			"- Rays are shaded with a fixed directional light and shadows, misses keep the frame buffer.\n"
+			"- threads limits the threads tracing tiles, 0 or none uses every core.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+
+	bool IsDrawCommand() override
+	{
+		return true;
+	}
+};
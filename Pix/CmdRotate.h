@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdRotate : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "Rotate";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"Rotate(x, y, z)\n"
+			"\n"
+			"- Rotates the following geometry around the x, y and z axes in degrees.\n"
+			"- The rotations are applied in x, y, z order.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
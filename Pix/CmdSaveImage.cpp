@@ -0,0 +1,13 @@
+#include "CmdSaveImage.h"
+
+#include "ImageWriter.h"
+
+bool CmdSaveImage::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for file name
+	if (params.size() < 1)
+		return false;
+
+	ImageWriter::Get()->RequestSave(params[0]);
+	return true;
+}
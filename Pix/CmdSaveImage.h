@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSaveImage : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SaveImage";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SaveImage(fileName)\n"
+			"\n"
+			"- Saves the presented frame as a PNG file, after the post effects and dithering.\n"
+			"- The file is written in the background, the frame does not wait for it.\n"
+			"- Runs every frame, but only writes again when the frame changed.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,21 @@
+#include "CmdScale.h"
+
+#include "MatrixStack.h"
+#include "VariableCache.h"
+
+bool CmdScale::Execute(const std::vector<std::string>& params)
+{
+	// Need at least 1 param for x
+	if (params.size() < 1)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+
+	// Missing params repeat the last one given
+	const float x = vc->GetFloat(params[0]);
+	const float y = params.size() > 1 ? vc->GetFloat(params[1]) : x;
+	const float z = params.size() > 2 ? vc->GetFloat(params[2]) : y;
+
+	MatrixStack::Get()->Scale(Vector3(x, y, z));
+	return true;
+}
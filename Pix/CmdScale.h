@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdScale : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "Scale";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"Scale(x, <y>, <z>)\n"
+			"\n"
+			"- Scales the following geometry.\n"
+			"- A single param scales all axes uniformly.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,20 @@
+#include "CmdSetAccumulation.h"
+
+#include "AccumulationBuffer.h"
+#include "VariableCache.h"
+
+bool CmdSetAccumulation::Execute(const std::vector<std::string>& params)
+{
+	// Need 2 params for samples per frame and max samples
+	if (params.size() < 2)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const int samplesPerFrame = static_cast<int>(vc->GetFloat(params[0]));
+	const int maxSamples = static_cast<int>(vc->GetFloat(params[1]));
+	if (samplesPerFrame < 0 || maxSamples < 1)
+		return false;
+
+	AccumulationBuffer::Get()->SetAccumulation(samplesPerFrame, maxSamples);
+	return true;
+}
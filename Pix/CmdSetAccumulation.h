@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetAccumulation : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetAccumulation";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetAccumulation(samplesPerFrame, maxSamples)\n"
+			"\n"
+			"- Averages jittered renders of the script over frames until maxSamples are taken.\n"
+			"- Each frame runs the script samplesPerFrame times, 0 turns accumulation off.\n"
+			"- Starts over when a variable is edited or the script is run again.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
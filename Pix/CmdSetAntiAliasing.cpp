@@ -0,0 +1,25 @@
+#include "CmdSetAntiAliasing.h"
+
+#include "Rasterizer.h"
+
+bool CmdSetAntiAliasing::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for mode
+	if (params.size() < 1)
+		return false;
+
+	AntiAliasing antiAliasing = AntiAliasing::None;
+	if (params[0] == "none")
+		antiAliasing = AntiAliasing::None;
+	else if (params[0] == "coverage4x")
+		antiAliasing = AntiAliasing::Coverage4x;
+	else if (params[0] == "coverage8x")
+		antiAliasing = AntiAliasing::Coverage8x;
+	else if (params[0] == "supersample4x")
+		antiAliasing = AntiAliasing::Supersample4x;
+	else
+		return false;
+
+	Rasterizer::Get()->SetAntiAliasing(antiAliasing);
+	return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetAntiAliasing : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetAntiAliasing";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetAntiAliasing(mode)\n"
+			"\n"
+			"- Sets how triangle edges are sampled, reset to none every frame.\n"
+			"- none, coverage4x or coverage8x shade once per pixel and store coverage samples at the edges.\n"
+			"- supersample4x shades every sample of every pixel.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,25 @@
+#include "CmdSetBlendMode.h"
+
+#include "FrameBuffer.h"
+
+bool CmdSetBlendMode::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for mode
+	if (params.size() < 1)
+		return false;
+
+	BlendMode blendMode = BlendMode::Over;
+	if (params[0] == "over")
+		blendMode = BlendMode::Over;
+	else if (params[0] == "add")
+		blendMode = BlendMode::Add;
+	else if (params[0] == "multiply")
+		blendMode = BlendMode::Multiply;
+	else if (params[0] == "screen")
+		blendMode = BlendMode::Screen;
+	else
+		return false;
+
+	FrameBuffer::Get()->SetBlendMode(blendMode);
+	return true;
+}
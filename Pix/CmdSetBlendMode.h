@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetBlendMode : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetBlendMode";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetBlendMode(mode)\n"
+			"\n"
+			"- Sets how new pixels combine with the frame buffer.\n"
+			"- over, add, multiply or screen. Colors are premultiplied by alpha.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
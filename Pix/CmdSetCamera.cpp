@@ -0,0 +1,19 @@
+#include "CmdSetCamera.h"
+
+#include "Camera.h"
+#include "VariableCache.h"
+
+bool CmdSetCamera::Execute(const std::vector<std::string>& params)
+{
+	// Need 6 params for position and target
+	if (params.size() < 6)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+
+	const Vector3 position(vc->GetFloat(params[0]), vc->GetFloat(params[1]), vc->GetFloat(params[2]));
+	const Vector3 target(vc->GetFloat(params[3]), vc->GetFloat(params[4]), vc->GetFloat(params[5]));
+
+	Camera::Get()->SetCamera(position, target);
+	return true;
+}
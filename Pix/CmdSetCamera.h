@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetCamera : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetCamera";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetCamera(x, y, z, targetX, targetY, targetZ)\n"
+			"\n"
+			"- Places the camera at (x, y, z) looking at the target point.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,13 @@
+#include "CmdSetClipping.h"
+
+#include "Viewport.h"
+
+bool CmdSetClipping::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for clip
+	if (params.size() < 1)
+		return false;
+
+	Viewport::Get()->SetClipping(params[0] == "true");
+	return true;
+}
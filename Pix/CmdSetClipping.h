@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetClipping : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetClipping";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetClipping(clip)\n"
+			"\n"
+			"- Clips drawing to the viewport (true or false).\n"
+			"- Drawing is always clipped to the screen.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -15,7 +15,8 @@ bool CmdSetColor::Execute(const std::vector<std::string>& params)
 	const float r = vc->GetFloat(params[0]);
 	const float g = vc->GetFloat(params[1]);
 	const float b = vc->GetFloat(params[2]);
+	const float a = params.size() > 3 ? vc->GetFloat(params[3]) : 1.0f;
 
-	Rasterizer::Get()->SetColor(X::Color(r, g, b, 1.0f));
+	Rasterizer::Get()->SetColor(X::Color(r, g, b, a));
 	return true;
 }
\ No newline at end of file
@@ -13,10 +13,10 @@ public:
 	const char* GetDescription() override
 	{
 		return
-			"SetColor(r, g, b)\n"
+			"SetColor(r, g, b, <a>)\n"
 			"\n"
-			"- Sets the color of the next pixel using red, green and blue\n"
-			"- Values are from 0.0 to 1.0"	;
+			"- Sets the color of the next pixel using red, green, blue and optional alpha\n"
+			"- Values are from 0.0 to 1.0, alpha defaults to 1.0"	;
 	}
 
 	bool Execute(const std::vector<std::string>& params) override;
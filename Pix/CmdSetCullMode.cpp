@@ -0,0 +1,23 @@
+#include "CmdSetCullMode.h"
+
+#include "Culler.h"
+
+bool CmdSetCullMode::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for mode
+	if (params.size() < 1)
+		return false;
+
+	CullMode cullMode = CullMode::None;
+	if (params[0] == "none")
+		cullMode = CullMode::None;
+	else if (params[0] == "back")
+		cullMode = CullMode::Back;
+	else if (params[0] == "front")
+		cullMode = CullMode::Front;
+	else
+		return false;
+
+	Culler::Get()->SetCullMode(cullMode);
+	return true;
+}
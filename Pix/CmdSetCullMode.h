@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetCullMode : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetCullMode";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetCullMode(mode)\n"
+			"\n"
+			"- Sets which triangles are skipped before rasterization.\n"
+			"- none, back or front. Front faces wind clockwise on screen.\n"
+			"- Zero area triangles are always skipped.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
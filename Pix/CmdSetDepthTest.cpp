@@ -0,0 +1,13 @@
+#include "CmdSetDepthTest.h"
+
+#include "DepthBuffer.h"
+
+bool CmdSetDepthTest::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for test
+	if (params.size() < 1)
+		return false;
+
+	DepthBuffer::Get()->SetDepthTest(params[0] == "true");
+	return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetDepthTest : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetDepthTest";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetDepthTest(test)\n"
+			"\n"
+			"- Enables depth testing (true or false).\n"
+			"- Pixels are only drawn if they are closer than the stored depth.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
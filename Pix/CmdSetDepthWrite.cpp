@@ -0,0 +1,13 @@
+#include "CmdSetDepthWrite.h"
+
+#include "DepthBuffer.h"
+
+bool CmdSetDepthWrite::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for write
+	if (params.size() < 1)
+		return false;
+
+	DepthBuffer::Get()->SetDepthWrite(params[0] == "true");
+	return true;
+}
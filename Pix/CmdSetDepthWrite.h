@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetDepthWrite : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetDepthWrite";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetDepthWrite(write)\n"
+			"\n"
+			"- Enables depth writes for pixels passing the depth test (true or false).\n"
+			"- Default is true.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
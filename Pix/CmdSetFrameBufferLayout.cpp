@@ -0,0 +1,23 @@
+#include "CmdSetFrameBufferLayout.h"
+
+#include "FrameBuffer.h"
+
+bool CmdSetFrameBufferLayout::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for layout
+	if (params.size() < 1)
+		return false;
+
+	FrameBufferLayout layout = FrameBufferLayout::Linear;
+	if (params[0] == "linear")
+		layout = FrameBufferLayout::Linear;
+	else if (params[0] == "tiled8")
+		layout = FrameBufferLayout::Tiled8;
+	else if (params[0] == "tiled16")
+		layout = FrameBufferLayout::Tiled16;
+	else
+		return false;
+
+	FrameBuffer::Get()->SetLayout(layout);
+	return true;
+}
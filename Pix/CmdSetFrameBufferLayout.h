@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetFrameBufferLayout : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetFrameBufferLayout";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetFrameBufferLayout(layout)\n"
+			"\n"
+			"- Sets how the frame buffer stores pixels: linear, tiled8 or tiled16.\n"
+			"- Tiled layouts keep small primitives in fewer cache lines.\n"
+			"- Kept across frames like the resolution.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
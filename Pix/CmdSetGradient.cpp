@@ -0,0 +1,33 @@
+#include "CmdSetGradient.h"
+
+#include "Rasterizer.h"
+#include "VariableCache.h"
+
+bool CmdSetGradient::Execute(const std::vector<std::string>& params)
+{
+	// Need 4 params for radial, x, y, radius
+	if (params.size() < 4)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const float x = vc->GetFloat(params[1]);
+	const float y = vc->GetFloat(params[2]);
+	if (params[0] == "radial")
+	{
+		const float radius = vc->GetFloat(params[3]);
+		if (radius <= 0.0f)
+			return false;
+
+		Rasterizer::Get()->SetRadialGradient(Vector2(x, y), radius);
+		return true;
+	}
+
+	// Need 5 params for linear, x0, y0, x1, y1
+	if (params[0] != "linear" || params.size() < 5)
+		return false;
+
+	const float x1 = vc->GetFloat(params[3]);
+	const float y1 = vc->GetFloat(params[4]);
+	Rasterizer::Get()->SetLinearGradient(Vector2(x, y), Vector2(x1, y1));
+	return true;
+}
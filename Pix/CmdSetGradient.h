@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetGradient : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetGradient";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetGradient(linear, x0, y0, x1, y1)\n"
+			"SetGradient(radial, x, y, radius)\n"
+			"\n"
+			"- Starts a new gradient for the gradient shade mode, in screen pixels.\n"
+			"- linear runs from the first point to the second, constant across.\n"
+			"- radial runs from the center out to the radius.\n"
+			"- Colors come from the stops added with AddGradientStop, and are clamped\n"
+			"  to the first and last stop beyond them.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,12 @@
+#include "CmdSetLayer.h"
+
+#include "LayerStack.h"
+
+bool CmdSetLayer::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for name
+	if (params.size() < 1)
+		return false;
+
+	return LayerStack::Get()->SetLayer(params[0]);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetLayer : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetLayer";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetLayer(name)\n"
+			"\n"
+			"- Draws into a layer created with CreateLayer from now on, with a clear depth buffer.\n"
+			"- A layer whose statements and variables did not change since last frame keeps its pixels\n"
+			"  and skips its draw commands, so put the layers that change most at the end of the script.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
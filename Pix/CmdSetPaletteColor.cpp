@@ -0,0 +1,24 @@
+#include "CmdSetPaletteColor.h"
+
+#include "FrameBuffer.h"
+#include "VariableCache.h"
+
+bool CmdSetPaletteColor::Execute(const std::vector<std::string>& params)
+{
+	// Need 4 params for index and color
+	if (params.size() < 4)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const int index = static_cast<int>(vc->GetFloat(params[0]));
+	if (index < 0 || index >= FrameBuffer::kMaxPaletteColors)
+		return false;
+
+	const float r = vc->GetFloat(params[1]);
+	const float g = vc->GetFloat(params[2]);
+	const float b = vc->GetFloat(params[3]);
+	const float a = params.size() > 4 ? vc->GetFloat(params[4]) : 1.0f;
+
+	FrameBuffer::Get()->SetPaletteColor(index, Blend::PackPremultiplied(X::Color(r, g, b, a)));
+	return true;
+}
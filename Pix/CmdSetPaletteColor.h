@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetPaletteColor : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetPaletteColor";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetPaletteColor(index, r, g, b, <a>)\n"
+			"\n"
+			"- Sets palette entry index (0-255) and grows the palette to include it.\n"
+			"- Entry 0 is the clear color in palette mode, the palette is reset to it every frame.\n"
+			"- Pixels already using the entry take the new color without being drawn again.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
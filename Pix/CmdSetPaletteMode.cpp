@@ -0,0 +1,13 @@
+#include "CmdSetPaletteMode.h"
+
+#include "FrameBuffer.h"
+
+bool CmdSetPaletteMode::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for enabled
+	if (params.size() < 1)
+		return false;
+
+	FrameBuffer::Get()->SetPaletteMode(params[0] == "true");
+	return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetPaletteMode : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetPaletteMode";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetPaletteMode(enabled)\n"
+			"\n"
+			"- true stores an 8 bit palette index per pixel instead of a color, false goes back to RGBA.\n"
+			"- Drawn colors become the nearest palette entry, see SetPaletteColor.\n"
+			"- Kept across frames like the resolution.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,20 @@
+#include "CmdSetProjection.h"
+
+#include "Camera.h"
+#include "VariableCache.h"
+
+bool CmdSetProjection::Execute(const std::vector<std::string>& params)
+{
+	// Need 3 params for fov, near, far
+	if (params.size() < 3)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+
+	const float fov = vc->GetFloat(params[0]);
+	const float nearPlane = vc->GetFloat(params[1]);
+	const float farPlane = vc->GetFloat(params[2]);
+
+	Camera::Get()->SetProjection(fov, nearPlane, farPlane);
+	return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetProjection : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetProjection";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetProjection(fov, near, far)\n"
+			"\n"
+			"- Sets the vertical field of view in degrees and the near and far plane distances.\n"
+			"- The aspect ratio follows the viewport.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
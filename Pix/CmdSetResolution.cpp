@@ -1,5 +1,7 @@
 #include "CmdSetResolution.h"
 
+#include "Graphics.h"
+
 #include <XEngine.h>
 
 float gResolutionX = 0.0f;
@@ -25,6 +27,7 @@ bool CmdSetResolution::Execute(const std::vector<std::string>& params)
 	gResolutionY = (float)height;
 
 	X::InitRenderTexture(width, height, pixelSize);
+	Graphics::SetResolution(width, height);
 
 	if (showGrid && pixelSize > 1)
 		X::DrawScreenGrid(pixelSize, X::Colors::DarkGray);
@@ -0,0 +1,27 @@
+#include "CmdSetShadeMode.h"
+
+#include "Rasterizer.h"
+
+bool CmdSetShadeMode::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for mode
+	if (params.size() < 1)
+		return false;
+
+	ShadeMode shadeMode = ShadeMode::Flat;
+	if (params[0] == "flat")
+		shadeMode = ShadeMode::Flat;
+	else if (params[0] == "gouraud")
+		shadeMode = ShadeMode::Gouraud;
+	else if (params[0] == "texcoord")
+		shadeMode = ShadeMode::TexCoord;
+	else if (params[0] == "texture")
+		shadeMode = ShadeMode::Texture;
+	else if (params[0] == "gradient")
+		shadeMode = ShadeMode::Gradient;
+	else
+		return false;
+
+	Rasterizer::Get()->SetShadeMode(shadeMode);
+	return true;
+}
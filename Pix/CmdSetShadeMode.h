@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetShadeMode : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetShadeMode";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetShadeMode(mode)\n"
+			"\n"
+			"- Sets how triangles and lines are shaded.\n"
+			"- flat uses the first vertex color.\n"
+			"- gouraud interpolates vertex colors with perspective correction.\n"
+			"- texcoord shows the interpolated texture coordinates as red and green.\n"
+			"- texture samples the current texture, modulated by the vertex colors.\n"
+			"- gradient fills triangles and shapes with the gradient from SetGradient.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
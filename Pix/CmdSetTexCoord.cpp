@@ -0,0 +1,18 @@
+#include "CmdSetTexCoord.h"
+
+#include "PrimitivesManager.h"
+#include "VariableCache.h"
+
+bool CmdSetTexCoord::Execute(const std::vector<std::string>& params)
+{
+	// Need 2 params for u, v
+	if (params.size() < 2)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const float u = vc->GetFloat(params[0]);
+	const float v = vc->GetFloat(params[1]);
+
+	PrimitivesManager::Get()->SetTexCoord(Vector2(u, v));
+	return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetTexCoord : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetTexCoord";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetTexCoord(u, v)\n"
+			"\n"
+			"- Sets the texture coordinate for the following vertices.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,27 @@
+#include "CmdSetTexture.h"
+
+#include "Rasterizer.h"
+#include "TextureCache.h"
+
+bool CmdSetTexture::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for file name
+	if (params.size() < 1)
+		return false;
+
+	// Optional second param for layout
+	TextureLayout layout = TextureLayout::Morton;
+	if (params.size() > 1)
+	{
+		if (params[1] == "linear")
+			layout = TextureLayout::Linear;
+		else if (params[1] == "morton")
+			layout = TextureLayout::Morton;
+		else
+			return false;
+	}
+
+	const Texture* texture = TextureCache::Get()->GetTexture(params[0], layout);
+	Rasterizer::Get()->SetTexture(texture);
+	return texture != nullptr;
+}
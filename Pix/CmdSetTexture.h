@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetTexture : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetTexture";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetTexture(fileName, <layout>)\n"
+			"\n"
+			"- Sets the image sampled by the texture shade mode.\n"
+			"- Optional layout stores texels as linear rows or in morton order (default).";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetTextureFilter : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetTextureFilter";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetTextureFilter(filter)\n"
+			"\n"
+			"- Sets texture filtering to nearest, bilinear or trilinear.\n"
+			"- Nearest and bilinear read the closest mip level, trilinear blends two.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
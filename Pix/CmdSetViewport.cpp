@@ -0,0 +1,21 @@
+#include "CmdSetViewport.h"
+
+#include "VariableCache.h"
+#include "Viewport.h"
+
+bool CmdSetViewport::Execute(const std::vector<std::string>& params)
+{
+	// Need 4 params for x, y, width, height
+	if (params.size() < 4)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+
+	const float x = vc->GetFloat(params[0]);
+	const float y = vc->GetFloat(params[1]);
+	const float width = vc->GetFloat(params[2]);
+	const float height = vc->GetFloat(params[3]);
+
+	Viewport::Get()->SetViewport(x, y, width, height);
+	return true;
+}
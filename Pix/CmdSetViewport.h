@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetViewport : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetViewport";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetViewport(x, y, width, height)\n"
+			"\n"
+			"- Sets the viewport rect, also used as the clip rect.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
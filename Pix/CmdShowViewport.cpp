@@ -0,0 +1,13 @@
+#include "CmdShowViewport.h"
+
+#include "Viewport.h"
+
+bool CmdShowViewport::Execute(const std::vector<std::string>& params)
+{
+	// Need 1 param for show
+	if (params.size() < 1)
+		return false;
+
+	Viewport::Get()->ShowViewport(params[0] == "true");
+	return true;
+}
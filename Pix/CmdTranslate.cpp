@@ -0,0 +1,20 @@
+#include "CmdTranslate.h"
+
+#include "MatrixStack.h"
+#include "VariableCache.h"
+
+bool CmdTranslate::Execute(const std::vector<std::string>& params)
+{
+	// Need 3 params for x, y, z
+	if (params.size() < 3)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+
+	const float x = vc->GetFloat(params[0]);
+	const float y = vc->GetFloat(params[1]);
+	const float z = vc->GetFloat(params[2]);
+
+	MatrixStack::Get()->Translate(Vector3(x, y, z));
+	return true;
+}
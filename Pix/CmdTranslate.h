@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdTranslate : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "Translate";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"Translate(x, y, z)\n"
+			"\n"
+			"- Moves the following geometry by (x, y, z).";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,27 @@
+#include "CmdVertex.h"
+
+#include "PrimitivesManager.h"
+#include "Rasterizer.h"
+#include "VariableCache.h"
+
+bool CmdVertex::Execute(const std::vector<std::string>& params)
+{
+	// Need at least 2 params for x, y
+	if (params.size() < 2)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+
+	Vertex vertex;
+	vertex.pos.x = vc->GetFloat(params[0]);
+	vertex.pos.y = vc->GetFloat(params[1]);
+
+	// Optional third param for z
+	vertex.pos.z = params.size() > 2 ? vc->GetFloat(params[2]) : 0.0f;
+
+	vertex.color = Rasterizer::Get()->GetColor();
+	vertex.uv = PrimitivesManager::Get()->GetTexCoord();
+
+	PrimitivesManager::Get()->AddVertex(vertex);
+	return true;
+}
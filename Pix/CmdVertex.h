@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdVertex : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "Vertex";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"Vertex(x, y, <z>)\n"
+			"\n"
+			"- Adds a vertex using the current color.\n"
+			"- Call SetColor before each Vertex for per-vertex colors, gouraud shading blends them.\n"
+			"- Must be called between BeginDraw and EndDraw.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
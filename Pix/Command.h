@@ -12,4 +12,7 @@ public:
 	virtual const char* GetDescription() = 0;
 
 	virtual bool Execute(const std::vector<std::string>& params) = 0;
+
+	// Commands that only write pixels, skipped while the target layer keeps last frame's pixels
+	virtual bool IsDrawCommand() { return false; }
 };
@@ -1,9 +1,56 @@
 #include "CommandDictionary.h"
 
+#include "CmdAddGradientStop.h"
+#include "CmdAddMesh.h"
+#include "CmdAddPlane.h"
+#include "CmdAddSphere.h"
+#include "CmdAddTriangle.h"
+#include "CmdBeginDraw.h"
+#include "CmdCreateLayer.h"
+#include "CmdDither.h"
+#include "CmdDrawBezier.h"
+#include "CmdDrawCapsule.h"
+#include "CmdDrawImage.h"
+#include "CmdDrawMesh.h"
 #include "CmdDrawPixel.h"
+#include "CmdDrawPolyline.h"
+#include "CmdDrawRing.h"
+#include "CmdDrawRoundedRect.h"
+#include "CmdEndDraw.h"
+#include "CmdFloodFill.h"
+#include "CmdLoadMesh.h"
+#include "CmdPopMatrix.h"
+#include "CmdPostEffect.h"
+#include "CmdPushMatrix.h"
+#include "CmdRayTrace.h"
+#include "CmdRotate.h"
+#include "CmdSaveImage.h"
+#include "CmdSetAccumulation.h"
+#include "CmdSetAntiAliasing.h"
+#include "CmdScale.h"
+#include "CmdSetBlendMode.h"
+#include "CmdSetCamera.h"
+#include "CmdSetClipping.h"
+#include "CmdSetDepthTest.h"
+#include "CmdSetDepthWrite.h"
+#include "CmdSetFrameBufferLayout.h"
+#include "CmdSetGradient.h"
+#include "CmdSetLayer.h"
+#include "CmdSetPaletteColor.h"
+#include "CmdSetPaletteMode.h"
+#include "CmdSetProjection.h"
 #include "CmdSetResolution.h"
+#include "CmdSetShadeMode.h"
+#include "CmdSetTexCoord.h"
+#include "CmdSetTexture.h"
+#include "CmdSetTextureFilter.h"
+#include "CmdSetViewport.h"
+#include "CmdShowViewport.h"
+#include "CmdTranslate.h"
 #include "CmdVarFloat.h"
 #include "CmdSetColor.h"
+#include "CmdSetCullMode.h"
+#include "CmdVertex.h"
 
 CommandDictionary* CommandDictionary::Get()
 {
@@ -17,13 +64,74 @@ CommandDictionary::CommandDictionary()
 
 	// Setting commands
 	RegisterCommand<CmdSetResolution>();
+	RegisterCommand<CmdSetFrameBufferLayout>();
+	RegisterCommand<CmdSetPaletteMode>();
+	RegisterCommand<CmdSetPaletteColor>();
+	RegisterCommand<CmdSetAccumulation>();
+	RegisterCommand<CmdCreateLayer>();
+	RegisterCommand<CmdSetLayer>();
+	RegisterCommand<CmdSetViewport>();
+	RegisterCommand<CmdShowViewport>();
+	RegisterCommand<CmdSetClipping>();
+	RegisterCommand<CmdSetCullMode>();
+	RegisterCommand<CmdSetDepthTest>();
+	RegisterCommand<CmdSetDepthWrite>();
+
+	// Camera commands
+	RegisterCommand<CmdSetCamera>();
+	RegisterCommand<CmdSetProjection>();
+
+	// Transform commands
+	RegisterCommand<CmdPushMatrix>();
+	RegisterCommand<CmdPopMatrix>();
+	RegisterCommand<CmdTranslate>();
+	RegisterCommand<CmdRotate>();
+	RegisterCommand<CmdScale>();
 
 	// Variable commands
 	RegisterCommand<CmdVarFloat>();
 
 	// Rasterization commands
 	RegisterCommand<CmdDrawPixel>();
+	RegisterCommand<CmdFloodFill>();
+	RegisterCommand<CmdDrawImage>();
 	RegisterCommand<CmdSetColor>();
+	RegisterCommand<CmdSetBlendMode>();
+	RegisterCommand<CmdSetAntiAliasing>();
+	RegisterCommand<CmdSetShadeMode>();
+	RegisterCommand<CmdSetTexture>();
+	RegisterCommand<CmdSetTextureFilter>();
+	RegisterCommand<CmdSetGradient>();
+	RegisterCommand<CmdAddGradientStop>();
+
+	// Post effect commands
+	RegisterCommand<CmdPostEffect>();
+	RegisterCommand<CmdDither>();
+
+	// Primitive commands
+	RegisterCommand<CmdBeginDraw>();
+	RegisterCommand<CmdSetTexCoord>();
+	RegisterCommand<CmdVertex>();
+	RegisterCommand<CmdEndDraw>();
+	RegisterCommand<CmdDrawPolyline>();
+	RegisterCommand<CmdDrawBezier>();
+	RegisterCommand<CmdDrawRoundedRect>();
+	RegisterCommand<CmdDrawRing>();
+	RegisterCommand<CmdDrawCapsule>();
+
+	// Mesh commands
+	RegisterCommand<CmdLoadMesh>();
+	RegisterCommand<CmdDrawMesh>();
+
+	// Ray tracing commands
+	RegisterCommand<CmdAddSphere>();
+	RegisterCommand<CmdAddPlane>();
+	RegisterCommand<CmdAddTriangle>();
+	RegisterCommand<CmdAddMesh>();
+	RegisterCommand<CmdRayTrace>();
+
+	// Export commands
+	RegisterCommand<CmdSaveImage>();
 }
 
 TextEditor::LanguageDefinition CommandDictionary::GenerateLanguageDefinition()
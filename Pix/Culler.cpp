@@ -0,0 +1,125 @@
+#include "Culler.h"
+
+#include "MathHelper.h"
+#include "Plane.h"
+#include "Simd.h"
+
+namespace
+{
+	Plane NormalizePlane(float a, float b, float c, float d)
+	{
+		const float length = MathHelper::Magnitude(Vector3(a, b, c));
+		return length > 0.0f ? Plane(a / length, b / length, c / length, d / length) : Plane(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+Culler* Culler::Get()
+{
+	static Culler sInstance;
+	return &sInstance;
+}
+
+void Culler::OnNewFrame()
+{
+	mStats = Stats();
+	mCullMode = CullMode::None;
+}
+
+bool Culler::IsSphereVisible(const Sphere& sphere, const Matrix4& clipTransform, uint32_t triangleCount)
+{
+	// Frustum planes read from the columns of the transform land in model space
+	const Matrix4& m = clipTransform;
+	const Plane planes[] =
+	{
+		NormalizePlane(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41), // Left
+		NormalizePlane(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41), // Right
+		NormalizePlane(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42), // Bottom
+		NormalizePlane(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42), // Top
+		NormalizePlane(m._13, m._23, m._33, m._43), // Near
+		NormalizePlane(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43) // Far
+	};
+
+	for (const Plane& plane : planes)
+	{
+		if (MathHelper::Dot(plane.n, sphere.center) + plane.d < -sphere.radius)
+		{
+			mStats.trianglesSubmitted += triangleCount;
+			mStats.trianglesFrustumCulled += triangleCount;
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t Culler::CullTriangles(const VertexBatch& batch, const uint32_t* indices, size_t triangleCount, std::vector<uint8_t>& visible)
+{
+	visible.resize(triangleCount);
+
+	// Gather into SoA so the determinants of four triangles are computed together.
+	// The index list may repeat vertices, so the gather cannot be skipped.
+	float x[3][4];
+	float y[3][4];
+	float w[3][4];
+	size_t kept = 0;
+	uint32_t backFacing = 0;
+	uint32_t degenerate = 0;
+	for (size_t t = 0; t < triangleCount; t += 4)
+	{
+		const size_t lanes = triangleCount - t < 4 ? triangleCount - t : 4;
+		for (size_t lane = 0; lane < 4; ++lane)
+		{
+			// Unused lanes repeat the last triangle and are ignored below
+			const uint32_t* triangle = indices + (t + (lane < lanes ? lane : lanes - 1)) * 3;
+			for (size_t k = 0; k < 3; ++k)
+			{
+				x[k][lane] = batch.x[triangle[k]];
+				y[k][lane] = batch.y[triangle[k]];
+				w[k][lane] = batch.w[triangle[k]];
+			}
+		}
+
+		// Facing comes from the determinant of the homogeneous (x, y, w) rows. It matches the sign of
+		// the screen area for vertices in front of the eye and stays correct for vertices behind it.
+		float determinant[4];
+#if PIX_SSE
+		const __m128 x0 = _mm_loadu_ps(x[0]), x1 = _mm_loadu_ps(x[1]), x2 = _mm_loadu_ps(x[2]);
+		const __m128 y0 = _mm_loadu_ps(y[0]), y1 = _mm_loadu_ps(y[1]), y2 = _mm_loadu_ps(y[2]);
+		const __m128 w0 = _mm_loadu_ps(w[0]), w1 = _mm_loadu_ps(w[1]), w2 = _mm_loadu_ps(w[2]);
+		const __m128 a = _mm_mul_ps(x0, _mm_sub_ps(_mm_mul_ps(y1, w2), _mm_mul_ps(w1, y2)));
+		const __m128 b = _mm_mul_ps(y0, _mm_sub_ps(_mm_mul_ps(x1, w2), _mm_mul_ps(w1, x2)));
+		const __m128 c = _mm_mul_ps(w0, _mm_sub_ps(_mm_mul_ps(x1, y2), _mm_mul_ps(y1, x2)));
+		_mm_storeu_ps(determinant, _mm_add_ps(_mm_sub_ps(a, b), c));
+#else
+		for (size_t lane = 0; lane < 4; ++lane)
+		{
+			determinant[lane] = x[0][lane] * (y[1][lane] * w[2][lane] - w[1][lane] * y[2][lane])
+				- y[0][lane] * (x[1][lane] * w[2][lane] - w[1][lane] * x[2][lane])
+				+ w[0][lane] * (x[1][lane] * y[2][lane] - y[1][lane] * x[2][lane]);
+		}
+#endif
+
+		// Front faces are clockwise on screen, which is a positive determinant
+		for (size_t lane = 0; lane < lanes; ++lane)
+		{
+			bool keep = true;
+			if (determinant[lane] == 0.0f)
+			{
+				keep = false;
+				++degenerate;
+			}
+			else if ((mCullMode == CullMode::Back && determinant[lane] < 0.0f) ||
+				(mCullMode == CullMode::Front && determinant[lane] > 0.0f))
+			{
+				keep = false;
+				++backFacing;
+			}
+			visible[t + lane] = keep ? 1 : 0;
+			kept += keep ? 1 : 0;
+		}
+	}
+
+	mStats.trianglesSubmitted += static_cast<uint32_t>(triangleCount);
+	mStats.trianglesBackFaceCulled += backFacing;
+	mStats.trianglesDegenerate += degenerate;
+	return kept;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Matrix4.h"
+#include "Sphere.h"
+#include "VertexBatch.h"
+
+#include <cstdint>
+#include <vector>
+
+enum class CullMode
+{
+	None,
+	Back,
+	Front
+};
+
+class Culler
+{
+public:
+	struct Stats
+	{
+		uint32_t trianglesSubmitted = 0;
+		uint32_t trianglesFrustumCulled = 0;
+		uint32_t trianglesBackFaceCulled = 0;
+		uint32_t trianglesDegenerate = 0;
+	};
+
+	static Culler* Get();
+
+public:
+	void OnNewFrame();
+
+	void SetCullMode(CullMode cullMode) { mCullMode = cullMode; }
+	CullMode GetCullMode() const { return mCullMode; }
+
+	// Object level test of a model space sphere against the frustum of the model to clip transform.
+	// Culled objects count all their triangles as submitted and frustum culled.
+	bool IsSphereVisible(const Sphere& sphere, const Matrix4& clipTransform, uint32_t triangleCount);
+
+	// Tests the homogeneous triangles given by the index list against the cull mode, four at a time.
+	// Fills visible with one entry per triangle and returns the number of triangles kept.
+	size_t CullTriangles(const VertexBatch& batch, const uint32_t* indices, size_t triangleCount, std::vector<uint8_t>& visible);
+
+	const Stats& GetStats() const { return mStats; }
+
+private:
+	Stats mStats;
+	CullMode mCullMode = CullMode::None;
+};
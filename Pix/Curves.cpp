@@ -0,0 +1,235 @@
+#include "Curves.h"
+
+#include "MathHelper.h"
+
+#include <XEngine.h>
+
+namespace
+{
+	struct Cubic
+	{
+		Vector2 p0, p1, p2, p3;
+	};
+
+	// Bounds the distance between the curve and its chord, from Roger Willcocks' flatness test
+	bool IsFlat(const Cubic& c, float tolerance)
+	{
+		const Vector2 u = c.p1 * 3.0f - c.p0 * 2.0f - c.p3;
+		const Vector2 v = c.p2 * 3.0f - c.p3 * 2.0f - c.p0;
+		const float ux = u.x * u.x;
+		const float uy = u.y * u.y;
+		const float vx = v.x * v.x;
+		const float vy = v.y * v.y;
+		return X::Math::Max(ux, vx) + X::Math::Max(uy, vy) <= 16.0f * tolerance * tolerance;
+	}
+
+	// De Casteljau split at t = 0.5
+	void Split(const Cubic& c, Cubic& first, Cubic& second)
+	{
+		const Vector2 p01 = (c.p0 + c.p1) * 0.5f;
+		const Vector2 p12 = (c.p1 + c.p2) * 0.5f;
+		const Vector2 p23 = (c.p2 + c.p3) * 0.5f;
+		const Vector2 p012 = (p01 + p12) * 0.5f;
+		const Vector2 p123 = (p12 + p23) * 0.5f;
+		const Vector2 mid = (p012 + p123) * 0.5f;
+		first = { c.p0, p01, p012, mid };
+		second = { mid, p123, p23, c.p3 };
+	}
+
+	bool IsSamePoint(const Vector2& a, const Vector2& b)
+	{
+		return a.x == b.x && a.y == b.y;
+	}
+
+	Vector2 Normal(const Vector2& direction)
+	{
+		return Vector2(-direction.y, direction.x);
+	}
+
+	void AddTriangle(std::vector<Vector2>& triangles, const Vector2& a, const Vector2& b, const Vector2& c)
+	{
+		triangles.push_back(a);
+		triangles.push_back(b);
+		triangles.push_back(c);
+	}
+
+	// Fan from center over the arc of radius around pivot, from 'from' to 'to' the short way round
+	void AddArc(std::vector<Vector2>& triangles, const Vector2& center, const Vector2& pivot, const Vector2& from, const Vector2& to, float radius, float tolerance)
+	{
+		const Vector2 a = from - pivot;
+		const Vector2 b = to - pivot;
+		const float angle = std::atan2(a.x * b.y - a.y * b.x, MathHelper::Dot(a, b));
+
+		// Each chord stays within tolerance of the arc
+		const float maxStep = tolerance < radius ? 2.0f * std::acos(1.0f - tolerance / radius) : X::Math::kPi;
+		const int steps = X::Math::Max(1, static_cast<int>(std::ceil(std::abs(angle) / maxStep)));
+		const float step = angle / steps;
+		const float cosStep = std::cos(step);
+		const float sinStep = std::sin(step);
+
+		Vector2 previous = from;
+		Vector2 offset = a;
+		for (int i = 1; i < steps; ++i)
+		{
+			offset = Vector2(offset.x * cosStep - offset.y * sinStep, offset.x * sinStep + offset.y * cosStep);
+			const Vector2 next = pivot + offset;
+			AddTriangle(triangles, center, previous, next);
+			previous = next;
+		}
+		AddTriangle(triangles, center, previous, to);
+	}
+}
+
+void Curves::FlattenQuadratic(const Vector2& p0, const Vector2& p1, const Vector2& p2, float tolerance, std::vector<Vector2>& points)
+{
+	// Degree elevation gives the same curve as a cubic
+	FlattenCubic(p0, p0 + (p1 - p0) * (2.0f / 3.0f), p2 + (p1 - p2) * (2.0f / 3.0f), p2, tolerance, points);
+}
+
+void Curves::FlattenCubic(const Vector2& p0, const Vector2& p1, const Vector2& p2, const Vector2& p3, float tolerance, std::vector<Vector2>& points)
+{
+	if (points.empty() || !IsSamePoint(points.back(), p0))
+		points.push_back(p0);
+
+	// Depth first on an explicit stack, so pieces come out in order. Each split shrinks the
+	// flatness bound by 4, the depth limit only guards against non finite input.
+	const int kMaxDepth = 16;
+	Cubic stack[kMaxDepth + 1];
+	int depths[kMaxDepth + 1];
+	int top = 0;
+	stack[0] = { p0, p1, p2, p3 };
+	depths[0] = 0;
+	while (top >= 0)
+	{
+		const Cubic curve = stack[top];
+		const int depth = depths[top];
+		--top;
+
+		if (depth == kMaxDepth || IsFlat(curve, tolerance))
+		{
+			points.push_back(curve.p3);
+			continue;
+		}
+
+		Cubic first, second;
+		Split(curve, first, second);
+		stack[++top] = second;
+		depths[top] = depth + 1;
+		stack[++top] = first;
+		depths[top] = depth + 1;
+	}
+}
+
+void Curves::StrokePolyline(const std::vector<Vector2>& points, float width, float tolerance, std::vector<Vector2>& triangles)
+{
+	const float radius = width * 0.5f;
+	if (radius <= 0.0f || points.empty())
+		return;
+
+	// Drop repeated points, they have no direction
+	std::vector<Vector2> path;
+	path.reserve(points.size());
+	for (const Vector2& point : points)
+	{
+		if (path.empty() || !IsSamePoint(path.back(), point))
+			path.push_back(point);
+	}
+
+	// A single point is a dot
+	if (path.size() == 1)
+	{
+		const Vector2& center = path[0];
+		const Vector2 top = center + Vector2(0.0f, -radius);
+		const Vector2 bottom = center + Vector2(0.0f, radius);
+		AddArc(triangles, center, center, top, center + Vector2(radius, 0.0f), radius, tolerance);
+		AddArc(triangles, center, center, center + Vector2(radius, 0.0f), bottom, radius, tolerance);
+		AddArc(triangles, center, center, bottom, center + Vector2(-radius, 0.0f), radius, tolerance);
+		AddArc(triangles, center, center, center + Vector2(-radius, 0.0f), top, radius, tolerance);
+		return;
+	}
+
+	const size_t segmentCount = path.size() - 1;
+	std::vector<Vector2> directions(segmentCount);
+	std::vector<float> lengths(segmentCount);
+	for (size_t i = 0; i < segmentCount; ++i)
+	{
+		const Vector2 delta = path[i + 1] - path[i];
+		lengths[i] = MathHelper::Magnitude(delta);
+		directions[i] = delta / lengths[i];
+	}
+
+	// Left and right edges of the current segment at its start
+	Vector2 startLeft = path[0] + Normal(directions[0]) * radius;
+	Vector2 startRight = path[0] - Normal(directions[0]) * radius;
+
+	// Round start cap, half a disc behind the first point
+	const Vector2 back = path[0] - directions[0] * radius;
+	AddArc(triangles, path[0], path[0], startRight, back, radius, tolerance);
+	AddArc(triangles, path[0], path[0], back, startLeft, radius, tolerance);
+
+	for (size_t i = 0; i < segmentCount; ++i)
+	{
+		const Vector2& end = path[i + 1];
+		const Vector2 normal = Normal(directions[i]) * radius;
+		Vector2 endLeft = end + normal;
+		Vector2 endRight = end - normal;
+
+		if (i + 1 == segmentCount)
+		{
+			AddTriangle(triangles, startLeft, startRight, endRight);
+			AddTriangle(triangles, startLeft, endRight, endLeft);
+
+			// Round end cap
+			const Vector2 front = end + directions[i] * radius;
+			AddArc(triangles, end, end, endLeft, front, radius, tolerance);
+			AddArc(triangles, end, end, front, endRight, radius, tolerance);
+			break;
+		}
+
+		const Vector2 nextNormal = Normal(directions[i + 1]) * radius;
+		const float turn = directions[i].x * directions[i + 1].y - directions[i].y * directions[i + 1].x;
+		const float sign = turn > 0.0f ? 1.0f : -1.0f;
+
+		// The inner side of the join ends at the miter point where both inner edges meet,
+		// if that point lies within both segments
+		const Vector2 outer = normal * -sign;
+		const Vector2 nextOuter = nextNormal * -sign;
+		const float dot = MathHelper::Dot(outer, nextOuter) / (radius * radius);
+		bool mitered = false;
+		Vector2 inner = end;
+		if (dot > -0.99f)
+		{
+			inner = end - (outer + nextOuter) / (1.0f + dot);
+			const float along = std::abs(MathHelper::Dot(inner - end, directions[i]));
+			mitered = along <= lengths[i] && along <= lengths[i + 1];
+		}
+
+		Vector2 nextStartLeft = end + nextNormal;
+		Vector2 nextStartRight = end - nextNormal;
+		if (mitered)
+		{
+			if (sign > 0.0f)
+			{
+				endLeft = inner;
+				nextStartLeft = inner;
+			}
+			else
+			{
+				endRight = inner;
+				nextStartRight = inner;
+			}
+		}
+
+		AddTriangle(triangles, startLeft, startRight, endRight);
+		AddTriangle(triangles, startLeft, endRight, endLeft);
+
+		// Round join on the outer side, fanned from the inner point so it meets both quads
+		if (sign > 0.0f)
+			AddArc(triangles, mitered ? inner : end, end, endRight, nextStartRight, radius, tolerance);
+		else
+			AddArc(triangles, mitered ? inner : end, end, endLeft, nextStartLeft, radius, tolerance);
+
+		startLeft = nextStartLeft;
+		startRight = nextStartRight;
+	}
+}
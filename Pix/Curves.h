@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Vector2.h"
+
+#include <vector>
+
+// Screen space curve flattening and stroking for the 2D drawing commands
+namespace Curves
+{
+	// Largest distance in pixels between a curve and the line segments that replace it
+	constexpr float kTolerance = 0.25f;
+
+	// Append the curve as a polyline to points, including the first control point unless points already ends there.
+	// Curves are split until each piece is within tolerance, so the segment count follows the size on screen.
+	void FlattenQuadratic(const Vector2& p0, const Vector2& p1, const Vector2& p2, float tolerance, std::vector<Vector2>& points);
+	void FlattenCubic(const Vector2& p0, const Vector2& p1, const Vector2& p2, const Vector2& p3, float tolerance, std::vector<Vector2>& points);
+
+	// Append the triangles covering a polyline of the given width, three points per triangle.
+	// Segments are quads with round joins and round caps, none of the triangles overlap except
+	// at the inner side of joins between segments shorter than the width.
+	void StrokePolyline(const std::vector<Vector2>& points, float width, float tolerance, std::vector<Vector2>& triangles);
+}
@@ -0,0 +1,444 @@
+#include "Deflate.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace
+{
+	const int kWindowSize = 32768;
+	const int kMinMatch = 3;
+	const int kMaxMatch = 258;
+	const int kHashBits = 15;
+	const int kMaxChain = 32;			// Earlier positions tried for a match
+	const size_t kBlockSymbols = 32768;	// Symbols sharing one set of Huffman codes
+
+	const int kLiteralCodes = 286;
+	const int kDistanceCodes = 30;
+	const int kCodeLengthCodes = 19;
+	const int kEndOfBlock = 256;
+
+	const int kLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	const int kLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	const int kDistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	const int kDistanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	// Order the code length code lengths are written in, the rarely used ones last
+	const int kCodeLengthOrder[kCodeLengthCodes] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+	// Code of each match length, and of each distance up to 256 followed by the larger ones in steps of 128
+	struct CodeTables
+	{
+		uint8_t lengthCode[kMaxMatch + 1];
+		uint8_t distanceCode[512];
+
+		CodeTables()
+		{
+			for (int code = 0; code < 29; ++code)
+			{
+				for (int length = kLengthBase[code]; length < kLengthBase[code] + (1 << kLengthExtra[code]) && length <= kMaxMatch; ++length)
+					lengthCode[length] = static_cast<uint8_t>(code);
+			}
+			for (int code = 0; code < kDistanceCodes; ++code)
+			{
+				for (int distance = kDistanceBase[code]; distance < kDistanceBase[code] + (1 << kDistanceExtra[code]); ++distance)
+					distanceCode[distance <= 256 ? distance - 1 : 256 + ((distance - 1) >> 7)] = static_cast<uint8_t>(code);
+			}
+		}
+
+		int GetDistanceCode(int distance) const
+		{
+			return distanceCode[distance <= 256 ? distance - 1 : 256 + ((distance - 1) >> 7)];
+		}
+	};
+
+	const CodeTables kCodeTables;
+
+	// Deflate packs bits from the least significant end of each byte
+	class BitWriter
+	{
+	public:
+		explicit BitWriter(std::vector<uint8_t>& out)
+			: mOut(out)
+		{}
+
+		void Put(uint32_t bits, int count)
+		{
+			mBits |= static_cast<uint64_t>(bits) << mCount;
+			mCount += count;
+			while (mCount >= 8)
+			{
+				mOut.push_back(static_cast<uint8_t>(mBits));
+				mBits >>= 8;
+				mCount -= 8;
+			}
+		}
+
+		void AlignToByte()
+		{
+			if (mCount > 0)
+				Put(0, 8 - mCount);
+		}
+
+	private:
+		std::vector<uint8_t>& mOut;
+		uint64_t mBits = 0;
+		int mCount = 0;
+	};
+
+	// A literal byte, or a match when distance is not 0
+	struct Symbol
+	{
+		uint16_t value;
+		uint16_t distance;
+	};
+
+	// Huffman code lengths of at most maxLength bits, 0 for symbols that are not used. Trees that are too deep
+	// are built again from flatter frequencies.
+	void BuildLengths(const uint32_t* frequencies, int count, int maxLength, uint8_t* lengths)
+	{
+		std::fill(lengths, lengths + count, 0);
+		std::vector<uint32_t> weights(frequencies, frequencies + count);
+		std::vector<int> symbols;
+		for (int i = 0; i < count; ++i)
+		{
+			if (weights[i] > 0)
+				symbols.push_back(i);
+		}
+		if (symbols.empty())
+			return;
+		if (symbols.size() == 1)
+		{
+			lengths[symbols[0]] = 1;
+			return;
+		}
+
+		struct Node
+		{
+			int left;
+			int right;
+		};
+		using Entry = std::pair<uint64_t, int>;
+		std::vector<Node> nodes;
+		std::vector<int> depths;
+		while (true)
+		{
+			// Leaves first, in symbol order, so ties always merge the same way
+			nodes.clear();
+			std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+			for (int symbol : symbols)
+			{
+				heap.push({ weights[symbol], static_cast<int>(nodes.size()) });
+				nodes.push_back({ -1, -1 });
+			}
+			while (heap.size() > 1)
+			{
+				const Entry a = heap.top();
+				heap.pop();
+				const Entry b = heap.top();
+				heap.pop();
+				heap.push({ a.first + b.first, static_cast<int>(nodes.size()) });
+				nodes.push_back({ a.second, b.second });
+			}
+
+			// Children always come before their parent, so depths fill in from the root down
+			depths.assign(nodes.size(), 0);
+			int deepest = 0;
+			for (int node = static_cast<int>(nodes.size()) - 1; node >= 0; --node)
+			{
+				if (nodes[node].left < 0)
+				{
+					deepest = std::max(deepest, depths[node]);
+					continue;
+				}
+				depths[nodes[node].left] = depths[node] + 1;
+				depths[nodes[node].right] = depths[node] + 1;
+			}
+
+			if (deepest <= maxLength)
+			{
+				for (size_t leaf = 0; leaf < symbols.size(); ++leaf)
+					lengths[symbols[leaf]] = static_cast<uint8_t>(depths[leaf]);
+				return;
+			}
+
+			for (int symbol : symbols)
+				weights[symbol] = (weights[symbol] >> 1) | 1;
+		}
+	}
+
+	// Canonical codes for the lengths, bit reversed for the writer
+	void BuildCodes(const uint8_t* lengths, int count, uint16_t* codes)
+	{
+		int lengthCounts[16] = {};
+		for (int i = 0; i < count; ++i)
+			++lengthCounts[lengths[i]];
+		lengthCounts[0] = 0;
+
+		int nextCode[16] = {};
+		int code = 0;
+		for (int bits = 1; bits < 16; ++bits)
+		{
+			code = (code + lengthCounts[bits - 1]) << 1;
+			nextCode[bits] = code;
+		}
+
+		for (int i = 0; i < count; ++i)
+		{
+			if (lengths[i] == 0)
+				continue;
+
+			uint32_t value = static_cast<uint32_t>(nextCode[lengths[i]]++);
+			uint32_t reversed = 0;
+			for (int bit = 0; bit < lengths[i]; ++bit, value >>= 1)
+				reversed = (reversed << 1) | (value & 1);
+			codes[i] = static_cast<uint16_t>(reversed);
+		}
+	}
+
+	void WriteBlock(BitWriter& writer, const std::vector<Symbol>& symbols, bool last)
+	{
+		uint32_t literalFrequencies[kLiteralCodes] = {};
+		uint32_t distanceFrequencies[kDistanceCodes] = {};
+		for (const Symbol& symbol : symbols)
+		{
+			if (symbol.distance == 0)
+			{
+				++literalFrequencies[symbol.value];
+				continue;
+			}
+			++literalFrequencies[257 + kCodeTables.lengthCode[symbol.value]];
+			++distanceFrequencies[kCodeTables.GetDistanceCode(symbol.distance)];
+		}
+		++literalFrequencies[kEndOfBlock];
+
+		uint8_t literalLengths[kLiteralCodes];
+		uint8_t distanceLengths[kDistanceCodes];
+		BuildLengths(literalFrequencies, kLiteralCodes, 15, literalLengths);
+		BuildLengths(distanceFrequencies, kDistanceCodes, 15, distanceLengths);
+
+		// A block without matches still describes one distance code
+		if (std::all_of(distanceLengths, distanceLengths + kDistanceCodes, [](uint8_t length) { return length == 0; }))
+			distanceLengths[0] = 1;
+
+		int literalCount = kLiteralCodes;
+		while (literalCount > 257 && literalLengths[literalCount - 1] == 0)
+			--literalCount;
+		int distanceCount = kDistanceCodes;
+		while (distanceCount > 1 && distanceLengths[distanceCount - 1] == 0)
+			--distanceCount;
+
+		// Both code lengths sets back to back, run length coded with the repeat codes 16, 17 and 18
+		uint8_t lengths[kLiteralCodes + kDistanceCodes];
+		std::copy(literalLengths, literalLengths + literalCount, lengths);
+		std::copy(distanceLengths, distanceLengths + distanceCount, lengths + literalCount);
+		const int total = literalCount + distanceCount;
+		std::vector<std::pair<uint8_t, uint8_t>> runs;
+		uint32_t codeLengthFrequencies[kCodeLengthCodes] = {};
+		auto addRun = [&](int code, int extra)
+		{
+			runs.push_back({ static_cast<uint8_t>(code), static_cast<uint8_t>(extra) });
+			++codeLengthFrequencies[code];
+		};
+		for (int i = 0; i < total;)
+		{
+			const uint8_t length = lengths[i];
+			int run = 1;
+			while (i + run < total && lengths[i + run] == length)
+				++run;
+
+			if (length == 0 && run >= 3)
+			{
+				const int count = std::min(run, 138);
+				if (count >= 11)
+					addRun(18, count - 11);
+				else
+					addRun(17, count - 3);
+				i += count;
+			}
+			else if (length != 0 && run >= 4)
+			{
+				const int count = std::min(run - 1, 6);
+				addRun(length, 0);
+				addRun(16, count - 3);
+				i += 1 + count;
+			}
+			else
+			{
+				addRun(length, 0);
+				++i;
+			}
+		}
+
+		uint8_t codeLengthLengths[kCodeLengthCodes];
+		uint16_t codeLengthCodes[kCodeLengthCodes] = {};
+		BuildLengths(codeLengthFrequencies, kCodeLengthCodes, 7, codeLengthLengths);
+		BuildCodes(codeLengthLengths, kCodeLengthCodes, codeLengthCodes);
+		int codeLengthCount = kCodeLengthCodes;
+		while (codeLengthCount > 4 && codeLengthLengths[kCodeLengthOrder[codeLengthCount - 1]] == 0)
+			--codeLengthCount;
+
+		uint16_t literalCodes[kLiteralCodes] = {};
+		uint16_t distanceCodes[kDistanceCodes] = {};
+		BuildCodes(literalLengths, kLiteralCodes, literalCodes);
+		BuildCodes(distanceLengths, kDistanceCodes, distanceCodes);
+
+		// Header of a block with dynamic codes
+		writer.Put(last ? 1 : 0, 1);
+		writer.Put(2, 2);
+		writer.Put(literalCount - 257, 5);
+		writer.Put(distanceCount - 1, 5);
+		writer.Put(codeLengthCount - 4, 4);
+		for (int i = 0; i < codeLengthCount; ++i)
+			writer.Put(codeLengthLengths[kCodeLengthOrder[i]], 3);
+		for (const auto& run : runs)
+		{
+			writer.Put(codeLengthCodes[run.first], codeLengthLengths[run.first]);
+			if (run.first >= 16)
+				writer.Put(run.second, run.first == 16 ? 2 : (run.first == 17 ? 3 : 7));
+		}
+
+		for (const Symbol& symbol : symbols)
+		{
+			if (symbol.distance == 0)
+			{
+				writer.Put(literalCodes[symbol.value], literalLengths[symbol.value]);
+				continue;
+			}
+
+			const int lengthCode = kCodeTables.lengthCode[symbol.value];
+			writer.Put(literalCodes[257 + lengthCode], literalLengths[257 + lengthCode]);
+			writer.Put(symbol.value - kLengthBase[lengthCode], kLengthExtra[lengthCode]);
+			const int distanceCode = kCodeTables.GetDistanceCode(symbol.distance);
+			writer.Put(distanceCodes[distanceCode], distanceLengths[distanceCode]);
+			writer.Put(symbol.distance - kDistanceBase[distanceCode], kDistanceExtra[distanceCode]);
+		}
+		writer.Put(literalCodes[kEndOfBlock], literalLengths[kEndOfBlock]);
+	}
+}
+
+void Deflate::CompressPiece(const uint8_t* data, size_t size, bool last, std::vector<uint8_t>& out)
+{
+	BitWriter writer(out);
+	std::vector<int32_t> head(1 << kHashBits, -1);
+	std::vector<int32_t> previous(size);
+	std::vector<Symbol> symbols;
+	symbols.reserve(kBlockSymbols);
+
+	auto hash = [data](size_t i)
+	{
+		const uint32_t bytes = static_cast<uint32_t>(data[i]) << 16 | static_cast<uint32_t>(data[i + 1]) << 8 | data[i + 2];
+		return (bytes * 2654435761u) >> (32 - kHashBits);
+	};
+	auto insert = [&](size_t i)
+	{
+		if (i + kMinMatch > size)
+			return;
+		const uint32_t slot = hash(i);
+		previous[i] = head[slot];
+		head[slot] = static_cast<int32_t>(i);
+	};
+
+	// Greedy matching along hash chains, every position is inserted so later matches can start anywhere
+	size_t i = 0;
+	while (i < size)
+	{
+		int bestLength = 0;
+		int bestDistance = 0;
+		if (i + kMinMatch <= size)
+		{
+			const int maxLength = static_cast<int>(std::min<size_t>(kMaxMatch, size - i));
+			int32_t candidate = head[hash(i)];
+			for (int chain = 0; candidate >= 0 && chain < kMaxChain && i - candidate <= kWindowSize; ++chain, candidate = previous[candidate])
+			{
+				const uint8_t* match = data + candidate;
+				if (match[bestLength] != data[i + bestLength])
+					continue;
+
+				int length = 0;
+				while (length < maxLength && match[length] == data[i + length])
+					++length;
+				if (length > bestLength)
+				{
+					bestLength = length;
+					bestDistance = static_cast<int>(i - candidate);
+					if (length == maxLength)
+						break;
+				}
+			}
+		}
+
+		if (bestLength >= kMinMatch)
+		{
+			symbols.push_back({ static_cast<uint16_t>(bestLength), static_cast<uint16_t>(bestDistance) });
+			for (int k = 0; k < bestLength; ++k)
+				insert(i + k);
+			i += bestLength;
+		}
+		else
+		{
+			symbols.push_back({ data[i], 0 });
+			insert(i);
+			++i;
+		}
+
+		if (symbols.size() >= kBlockSymbols)
+		{
+			WriteBlock(writer, symbols, false);
+			symbols.clear();
+		}
+	}
+	WriteBlock(writer, symbols, last);
+
+	// An empty stored block brings the piece to a byte boundary without ending the stream
+	if (!last)
+	{
+		writer.Put(0, 3);
+		writer.AlignToByte();
+		writer.Put(0x0000, 16);
+		writer.Put(0xffff, 16);
+	}
+	writer.AlignToByte();
+}
+
+uint32_t Deflate::Adler32(const uint8_t* data, size_t size, uint32_t adler)
+{
+	// 5552 bytes is the most that can be summed before the sums need reducing
+	const uint32_t kBase = 65521;
+	uint32_t a = adler & 0xffff;
+	uint32_t b = adler >> 16;
+	while (size > 0)
+	{
+		const size_t count = std::min<size_t>(size, 5552);
+		for (size_t i = 0; i < count; ++i)
+		{
+			a += data[i];
+			b += a;
+		}
+		a %= kBase;
+		b %= kBase;
+		data += count;
+		size -= count;
+	}
+	return a | b << 16;
+}
+
+uint32_t Deflate::CombineAdler32(uint32_t first, uint32_t second, size_t secondSize)
+{
+	// The second sum counts every byte of the first piece once more per byte of the second
+	const uint32_t kBase = 65521;
+	const uint32_t remainder = static_cast<uint32_t>(secondSize % kBase);
+	uint32_t a = first & 0xffff;
+	uint32_t b = static_cast<uint32_t>((static_cast<uint64_t>(remainder) * a) % kBase);
+	a += (second & 0xffff) + kBase - 1;
+	b += (first >> 16) + (second >> 16) + kBase - remainder;
+	if (a >= kBase)
+		a -= kBase;
+	if (a >= kBase)
+		a -= kBase;
+	if (b >= kBase * 2)
+		b -= kBase * 2;
+	if (b >= kBase)
+		b -= kBase;
+	return a | b << 16;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Deflate (RFC 1951) compression of a stream split into pieces that compress on their own. Matches do not
+// reach back past the start of a piece, and every piece but the last ends on a byte boundary with an empty
+// stored block, so pieces compressed on different threads concatenate into one valid stream.
+// Blocks use dynamic Huffman codes built from their own symbols.
+namespace Deflate
+{
+	// Appends the compressed piece to out, last ends the stream
+	void CompressPiece(const uint8_t* data, size_t size, bool last, std::vector<uint8_t>& out);
+
+	// Zlib checksum, continuing from adler for a piece after the first
+	uint32_t Adler32(const uint8_t* data, size_t size, uint32_t adler = 1);
+
+	// Checksum of two pieces back to back from the checksum of each and the size of the second
+	uint32_t CombineAdler32(uint32_t first, uint32_t second, size_t secondSize);
+}
@@ -0,0 +1,124 @@
+#include "DepthBuffer.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace
+{
+	const float kFarDepth = FLT_MAX;
+}
+
+DepthBuffer* DepthBuffer::Get()
+{
+	static DepthBuffer sInstance;
+	return &sInstance;
+}
+
+void DepthBuffer::Initialize(int width, int height)
+{
+	if (width == mWidth && height == mHeight)
+		return;
+
+	mWidth = std::max(width, 0);
+	mHeight = std::max(height, 0);
+	mTilesX = (mWidth + kTileSize - 1) / kTileSize;
+	mTilesY = (mHeight + kTileSize - 1) / kTileSize;
+
+	mDepth.assign(mWidth * mHeight, kFarDepth);
+	mTileMin.assign(mTilesX * mTilesY, kFarDepth);
+	mTileMax.assign(mTilesX * mTilesY, kFarDepth);
+	mTileDirty.assign(mTilesX * mTilesY, 0);
+	mNeedClear = false;
+}
+
+void DepthBuffer::OnNewFrame()
+{
+	Clear();
+
+	mStats = {};
+	mDepthTest = false;
+	mDepthWrite = true;
+}
+
+void DepthBuffer::Clear()
+{
+	// Only clear if depth was written since the last clear
+	if (mNeedClear)
+	{
+		std::fill(mDepth.begin(), mDepth.end(), kFarDepth);
+		std::fill(mTileMin.begin(), mTileMin.end(), kFarDepth);
+		std::fill(mTileMax.begin(), mTileMax.end(), kFarDepth);
+		std::fill(mTileDirty.begin(), mTileDirty.end(), 0);
+		mNeedClear = false;
+	}
+}
+
+bool DepthBuffer::CheckDepth(int x, int y, float depth)
+{
+	++mStats.pixelsTested;
+
+	if (depth >= mDepth[x + y * mWidth])
+	{
+		++mStats.pixelsDepthCulled;
+		return false;
+	}
+
+	if (mDepthWrite)
+		WriteDepth(x, y, depth);
+	return true;
+}
+
+bool DepthBuffer::TestDepth(int x, int y, float depth)
+{
+	++mStats.pixelsTested;
+
+	if (depth >= mDepth[x + y * mWidth])
+	{
+		++mStats.pixelsDepthCulled;
+		return false;
+	}
+	return true;
+}
+
+void DepthBuffer::WriteDepth(int x, int y, float depth)
+{
+	mDepth[x + y * mWidth] = depth;
+
+	// Tile min stays exact, tile max is recomputed lazily when it is next tested
+	const int tile = (x / kTileSize) + (y / kTileSize) * mTilesX;
+	mTileMin[tile] = std::min(mTileMin[tile], depth);
+	mTileDirty[tile] = 1;
+	mNeedClear = true;
+}
+
+DepthBuffer::TileResult DepthBuffer::TestTile(int tileX, int tileY, float minDepth, float maxDepth)
+{
+	const int tile = tileX + tileY * mTilesX;
+	if (mTileDirty[tile])
+		UpdateTileMax(tile);
+
+	if (minDepth >= mTileMax[tile])
+		return TileResult::Culled;
+	if (maxDepth < mTileMin[tile])
+		return TileResult::Accepted;
+	return TileResult::Test;
+}
+
+void DepthBuffer::UpdateTileMax(int tile)
+{
+	const int startX = (tile % mTilesX) * kTileSize;
+	const int startY = (tile / mTilesX) * kTileSize;
+	const int endX = std::min(startX + kTileSize, mWidth);
+	const int endY = std::min(startY + kTileSize, mHeight);
+
+	float maxDepth = -FLT_MAX;
+	for (int y = startY; y < endY; ++y)
+	{
+		const float* row = &mDepth[y * mWidth];
+		for (int x = startX; x < endX; ++x)
+			maxDepth = std::max(maxDepth, row[x]);
+	}
+
+	mTileMax[tile] = maxDepth;
+	mTileDirty[tile] = 0;
+}
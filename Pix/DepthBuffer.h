@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class DepthBuffer
+{
+public:
+	static DepthBuffer* Get();
+
+public:
+	// Hierarchical-z tiles are kTileSize x kTileSize pixels
+	static constexpr int kTileSize = 8;
+
+	// Result of testing a depth range against a tile
+	enum class TileResult
+	{
+		Culled,		// Every pixel fails, skip the tile
+		Accepted,	// Every pixel passes, no per pixel test needed
+		Test		// Test each pixel
+	};
+
+	struct Stats
+	{
+		uint32_t pixelsTested = 0;
+		uint32_t pixelsTileCulled = 0;
+		uint32_t pixelsDepthCulled = 0;
+	};
+
+	void Initialize(int width, int height);
+	void OnNewFrame();
+
+	// Resets every pixel to the far depth, keeping the depth state and stats
+	void Clear();
+
+	void SetDepthTest(bool test) { mDepthTest = test; }
+	void SetDepthWrite(bool write) { mDepthWrite = write; }
+	bool IsDepthTest() const { return mDepthTest; }
+	bool IsDepthWrite() const { return mDepthWrite; }
+
+	// Returns true if the pixel passes, also writes the depth when writes are enabled
+	bool CheckDepth(int x, int y, float depth);
+
+	// Tests without writing, used for pixels whose depth is owned by another triangle
+	bool TestDepth(int x, int y, float depth);
+
+	// Writes without testing, used for pixels in accepted tiles
+	void WriteDepth(int x, int y, float depth);
+
+	TileResult TestTile(int tileX, int tileY, float minDepth, float maxDepth);
+
+	Stats& GetStats() { return mStats; }
+	const Stats& GetStats() const { return mStats; }
+
+private:
+	void UpdateTileMax(int tile);
+
+	std::vector<float> mDepth;
+	std::vector<float> mTileMin;
+	std::vector<float> mTileMax;
+	std::vector<uint8_t> mTileDirty;
+	Stats mStats;
+	int mWidth = 0;
+	int mHeight = 0;
+	int mTilesX = 0;
+	int mTilesY = 0;
+	bool mDepthTest = false;
+	bool mDepthWrite = true;
+	bool mNeedClear = false;
+};
@@ -0,0 +1,282 @@
+#include "Dither.h"
+
+#include "Simd.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+	// Rows per task for the ordered dither, pixels between progress updates for error diffusion
+	const int kBlockRows = 16;
+	const int kBlockPixels = 64;
+
+	// Rgb332 levels of red, green, blue and alpha, which is kept
+	const int kLevels[4] = { 8, 8, 4, 256 };
+
+	const int kBayer[8][8] =
+	{
+		{  0, 32,  8, 40,  2, 34, 10, 42 },
+		{ 48, 16, 56, 24, 50, 18, 58, 26 },
+		{ 12, 44,  4, 36, 14, 46,  6, 38 },
+		{ 60, 28, 52, 20, 62, 30, 54, 22 },
+		{  3, 35, 11, 43,  1, 33,  9, 41 },
+		{ 51, 19, 59, 27, 49, 17, 57, 25 },
+		{ 15, 47,  7, 39, 13, 45,  5, 37 },
+		{ 63, 31, 55, 23, 61, 29, 53, 21 }
+	};
+
+	int GetLookupCell(uint32_t color)
+	{
+		return static_cast<int>(((color & 0xf8) << 7) | ((color >> 6) & 0x3e0) | ((color >> 19) & 0x1f));
+	}
+
+	// Nearest Rgb332 level of each channel value
+	struct LevelTables
+	{
+		uint8_t nearest[3][256];
+
+		LevelTables()
+		{
+			for (int channel = 0; channel < 3; ++channel)
+			{
+				const int steps = kLevels[channel] - 1;
+				for (int value = 0; value < 256; ++value)
+				{
+					const int level = (value * steps + 127) / 255;
+					nearest[channel][value] = static_cast<uint8_t>((level * 255 + steps / 2) / steps);
+				}
+			}
+		}
+	};
+
+	const LevelTables kLevelTables;
+}
+
+Dither* Dither::Get()
+{
+	static Dither sInstance;
+	return &sInstance;
+}
+
+void Dither::OnNewFrame()
+{
+	mEnabled = false;
+}
+
+void Dither::SetDither(DitherMethod method, DitherColors colors)
+{
+	mMethod = method;
+	mColors = colors;
+	mEnabled = true;
+}
+
+void Dither::Apply(uint32_t* pixels, int width, int height, const uint32_t* palette, int paletteSize)
+{
+	mStats = Stats();
+	if (!mEnabled || width <= 0 || height <= 0 || (mColors == DitherColors::Palette && paletteSize <= 0))
+		return;
+
+	const auto startTime = std::chrono::high_resolution_clock::now();
+	mPalette = palette;
+	mPaletteSize = paletteSize;
+	if (mColors == DitherColors::Palette)
+		BuildLookup(palette, paletteSize);
+
+	if (mMethod == DitherMethod::Bayer)
+		ApplyOrdered(pixels, width, height);
+	else
+		ApplyDiffusion(pixels, width, height);
+
+	mStats.pixels = static_cast<uint32_t>(width * height);
+	mStats.threads = ThreadPool::Get()->GetThreadCount();
+	mStats.timeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+uint32_t Dither::GetNearest(int r, int g, int b, int a) const
+{
+	if (mColors == DitherColors::Palette)
+		return mPalette[mLookup[(r >> 3) << 10 | (g >> 3) << 5 | (b >> 3)]];
+
+	// Premultiplied colors stay within alpha
+	r = std::min(static_cast<int>(kLevelTables.nearest[0][r]), a);
+	g = std::min(static_cast<int>(kLevelTables.nearest[1][g]), a);
+	b = std::min(static_cast<int>(kLevelTables.nearest[2][b]), a);
+	return static_cast<uint32_t>(r | g << 8 | b << 16 | a << 24);
+}
+
+void Dither::BuildLookup(const uint32_t* palette, int paletteSize)
+{
+	// Scripts set the same palette every frame
+	if (!mLookup.empty() && mLookupPalette.size() == static_cast<size_t>(paletteSize) && std::equal(palette, palette + paletteSize, mLookupPalette.begin()))
+		return;
+
+	mLookupPalette.assign(palette, palette + paletteSize);
+	const int cells = 1 << kLookupBits;
+	mLookup.resize(cells * cells * cells);
+
+	// The entry nearest to the center of each cell, the first one wins a tie
+	ThreadPool::Get()->ParallelFor(cells, 1, [&](int begin, int end)
+	{
+		for (int cell = begin * cells * cells; cell < end * cells * cells; ++cell)
+		{
+			const int r = (cell >> (2 * kLookupBits)) << 3 | 4;
+			const int g = ((cell >> kLookupBits) & (cells - 1)) << 3 | 4;
+			const int b = (cell & (cells - 1)) << 3 | 4;
+			int best = 0;
+			int bestDistance = INT_MAX;
+			for (int i = 0; i < paletteSize; ++i)
+			{
+				const int dr = r - static_cast<int>(palette[i] & 0xff);
+				const int dg = g - static_cast<int>((palette[i] >> 8) & 0xff);
+				const int db = b - static_cast<int>((palette[i] >> 16) & 0xff);
+				const int distance = dr * dr + dg * dg + db * db;
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					best = i;
+				}
+			}
+			mLookup[cell] = static_cast<uint8_t>(best);
+		}
+	});
+}
+
+void Dither::ApplyOrdered(uint32_t* pixels, int width, int height)
+{
+	// Thresholds spread each channel by one step between its levels, centered on zero. A palette of n colors
+	// has about the cube root of n levels per channel.
+	const bool palette = mColors == DitherColors::Palette;
+	float spread[4];
+	alignas(16) float toLevel[4];
+	alignas(16) float fromLevel[4];
+	for (int channel = 0; channel < 4; ++channel)
+	{
+		const float steps = palette ? std::max(std::cbrt(static_cast<float>(mPaletteSize)) - 1.0f, 1.0f) : kLevels[channel] - 1.0f;
+		spread[channel] = channel < 3 ? 255.0f / steps : 0.0f;
+		toLevel[channel] = palette ? 1.0f : (kLevels[channel] - 1) / 255.0f;
+		fromLevel[channel] = palette ? 1.0f : 255.0f / (kLevels[channel] - 1);
+	}
+
+	alignas(16) float offsets[8][8][4];
+	for (int y = 0; y < 8; ++y)
+	{
+		for (int x = 0; x < 8; ++x)
+		{
+			for (int channel = 0; channel < 4; ++channel)
+				offsets[y][x][channel] = ((kBayer[y][x] + 0.5f) / 64.0f - 0.5f) * spread[channel];
+		}
+	}
+
+	ThreadPool::Get()->ParallelFor(height, kBlockRows, [&](int begin, int end)
+	{
+		for (int y = begin; y < end; ++y)
+		{
+			uint32_t* row = pixels + y * width;
+			const float (*rowOffsets)[4] = offsets[y & 7];
+			int x = 0;
+#if PIX_SSE
+			const __m128i zero = _mm_setzero_si128();
+			const __m128 low = _mm_setzero_ps();
+			const __m128 high = _mm_set1_ps(255.0f);
+			const __m128 to = _mm_load_ps(toLevel);
+			const __m128 from = _mm_load_ps(fromLevel);
+			for (; x < width; ++x)
+			{
+				const __m128i bytes = _mm_cvtsi32_si128(static_cast<int>(row[x]));
+				__m128 color = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+				color = _mm_min_ps(_mm_max_ps(_mm_add_ps(color, _mm_load_ps(rowOffsets[x & 7])), low), high);
+				color = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(color, to))), from);
+				color = _mm_min_ps(color, _mm_shuffle_ps(color, color, _MM_SHUFFLE(3, 3, 3, 3)));
+				__m128i values = _mm_cvtps_epi32(color);
+				values = _mm_packs_epi32(values, values);
+				const uint32_t result = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(values, values)));
+				row[x] = palette ? mPalette[mLookup[GetLookupCell(result)]] : result;
+			}
+#endif
+			// Same operations and rounding as the SSE2 path
+			for (; x < width; ++x)
+			{
+				float channels[4];
+				for (int channel = 0; channel < 4; ++channel)
+				{
+					const float value = static_cast<float>((row[x] >> (channel * 8)) & 0xff) + rowOffsets[x & 7][channel];
+					channels[channel] = std::nearbyint(std::min(std::max(value, 0.0f), 255.0f) * toLevel[channel]) * fromLevel[channel];
+				}
+
+				uint32_t result = 0;
+				for (int channel = 0; channel < 4; ++channel)
+					result |= static_cast<uint32_t>(std::nearbyint(std::min(channels[channel], channels[3]))) << (channel * 8);
+				row[x] = palette ? mPalette[mLookup[GetLookupCell(result)]] : result;
+			}
+		}
+	});
+}
+
+void Dither::ApplyDiffusion(uint32_t* pixels, int width, int height)
+{
+	// Error rows have two zero pixels on each side and two zero rows on top, so neighbors need no bounds checks
+	const int stride = (width + 4) * 3;
+	mErrors.assign(static_cast<size_t>(stride) * (height + 2), 0);
+	if (mProgressRows < height)
+	{
+		mProgress.reset(new std::atomic<int>[height]);
+		mProgressRows = height;
+	}
+	for (int y = 0; y < height; ++y)
+		mProgress[y].store(0, std::memory_order_relaxed);
+
+	// Rows are handed out in order and each one only waits on the row above, so the lowest unfinished row
+	// always runs. Its error weights pull what the serial scan would have pushed.
+	const bool atkinson = mMethod == DitherMethod::Atkinson;
+	ThreadPool::Get()->ParallelFor(height, 1, [&](int begin, int end)
+	{
+		for (int y = begin; y < end; ++y)
+		{
+			uint32_t* row = pixels + y * width;
+			int16_t* errors = &mErrors[static_cast<size_t>(y + 2) * stride + 6];
+			const int16_t* above = errors - stride;
+			const int16_t* aboveTwo = above - stride;
+			for (int blockStart = 0; blockStart < width; blockStart += kBlockPixels)
+			{
+				// The last pixel of the block takes error from the pixel after it on the row above
+				const int blockEnd = std::min(blockStart + kBlockPixels, width);
+				if (y > 0)
+				{
+					const int needed = std::min(blockEnd + 1, width);
+					while (mProgress[y - 1].load(std::memory_order_acquire) < needed)
+						std::this_thread::yield();
+				}
+
+				for (int x = blockStart; x < blockEnd; ++x)
+				{
+					const int i = x * 3;
+					int wanted[3];
+					for (int channel = 0; channel < 3; ++channel)
+					{
+						const int c = i + channel;
+						int error = 0;
+						if (atkinson)
+							error = (errors[c - 3] + errors[c - 6] + above[c - 3] + above[c] + above[c + 3] + aboveTwo[c] + 4) >> 3;
+						else
+							error = (7 * errors[c - 3] + above[c - 3] + 5 * above[c] + 3 * above[c + 3] + 8) >> 4;
+
+						const int value = static_cast<int>((row[x] >> (channel * 8)) & 0xff);
+						wanted[channel] = std::min(std::max(value + error, 0), 255);
+					}
+
+					const uint32_t result = GetNearest(wanted[0], wanted[1], wanted[2], static_cast<int>(row[x] >> 24));
+					for (int channel = 0; channel < 3; ++channel)
+						errors[i + channel] = static_cast<int16_t>(wanted[channel] - static_cast<int>((result >> (channel * 8)) & 0xff));
+					row[x] = result;
+				}
+
+				mProgress[y].store(blockEnd, std::memory_order_release);
+			}
+		}
+	});
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+enum class DitherMethod
+{
+	Bayer,			// Ordered 8x8 threshold matrix, every pixel on its own
+	FloydSteinberg,	// Error diffusion to 4 neighbors, 7/16 of it to the right
+	Atkinson		// Error diffusion of 6/8 of the error to 6 neighbors, brighter and with more contrast
+};
+
+enum class DitherColors
+{
+	Rgb332,		// 8 bit color, 8 levels of red and green and 4 of blue
+	Palette		// The frame buffer palette
+};
+
+// Reduces the presented image to a few colors, the last step before upload after the post effects.
+// Bayer pixels are independent and run in parallel rows, a pixel per SSE2 register.
+// Error diffusion pulls the error of each pixel from its already dithered neighbors, so a row can start as
+// soon as the row above is two pixels ahead. Rows run on the ThreadPool in a wavefront, each waiting on the
+// progress of the one above, and the result does not depend on the number of threads.
+class Dither
+{
+public:
+	static Dither* Get();
+
+public:
+	struct Stats
+	{
+		uint32_t pixels = 0;
+		float timeMs = 0.0f;
+		int threads = 0;
+	};
+
+	// Dithering lasts one frame
+	void OnNewFrame();
+
+	void SetDither(DitherMethod method, DitherColors colors);
+	bool IsEnabled() const { return mEnabled; }
+	DitherMethod GetMethod() const { return mMethod; }
+
+	// Replaces premultiplied RGBA8 pixels in linear row order with the nearest colors. Palette entries are
+	// matched on color alone, pixels take the alpha of the entry. Rgb332 keeps the alpha of the pixel.
+	void Apply(uint32_t* pixels, int width, int height, const uint32_t* palette, int paletteSize);
+
+	// Work done by the last apply
+	const Stats& GetStats() const { return mStats; }
+
+private:
+	// Cells of the palette lookup, 5 bits of red, green and blue
+	static constexpr int kLookupBits = 5;
+
+	uint32_t GetNearest(int r, int g, int b, int a) const;
+
+	void BuildLookup(const uint32_t* palette, int paletteSize);
+	void ApplyOrdered(uint32_t* pixels, int width, int height);
+	void ApplyDiffusion(uint32_t* pixels, int width, int height);
+
+	DitherMethod mMethod = DitherMethod::Bayer;
+	DitherColors mColors = DitherColors::Rgb332;
+	bool mEnabled = false;
+	const uint32_t* mPalette = nullptr;
+	int mPaletteSize = 0;
+	std::vector<uint32_t> mLookupPalette;			// Palette the lookup was built for
+	std::vector<uint8_t> mLookup;					// Nearest palette entry of each cell
+	std::vector<int16_t> mErrors;					// Red, green and blue error left at each pixel, zero padded
+	std::unique_ptr<std::atomic<int>[]> mProgress;	// Pixels done on each row
+	int mProgressRows = 0;
+	Stats mStats;
+};
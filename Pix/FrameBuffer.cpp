@@ -0,0 +1,814 @@
+#include "FrameBuffer.h"
+
+#include "AccumulationBuffer.h"
+#include "Clipper.h"
+#include "Dither.h"
+#include "ImageWriter.h"
+#include "LayerStack.h"
+#include "PostEffects.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace
+{
+	// Opaque X background color (0.1, 0.1, 0.1)
+	const uint32_t kClearColor = 0xff1a1a1a;
+
+	// Palette entries that were never set are opaque black
+	const uint32_t kUnsetPaletteColor = 0xff000000;
+
+	// Direct mapped cache of colors already matched to the palette
+	const int kPaletteCacheShift = 12;
+
+	int GetPaletteCacheSlot(uint32_t color)
+	{
+		return static_cast<int>((color * 2654435761u) >> (32 - kPaletteCacheShift));
+	}
+
+	int GetTileShift(FrameBufferLayout layout)
+	{
+		switch (layout)
+		{
+		case FrameBufferLayout::Tiled8:		return 3;
+		case FrameBufferLayout::Tiled16:	return 4;
+		default:							return 0;
+		}
+	}
+
+	// Rounded average of 4 or 8 samples
+	uint32_t AverageSamples(const uint32_t* samples, int count)
+	{
+		const int shift = count == 8 ? 3 : 2;
+#if PIX_SSE
+		// Sum in 16 bit lanes, two pixels per register, then fold the halves
+		const __m128i zero = _mm_setzero_si128();
+		__m128i sum = zero;
+		for (int i = 0; i < count; i += 4)
+		{
+			const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+			sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_unpacklo_epi8(s, zero), _mm_unpackhi_epi8(s, zero)));
+		}
+		sum = _mm_add_epi16(sum, _mm_srli_si128(sum, 8));
+		sum = _mm_add_epi16(sum, _mm_set1_epi16(static_cast<short>(count / 2)));
+		sum = _mm_srl_epi16(sum, _mm_cvtsi32_si128(shift));
+		return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(sum, zero)));
+#else
+		uint32_t result = 0;
+		for (int channel = 0; channel < 32; channel += 8)
+		{
+			uint32_t sum = count / 2;
+			for (int i = 0; i < count; ++i)
+				sum += (samples[i] >> channel) & 0xff;
+			result |= (sum >> shift) << channel;
+		}
+		return result;
+#endif
+	}
+
+	// Length of the run of pixels equal to target at the start of pixels, no more than count
+	int CountEqual(const uint32_t* pixels, int count, uint32_t target)
+	{
+		int i = 0;
+#if PIX_SSE
+		const __m128i targets = _mm_set1_epi32(static_cast<int>(target));
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i equal = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i)), targets);
+			if (_mm_movemask_epi8(equal) != 0xffff)
+				break;
+		}
+#endif
+		while (i < count && pixels[i] == target)
+			++i;
+		return i;
+	}
+
+	int CountEqual(const uint8_t* indices, int count, uint8_t target)
+	{
+		int i = 0;
+#if PIX_SSE
+		const __m128i targets = _mm_set1_epi8(static_cast<char>(target));
+		for (; i + 16 <= count; i += 16)
+		{
+			const __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i)), targets);
+			if (_mm_movemask_epi8(equal) != 0xffff)
+				break;
+		}
+#endif
+		while (i < count && indices[i] == target)
+			++i;
+		return i;
+	}
+
+	// Palette lookup of a row of indices. SSE2 has no gather, so four lookups are packed into one store.
+	void ExpandRow(uint32_t* dest, const uint8_t* indices, int count, const uint32_t* palette)
+	{
+		int i = 0;
+#if PIX_SSE
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i colors = _mm_setr_epi32(
+				static_cast<int>(palette[indices[i]]),
+				static_cast<int>(palette[indices[i + 1]]),
+				static_cast<int>(palette[indices[i + 2]]),
+				static_cast<int>(palette[indices[i + 3]]));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), colors);
+		}
+#endif
+		for (; i < count; ++i)
+			dest[i] = palette[indices[i]];
+	}
+
+	void CopyRow(uint32_t* dest, const uint32_t* source, int count)
+	{
+		int i = 0;
+#if PIX_SSE
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i)));
+#endif
+		for (; i < count; ++i)
+			dest[i] = source[i];
+	}
+}
+
+FrameBuffer* FrameBuffer::Get()
+{
+	static FrameBuffer sInstance;
+	return &sInstance;
+}
+
+FrameBuffer::FrameBuffer()
+	: mPalette(kMaxPaletteColors, kUnsetPaletteColor)
+	, mPaletteCacheColors(1 << kPaletteCacheShift, 0)
+	, mPaletteCacheIndices(1 << kPaletteCacheShift, -1)
+{
+	mPalette[0] = kClearColor;
+}
+
+void FrameBuffer::Initialize(int width, int height)
+{
+	if (width == mWidth && height == mHeight)
+		return;
+
+	mWidth = std::max(width, 0);
+	mHeight = std::max(height, 0);
+	Allocate();
+
+	mDirtyTilesX = (mWidth + kDirtyTileSize - 1) >> kDirtyTileShift;
+	mDirtyTilesY = (mHeight + kDirtyTileSize - 1) >> kDirtyTileShift;
+	mTouched.assign(mDirtyTilesX * mDirtyTilesY, 0);
+	mPresentedTouched.assign(mDirtyTilesX * mDirtyTilesY, 0);
+	mPresented.assign(mWidth * mHeight, kClearColor);
+	mFullUpload = true;
+
+	mSampleIndex.assign(mWidth * mHeight, -1);
+	mSamples.clear();
+	mSampledPixels.clear();
+}
+
+void FrameBuffer::OnNewFrame()
+{
+	if (mPaletteMode)
+		std::fill(mIndices.begin(), mIndices.end(), 0);
+	else
+		std::fill(mPixels.begin(), mPixels.end(), kClearColor);
+	mBlendMode = BlendMode::Over;
+
+	// The script sets the palette up again, entries from an earlier script would still match colors
+	if (mPaletteSize > 1 || mPalette[0] != kClearColor)
+	{
+		std::fill(mPalette.begin(), mPalette.end(), kUnsetPaletteColor);
+		mPalette[0] = kClearColor;
+		mPaletteSize = 1;
+		std::fill(mPaletteCacheIndices.begin(), mPaletteCacheIndices.end(), -1);
+	}
+
+	// Drop samples left over from a frame that was not presented
+	for (int pixel : mSampledPixels)
+		mSampleIndex[pixel] = -1;
+	mSamples.clear();
+	mSampledPixels.clear();
+	mSampleCount = 1;
+}
+
+void FrameBuffer::Present()
+{
+	mStats.pixelsResolved = static_cast<uint32_t>(mSampledPixels.size());
+	ResolveSamples();
+
+	// Layers can cover any pixel
+	if (LayerStack::Get()->Composite())
+		std::fill(mTouched.begin(), mTouched.end(), 1);
+
+	uint32_t* pixels = Resolve();
+
+	// The average can differ from this frame anywhere, so every tile is compared like for the filters below
+	AccumulationBuffer* accumulation = AccumulationBuffer::Get();
+	if (accumulation->IsEnabled())
+	{
+		accumulation->AddSample(pixels, mWidth, mHeight);
+		accumulation->Resolve(pixels);
+		std::fill(mTouched.begin(), mTouched.end(), 1);
+	}
+
+	// Filters can change any pixel, so every tile is compared with the presented image
+	PostEffects* postEffects = PostEffects::Get();
+	if (postEffects->HasEffects())
+	{
+		postEffects->Apply(pixels, mWidth, mHeight);
+		std::fill(mTouched.begin(), mTouched.end(), 1);
+	}
+
+	// Reducing the colors comes last, so the upload holds what an export of the frame would
+	Dither* dither = Dither::Get();
+	if (dither->IsEnabled())
+	{
+		dither->Apply(pixels, mWidth, mHeight, mPalette.data(), mPaletteSize);
+		std::fill(mTouched.begin(), mTouched.end(), 1);
+	}
+
+	if (mFullUpload)
+	{
+		std::copy(pixels, pixels + mWidth * mHeight, mPresented.begin());
+		mDirtyRects.assign(1, X::Math::Rect(0.0f, 0.0f, static_cast<float>(mWidth), static_cast<float>(mHeight)));
+		mFullUpload = false;
+	}
+	else
+	{
+		FindDirtyRects(pixels);
+	}
+
+	mStats.rectsUploaded = static_cast<uint32_t>(mDirtyRects.size());
+	mStats.bytesUploaded = X::UpdateRenderPixels(pixels, mWidth, mHeight, mDirtyRects.data(), mStats.rectsUploaded);
+
+	// Saves copy the frame and encode it in the background
+	ImageWriter::Get()->OnPresent(pixels, mWidth, mHeight, mStats.rectsUploaded > 0);
+
+	// Only tiles written this time can differ from the clear color next time
+	mPresentedTouched.swap(mTouched);
+	std::fill(mTouched.begin(), mTouched.end(), 0);
+}
+
+void FrameBuffer::Accumulate()
+{
+	ResolveSamples();
+	LayerStack::Get()->Composite();
+	AccumulationBuffer::Get()->AddSample(Resolve(), mWidth, mHeight);
+}
+
+void FrameBuffer::SwapTarget(std::vector<uint32_t>& pixels)
+{
+	ResolveSamples();
+
+	const size_t size = mPixels.size();
+	mPixels.swap(pixels);
+	if (mPixels.size() != size)
+		mPixels.assign(size, kClearColor);
+}
+
+void FrameBuffer::SetLayout(FrameBufferLayout layout)
+{
+	if (layout == mLayout)
+		return;
+
+	// Carry the pixels over in row order, as indices in palette mode
+	std::vector<uint32_t> linear(mWidth * mHeight);
+	for (int y = 0; y < mHeight; ++y)
+	{
+		for (int x = 0; x < mWidth; ++x)
+		{
+			const int index = GetIndex(x, y);
+			linear[x + y * mWidth] = mPaletteMode ? mIndices[index] : mPixels[index];
+		}
+	}
+
+	mLayout = layout;
+	Allocate();
+
+	for (int y = 0; y < mHeight; ++y)
+	{
+		for (int x = 0; x < mWidth; ++x)
+		{
+			const int index = GetIndex(x, y);
+			if (mPaletteMode)
+				mIndices[index] = static_cast<uint8_t>(linear[x + y * mWidth]);
+			else
+				mPixels[index] = linear[x + y * mWidth];
+		}
+	}
+}
+
+void FrameBuffer::SetPaletteMode(bool enabled)
+{
+	if (enabled == mPaletteMode)
+		return;
+
+	// The layout stays the same, so every buffer position carries over to the same position
+	ResolveSamples();
+	if (enabled)
+	{
+		std::vector<uint32_t> colors;
+		colors.swap(mPixels);
+		mPaletteMode = true;
+		Allocate();
+		for (size_t i = 0; i < colors.size(); ++i)
+			mIndices[i] = GetPaletteIndex(colors[i]);
+	}
+	else
+	{
+		std::vector<uint8_t> indices;
+		indices.swap(mIndices);
+		mPaletteMode = false;
+		Allocate();
+		for (size_t i = 0; i < indices.size(); ++i)
+			mPixels[i] = mPalette[indices[i]];
+	}
+
+	// Matching to the palette can change any pixel
+	std::fill(mTouched.begin(), mTouched.end(), 1);
+}
+
+void FrameBuffer::SetPaletteColor(int index, uint32_t color)
+{
+	XASSERT(index >= 0 && index < kMaxPaletteColors, "[FrameBuffer] Palette index %d out of range.", index);
+	if (index < mPaletteSize && mPalette[index] == color)
+		return;
+
+	// Colors matched before may have a closer entry now
+	mPalette[index] = color;
+	mPaletteSize = std::max(mPaletteSize, index + 1);
+	std::fill(mPaletteCacheIndices.begin(), mPaletteCacheIndices.end(), -1);
+
+	// Every pixel using the entry changes color
+	if (mPaletteMode)
+		std::fill(mTouched.begin(), mTouched.end(), 1);
+}
+
+void FrameBuffer::SetSampleCount(int sampleCount)
+{
+	XASSERT(sampleCount == 1 || sampleCount == 4 || sampleCount == kMaxSamples, "[FrameBuffer] Unsupported sample count %d.", sampleCount);
+	if (sampleCount == mSampleCount)
+		return;
+
+	ResolveSamples();
+	mSampleCount = sampleCount;
+}
+
+void FrameBuffer::BlendPixel(int x, int y, uint32_t color)
+{
+	if (mSampleCount > 1 && mSampleIndex[x + y * mWidth] >= 0)
+	{
+		BlendSamples(x, y, color, (1u << mSampleCount) - 1);
+		return;
+	}
+
+	const int index = GetIndex(x, y);
+	SetPixel(index, Blend::BlendPixel(mBlendMode, GetPixel(index), color));
+	mTouched[(y >> kDirtyTileShift) * mDirtyTilesX + (x >> kDirtyTileShift)] = 1;
+}
+
+void FrameBuffer::BlendSpan(int x, int y, const uint32_t* colors, int count)
+{
+	MarkTouched(x, y, count);
+
+	// Pixels holding samples blend into each sample, the runs between them take the fast path
+	if (mSampleCount > 1 && !mSampledPixels.empty())
+	{
+		const int* sampleIndex = &mSampleIndex[x + y * mWidth];
+		int start = 0;
+		for (int i = 0; i < count; ++i)
+		{
+			if (sampleIndex[i] < 0)
+				continue;
+
+			BlendRun(x + start, y, colors + start, i - start);
+			BlendSamples(x + i, y, colors[i], (1u << mSampleCount) - 1);
+			start = i + 1;
+		}
+		BlendRun(x + start, y, colors + start, count - start);
+		return;
+	}
+
+	BlendRun(x, y, colors, count);
+}
+
+void FrameBuffer::BlendSamples(int x, int y, uint32_t color, uint32_t mask)
+{
+	const uint32_t fullMask = (1u << mSampleCount) - 1;
+	if (mask == fullMask && mSampleIndex[x + y * mWidth] < 0)
+	{
+		// Fully covered pixels without samples stay a single color
+		const int index = GetIndex(x, y);
+		SetPixel(index, Blend::BlendPixel(mBlendMode, GetPixel(index), color));
+		mTouched[(y >> kDirtyTileShift) * mDirtyTilesX + (x >> kDirtyTileShift)] = 1;
+		return;
+	}
+
+	uint32_t* samples = GetSamples(x, y);
+	if (mask == fullMask)
+	{
+		uint32_t colors[kMaxSamples];
+		std::fill(colors, colors + mSampleCount, color);
+		Blend::BlendPixels(mBlendMode, samples, colors, mSampleCount);
+		return;
+	}
+
+	for (int i = 0; i < mSampleCount; ++i)
+	{
+		if (mask & (1u << i))
+			samples[i] = Blend::BlendPixel(mBlendMode, samples[i], color);
+	}
+}
+
+void FrameBuffer::BlendSamples(int x, int y, const uint32_t* colors, uint32_t mask)
+{
+	uint32_t* samples = GetSamples(x, y);
+	if (mask == (1u << mSampleCount) - 1)
+	{
+		Blend::BlendPixels(mBlendMode, samples, colors, mSampleCount);
+		return;
+	}
+
+	for (int i = 0; i < mSampleCount; ++i)
+	{
+		if (mask & (1u << i))
+			samples[i] = Blend::BlendPixel(mBlendMode, samples[i], colors[i]);
+	}
+}
+
+void FrameBuffer::BlendRun(int x, int y, const uint32_t* colors, int count)
+{
+	if (mPaletteMode)
+	{
+		while (count > 0)
+		{
+			const int segment = GetSegmentLength(x, count);
+			uint8_t* indices = &mIndices[GetIndex(x, y)];
+			for (int i = 0; i < segment;)
+			{
+				// Opaque colors drawn over replace the index, so a run of one of them is a single fill
+				const uint32_t color = colors[i];
+				const int end = i + CountEqual(colors + i, segment - i, color);
+				if (mBlendMode == BlendMode::Over && (color >> 24) == 0xff)
+				{
+					std::fill(indices + i, indices + end, GetPaletteIndex(color));
+					i = end;
+					continue;
+				}
+
+				// Otherwise the result depends on the index underneath, blend and match again when it changes
+				int lastIndex = -1;
+				uint8_t result = 0;
+				for (; i < end; ++i)
+				{
+					if (indices[i] != lastIndex)
+					{
+						lastIndex = indices[i];
+						result = GetPaletteIndex(Blend::BlendPixel(mBlendMode, mPalette[lastIndex], color));
+					}
+					indices[i] = result;
+				}
+			}
+			x += segment;
+			colors += segment;
+			count -= segment;
+		}
+		return;
+	}
+
+	if (mTileShift == 0)
+	{
+		Blend::BlendPixels(mBlendMode, &mPixels[x + y * mWidth], colors, count);
+		return;
+	}
+
+	// Pixels are only contiguous up to the end of the tile row
+	while (count > 0)
+	{
+		const int segment = GetSegmentLength(x, count);
+		Blend::BlendPixels(mBlendMode, &mPixels[GetIndex(x, y)], colors, segment);
+		x += segment;
+		colors += segment;
+		count -= segment;
+	}
+}
+
+uint32_t FrameBuffer::FloodFill(int x, int y, uint32_t color, bool eightConnected, const ClipRect& bounds)
+{
+	ResolveSamples();
+
+	ClipRect clamped;
+	clamped.minX = std::max(bounds.minX, 0);
+	clamped.minY = std::max(bounds.minY, 0);
+	clamped.maxX = std::min(bounds.maxX, mWidth - 1);
+	clamped.maxY = std::min(bounds.maxY, mHeight - 1);
+	if (x < clamped.minX || x > clamped.maxX || y < clamped.minY || y > clamped.maxY)
+		return 0;
+
+	// Filled pixels never match again, so each pixel is filled once and read a few times at most
+	const int seed = GetIndex(x, y);
+	if (mPaletteMode)
+	{
+		const uint8_t target = mIndices[seed];
+		const uint8_t fill = GetPaletteIndex(Blend::BlendPixel(mBlendMode, mPalette[target], color));
+		return fill == target ? 0 : FillRegion(mIndices, x, y, fill, eightConnected, clamped);
+	}
+
+	const uint32_t target = mPixels[seed];
+	const uint32_t fill = Blend::BlendPixel(mBlendMode, target, color);
+	return fill == target ? 0 : FillRegion(mPixels, x, y, fill, eightConnected, clamped);
+}
+
+template <typename Pixel>
+uint32_t FrameBuffer::FillRegion(std::vector<Pixel>& pixels, int x, int y, Pixel fill, bool eightConnected, const ClipRect& bounds)
+{
+	const int minX = bounds.minX;
+	const int minY = bounds.minY;
+	const int maxX = bounds.maxX;
+	const int maxY = bounds.maxY;
+	const Pixel target = pixels[GetIndex(x, y)];
+
+	uint32_t count = 0;
+	auto fillRun = [&](int left, int right, int row)
+	{
+		MarkTouched(left, row, right - left + 1);
+		for (int i = left; i <= right;)
+		{
+			const int segment = GetSegmentLength(i, right - i + 1);
+			std::fill_n(&pixels[GetIndex(i, row)], segment, fill);
+			i += segment;
+		}
+		count += right - left + 1;
+	};
+	auto findLeft = [&](int left, int row)
+	{
+		while (left > minX && pixels[GetIndex(left - 1, row)] == target)
+			--left;
+		return left;
+	};
+
+	// Seed span
+	const int seedLeft = findLeft(x, y);
+	const int seedRight = x + CountMatching(pixels, x + 1, y, maxX - x, target);
+	fillRun(seedLeft, seedRight, y);
+
+	mFillSpans.clear();
+	mFillSpans.push_back({ seedLeft, seedRight, y + 1, 1 });
+	mFillSpans.push_back({ seedLeft, seedRight, y - 1, -1 });
+
+	while (!mFillSpans.empty())
+	{
+		const FillSpan span = mFillSpans.back();
+		mFillSpans.pop_back();
+		if (span.y < minY || span.y > maxY)
+			continue;
+
+		// Diagonal neighbors reach one pixel past each end of the parent span
+		const int scanLeft = eightConnected ? std::max(span.left - 1, minX) : span.left;
+		const int scanRight = eightConnected ? std::min(span.right + 1, maxX) : span.right;
+
+		int scan = scanLeft;
+		while (scan <= scanRight)
+		{
+			if (pixels[GetIndex(scan, span.y)] != target)
+			{
+				++scan;
+				continue;
+			}
+
+			// Only a run starting at the scan start can extend past it to the left
+			const int runLeft = scan == scanLeft ? findLeft(scan, span.y) : scan;
+			const int runRight = scan + CountMatching(pixels, scan + 1, span.y, maxX - scan, target);
+			fillRun(runLeft, runRight, span.y);
+
+			// Continue away from the parent, and back toward it where the run overhangs the parent span
+			mFillSpans.push_back({ runLeft, runRight, span.y + span.dy, span.dy });
+			if (runLeft < span.left)
+				mFillSpans.push_back({ runLeft, span.left - 1, span.y - span.dy, -span.dy });
+			if (runRight > span.right)
+				mFillSpans.push_back({ span.right + 1, runRight, span.y - span.dy, -span.dy });
+
+			scan = runRight + 2;
+		}
+	}
+	return count;
+}
+
+template <typename Pixel>
+int FrameBuffer::CountMatching(const std::vector<Pixel>& pixels, int x, int y, int count, Pixel target) const
+{
+	int matching = 0;
+	while (matching < count)
+	{
+		const int segment = GetSegmentLength(x + matching, count - matching);
+		const int equal = CountEqual(&pixels[GetIndex(x + matching, y)], segment, target);
+		matching += equal;
+		if (equal < segment)
+			break;
+	}
+	return matching;
+}
+
+uint8_t FrameBuffer::GetPaletteIndex(uint32_t color)
+{
+	const int slot = GetPaletteCacheSlot(color);
+	if (mPaletteCacheIndices[slot] >= 0 && mPaletteCacheColors[slot] == color)
+		return static_cast<uint8_t>(mPaletteCacheIndices[slot]);
+
+	// Closest entry in premultiplied RGBA, the first one wins a tie
+	int best = 0;
+	int bestDistance = INT_MAX;
+	for (int i = 0; i < mPaletteSize && bestDistance > 0; ++i)
+	{
+		int distance = 0;
+		for (int shift = 0; shift < 32; shift += 8)
+		{
+			const int difference = static_cast<int>((color >> shift) & 0xff) - static_cast<int>((mPalette[i] >> shift) & 0xff);
+			distance += difference * difference;
+		}
+		if (distance < bestDistance)
+		{
+			bestDistance = distance;
+			best = i;
+		}
+	}
+
+	mPaletteCacheColors[slot] = color;
+	mPaletteCacheIndices[slot] = best;
+	return static_cast<uint8_t>(best);
+}
+
+void FrameBuffer::Allocate()
+{
+	mTileShift = GetTileShift(mLayout);
+	int size = mWidth * mHeight;
+	if (mTileShift == 0)
+	{
+		mTilesX = 0;
+		mTilesY = 0;
+	}
+	else
+	{
+		// Edge tiles are padded to the full tile size
+		const int tileSize = 1 << mTileShift;
+		mTilesX = (mWidth + tileSize - 1) >> mTileShift;
+		mTilesY = (mHeight + tileSize - 1) >> mTileShift;
+		size = (mTilesX * mTilesY) << (2 * mTileShift);
+	}
+
+	// Only the buffer of the current mode keeps its memory
+	if (mPaletteMode)
+	{
+		mIndices.assign(size, 0);
+		std::vector<uint32_t>().swap(mPixels);
+	}
+	else
+	{
+		mPixels.assign(size, kClearColor);
+		std::vector<uint8_t>().swap(mIndices);
+	}
+}
+
+uint32_t* FrameBuffer::Resolve()
+{
+	if (mTileShift == 0 && !mPaletteMode)
+		return mPixels.data();
+
+	mResolved.resize(mWidth * mHeight);
+	if (mTileShift == 0)
+	{
+		ExpandRow(mResolved.data(), mIndices.data(), mWidth * mHeight, mPalette.data());
+		return mResolved.data();
+	}
+
+	// Copy each tile row to its place in the linear image, looking up the palette on the way in palette mode
+	const int tileSize = 1 << mTileShift;
+	for (int tileY = 0; tileY < mTilesY; ++tileY)
+	{
+		const int y0 = tileY * tileSize;
+		const int rows = std::min(tileSize, mHeight - y0);
+		for (int tileX = 0; tileX < mTilesX; ++tileX)
+		{
+			const int x0 = tileX * tileSize;
+			const int columns = std::min(tileSize, mWidth - x0);
+			const int tile = (tileY * mTilesX + tileX) << (2 * mTileShift);
+			for (int row = 0; row < rows; ++row)
+			{
+				uint32_t* dest = &mResolved[x0 + (y0 + row) * mWidth];
+				const int offset = tile + (row << mTileShift);
+				if (mPaletteMode)
+					ExpandRow(dest, &mIndices[offset], columns, mPalette.data());
+				else
+					CopyRow(dest, &mPixels[offset], columns);
+			}
+		}
+	}
+	return mResolved.data();
+}
+
+void FrameBuffer::FindDirtyRects(const uint32_t* pixels)
+{
+	mDirtyRects.clear();
+	for (int tileY = 0; tileY < mDirtyTilesY; ++tileY)
+	{
+		const float top = static_cast<float>(tileY << kDirtyTileShift);
+		const float bottom = static_cast<float>(std::min((tileY + 1) << kDirtyTileShift, mHeight));
+
+		int tileX = 0;
+		while (tileX < mDirtyTilesX)
+		{
+			if (!UpdatePresentedTile(pixels, tileX, tileY))
+			{
+				++tileX;
+				continue;
+			}
+
+			// Grow a run of changed tiles along the row
+			int runEnd = tileX + 1;
+			while (runEnd < mDirtyTilesX && UpdatePresentedTile(pixels, runEnd, tileY))
+				++runEnd;
+
+			const float left = static_cast<float>(tileX << kDirtyTileShift);
+			const float right = static_cast<float>(std::min(runEnd << kDirtyTileShift, mWidth));
+			tileX = runEnd;
+
+			// Extend a rect ending on the row above when it covers the same columns
+			auto above = std::find_if(mDirtyRects.begin(), mDirtyRects.end(), [=](const X::Math::Rect& rect)
+			{
+				return rect.left == left && rect.right == right && rect.bottom == top;
+			});
+			if (above != mDirtyRects.end())
+				above->bottom = bottom;
+			else
+				mDirtyRects.emplace_back(left, top, right, bottom);
+		}
+	}
+
+	// Too many small uploads cost more than one bigger one
+	if (mDirtyRects.size() > kMaxDirtyRects)
+	{
+		X::Math::Rect bounds = mDirtyRects[0];
+		for (const X::Math::Rect& rect : mDirtyRects)
+		{
+			bounds.left = std::min(bounds.left, rect.left);
+			bounds.top = std::min(bounds.top, rect.top);
+			bounds.right = std::max(bounds.right, rect.right);
+			bounds.bottom = std::max(bounds.bottom, rect.bottom);
+		}
+		mDirtyRects.assign(1, bounds);
+	}
+}
+
+bool FrameBuffer::UpdatePresentedTile(const uint32_t* pixels, int tileX, int tileY)
+{
+	// Tiles clear in both images can not have changed
+	const int tile = tileY * mDirtyTilesX + tileX;
+	if (!mTouched[tile] && !mPresentedTouched[tile])
+		return false;
+
+	const int x0 = tileX << kDirtyTileShift;
+	const int y0 = tileY << kDirtyTileShift;
+	const int columns = std::min(kDirtyTileSize, mWidth - x0);
+	const int rows = std::min(kDirtyTileSize, mHeight - y0);
+
+	bool changed = false;
+	for (int row = 0; row < rows; ++row)
+	{
+		const int offset = x0 + (y0 + row) * mWidth;
+		if (memcmp(&pixels[offset], &mPresented[offset], columns * sizeof(uint32_t)) != 0)
+		{
+			memcpy(&mPresented[offset], &pixels[offset], columns * sizeof(uint32_t));
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+uint32_t* FrameBuffer::GetSamples(int x, int y)
+{
+	const int pixel = x + y * mWidth;
+	int& block = mSampleIndex[pixel];
+	if (block < 0)
+	{
+		block = static_cast<int>(mSampledPixels.size());
+		mSampledPixels.push_back(pixel);
+		mSamples.resize(mSampledPixels.size() * mSampleCount, GetPixel(GetIndex(x, y)));
+		mTouched[(y >> kDirtyTileShift) * mDirtyTilesX + (x >> kDirtyTileShift)] = 1;
+	}
+	return &mSamples[block * mSampleCount];
+}
+
+void FrameBuffer::ResolveSamples()
+{
+	for (size_t block = 0; block < mSampledPixels.size(); ++block)
+	{
+		const int pixel = mSampledPixels[block];
+		SetPixel(GetIndex(pixel % mWidth, pixel / mWidth), AverageSamples(&mSamples[block * mSampleCount], mSampleCount));
+		mSampleIndex[pixel] = -1;
+	}
+	mSamples.clear();
+	mSampledPixels.clear();
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "Blend.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+struct ClipRect;
+
+enum class FrameBufferLayout
+{
+	Linear,
+	Tiled8,		// 8x8 pixel tiles, one tile row is half a cache line
+	Tiled16		// 16x16 pixel tiles, one tile row is a full cache line
+};
+
+// CPU side color buffer at the logical resolution, holding premultiplied RGBA8 pixels.
+// Every pixel the rasterizer writes is blended here and the result is uploaded once per frame.
+// Tiled layouts keep small primitives in a few cache lines and are resolved to linear on present.
+// Present only uploads the regions that changed since the last present.
+// With more than one sample per pixel, only pixels drawn with partial coverage store their samples,
+// every other pixel keeps a single color. The samples are averaged on present.
+// Palette mode stores an 8 bit index per pixel instead of a color, a quarter of the memory to clear and
+// write. Blended colors are matched to the nearest palette entry and present expands the indices.
+// Layers are drawn by swapping their pixels in, see LayerStack.
+class FrameBuffer
+{
+public:
+	static FrameBuffer* Get();
+
+public:
+	// Changes are tracked in kDirtyTileSize x kDirtyTileSize pixel tiles
+	static constexpr int kDirtyTileShift = 4;
+	static constexpr int kDirtyTileSize = 1 << kDirtyTileShift;
+
+	// Beyond this many rectangles a frame uploads their bounding box instead
+	static constexpr int kMaxDirtyRects = 8;
+
+	static constexpr int kMaxSamples = 8;
+
+	static constexpr int kMaxPaletteColors = 256;
+
+	struct Stats
+	{
+		uint32_t rectsUploaded = 0;
+		uint32_t bytesUploaded = 0;
+		uint32_t pixelsResolved = 0;
+	};
+
+	FrameBuffer();
+
+	void Initialize(int width, int height);
+	void OnNewFrame();
+
+	// Composites the layers, applies the accumulation buffer, post effects and dithering and uploads the changed pixels to the
+	// render texture, call after the script has run
+	void Present();
+
+	// Adds the frame to the accumulation buffer without presenting it, for frames that take several samples
+	void Accumulate();
+
+	// Kept across frames like the resolution, pixels already drawn are carried over
+	void SetLayout(FrameBufferLayout layout);
+	FrameBufferLayout GetLayout() const { return mLayout; }
+
+	// Kept across frames like the layout, pixels already drawn are matched to the palette or expanded.
+	// Turned off when a script is compiled, so a script without SetPaletteMode never renders in palette mode.
+	void SetPaletteMode(bool enabled);
+	bool IsPaletteMode() const { return mPaletteMode; }
+
+	// Grows the palette to at least index + 1 entries, reset to entry 0 alone every frame. Entry 0 starts as
+	// the clear color, which palette mode clears to. Pixels using an entry show its new color at present
+	// without being drawn again.
+	void SetPaletteColor(int index, uint32_t color);
+	int GetPaletteSize() const { return mPaletteSize; }
+
+	void SetBlendMode(BlendMode blendMode) { mBlendMode = blendMode; }
+	BlendMode GetBlendMode() const { return mBlendMode; }
+
+	// 1, 4 or 8, reset to 1 every frame. Samples already drawn are resolved first.
+	void SetSampleCount(int sampleCount);
+	int GetSampleCount() const { return mSampleCount; }
+
+	// Colors are premultiplied, see Blend::PackPremultiplied
+	void BlendPixel(int x, int y, uint32_t color);
+	void BlendSpan(int x, int y, const uint32_t* colors, int count);
+
+	// Blends into the samples of pixel (x, y) whose bit is set in mask, one color for all or one color per sample
+	void BlendSamples(int x, int y, uint32_t color, uint32_t mask);
+	void BlendSamples(int x, int y, const uint32_t* colors, uint32_t mask);
+
+	// Fills the region of pixels connected to (x, y) that have its color, up to the bounds. Returns the pixels filled.
+	// Every pixel of the region blends to the same color, which is written directly. Samples are resolved first.
+	uint32_t FloodFill(int x, int y, uint32_t color, bool eightConnected, const ClipRect& bounds);
+
+	// Exchanges the pixels drawn so far for another buffer in the same layout, which becomes the draw target.
+	// Samples are resolved first. A buffer of another size, from before a resize, is replaced by a clear one.
+	void SwapTarget(std::vector<uint32_t>& pixels);
+	uint32_t* GetTargetPixels() { return mPixels.data(); }
+	int GetTargetSize() const { return static_cast<int>(mPixels.size()); }
+
+	int GetWidth() const { return mWidth; }
+	int GetHeight() const { return mHeight; }
+
+	// The last presented frame, linear RGBA8 after post effects and dithering
+	const uint32_t* GetPresentedPixels() const { return mPresented.data(); }
+
+	// Work done by the last present
+	const Stats& GetStats() const { return mStats; }
+
+private:
+	// Run of filled pixels on row y - dy whose neighbors on row y are still to be scanned
+	struct FillSpan
+	{
+		int left;
+		int right;
+		int y;
+		int dy;
+	};
+
+	void Allocate();
+
+	// Blends a span that holds no samples
+	void BlendRun(int x, int y, const uint32_t* colors, int count);
+
+	// Returns the samples of a pixel, copying its color to every sample the first time
+	uint32_t* GetSamples(int x, int y);
+	void ResolveSamples();
+
+	void FindDirtyRects(const uint32_t* pixels);
+
+	// Copies a dirty tile to the presented image, returns true if it changed
+	bool UpdatePresentedTile(const uint32_t* pixels, int tileX, int tileY);
+
+	void MarkTouched(int x, int y, int count)
+	{
+		uint8_t* row = &mTouched[(y >> kDirtyTileShift) * mDirtyTilesX];
+		const int last = (x + count - 1) >> kDirtyTileShift;
+		for (int tileX = x >> kDirtyTileShift; tileX <= last; ++tileX)
+			row[tileX] = 1;
+	}
+
+	// Fills the region of pixels equal to the one at (x, y) within bounds, in either pixel buffer
+	template <typename Pixel>
+	uint32_t FillRegion(std::vector<Pixel>& pixels, int x, int y, Pixel fill, bool eightConnected, const ClipRect& bounds);
+
+	// Number of pixels from (x, y) to the right that equal target, looking at no more than count
+	template <typename Pixel>
+	int CountMatching(const std::vector<Pixel>& pixels, int x, int y, int count, Pixel target) const;
+
+	// Nearest palette entry, remembered until the palette changes
+	uint8_t GetPaletteIndex(uint32_t color);
+
+	// Color at a buffer index from GetIndex, in either mode
+	uint32_t GetPixel(int index) const { return mPaletteMode ? mPalette[mIndices[index]] : mPixels[index]; }
+
+	void SetPixel(int index, uint32_t color)
+	{
+		if (mPaletteMode)
+			mIndices[index] = GetPaletteIndex(color);
+		else
+			mPixels[index] = color;
+	}
+
+	// Pixels from x up to the end of its tile row, no more than count
+	int GetSegmentLength(int x, int count) const
+	{
+		if (mTileShift == 0)
+			return count;
+
+		const int tileSize = 1 << mTileShift;
+		return std::min(count, tileSize - (x & (tileSize - 1)));
+	}
+
+	// Returns the pixels in linear row order, resolving tiles when needed
+	uint32_t* Resolve();
+
+	int GetIndex(int x, int y) const
+	{
+		if (mTileShift == 0)
+			return x + y * mWidth;
+
+		const int mask = (1 << mTileShift) - 1;
+		const int tile = (y >> mTileShift) * mTilesX + (x >> mTileShift);
+		return (((tile << mTileShift) | (y & mask)) << mTileShift) | (x & mask);
+	}
+
+	std::vector<uint32_t> mPixels;
+	std::vector<uint8_t> mIndices;			// Palette mode pixels, same layout as mPixels which is then empty
+	std::vector<uint32_t> mPalette;
+	std::vector<uint32_t> mPaletteCacheColors;
+	std::vector<int> mPaletteCacheIndices;	// -1 for an empty slot
+	std::vector<uint32_t> mResolved;
+	std::vector<uint32_t> mPresented;		// Image in the render texture
+	std::vector<uint8_t> mTouched;			// Tiles written since the last present
+	std::vector<uint8_t> mPresentedTouched;	// Tiles written before the last present, the only ones not clear
+	std::vector<X::Math::Rect> mDirtyRects;
+	std::vector<int> mSampleIndex;			// Per pixel block in mSamples, -1 for a single color
+	std::vector<uint32_t> mSamples;
+	std::vector<int> mSampledPixels;
+	std::vector<FillSpan> mFillSpans;
+	int mSampleCount = 1;
+	Stats mStats;
+	int mWidth = 0;
+	int mHeight = 0;
+	int mTileShift = 0;
+	int mTilesX = 0;
+	int mTilesY = 0;
+	int mDirtyTilesX = 0;
+	int mDirtyTilesY = 0;
+	int mPaletteSize = 1;
+	bool mPaletteMode = false;
+	bool mFullUpload = true;
+	FrameBufferLayout mLayout = FrameBufferLayout::Linear;
+	BlendMode mBlendMode = BlendMode::Over;
+};
@@ -0,0 +1,157 @@
+#include "Gradient.h"
+
+#include "Blend.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Fixed point table positions have 16 fraction bits
+	const float kFixedOne = 65536.0f;
+}
+
+void Gradient::SetLinear(const Vector2& from, const Vector2& to)
+{
+	// The ramp at p is dot(p - from, to - from) / |to - from|^2
+	const Vector2 direction = to - from;
+	const float lengthSquared = direction.x * direction.x + direction.y * direction.y;
+	mType = Type::Linear;
+	mOrigin = from;
+	mSlope = lengthSquared > 0.0f ? direction / lengthSquared : Vector2();
+}
+
+void Gradient::SetRadial(const Vector2& center, float radius)
+{
+	mType = Type::Radial;
+	mOrigin = center;
+	mInverseRadius = radius > 0.0f ? 1.0f / radius : 0.0f;
+}
+
+void Gradient::AddStop(float offset, uint32_t color)
+{
+	const Stop stop = { std::min(std::max(offset, 0.0f), 1.0f), color };
+	auto iter = std::upper_bound(mStops.begin(), mStops.end(), stop.offset, [](float value, const Stop& other) { return value < other.offset; });
+	mStops.insert(iter, stop);
+	BuildTable();
+}
+
+void Gradient::ClearStops()
+{
+	mStops.clear();
+	std::fill(mTable, mTable + kTableSize, 0u);
+}
+
+uint32_t Gradient::Shade(float x, float y) const
+{
+	const float scale = static_cast<float>(kTableSize - 1);
+	float position = 0.0f;
+	if (mType == Type::Linear)
+	{
+		position = ((x - mOrigin.x) * mSlope.x + (y - mOrigin.y) * mSlope.y) * scale;
+	}
+	else
+	{
+		const float dx = x - mOrigin.x;
+		const float dy = y - mOrigin.y;
+		position = std::sqrt(dx * dx + dy * dy) * mInverseRadius * scale;
+	}
+
+	position += 0.5f;
+	if (!(position >= 0.0f))
+		return mTable[0];
+	return mTable[std::min(static_cast<int>(position), kTableSize - 1)];
+}
+
+void Gradient::ShadeSpan(int x, int y, int count, uint32_t* colors) const
+{
+	const float scale = static_cast<float>(kTableSize - 1);
+	if (mType == Type::Linear)
+	{
+		const float start = ((x - mOrigin.x) * mSlope.x + (y - mOrigin.y) * mSlope.y) * scale + 0.5f;
+		const float step = mSlope.x * scale;
+		if (step == 0.0f)
+		{
+			std::fill(colors, colors + count, Shade(static_cast<float>(x), static_cast<float>(y)));
+			return;
+		}
+
+		// The ramp is monotonic along the row, pixels before and after the table are plain fills
+		float low = -start / step;
+		float high = (kTableSize - start) / step;
+		if (step < 0.0f)
+			std::swap(low, high);
+		const int first = static_cast<int>(std::min(std::max(std::ceil(low), 0.0f), static_cast<float>(count)));
+		const int last = static_cast<int>(std::min(std::max(std::ceil(high), static_cast<float>(first)), static_cast<float>(count)));
+		const uint32_t before = step > 0.0f ? mTable[0] : mTable[kTableSize - 1];
+		const uint32_t after = step > 0.0f ? mTable[kTableSize - 1] : mTable[0];
+		std::fill(colors, colors + first, before);
+		std::fill(colors + last, colors + count, after);
+
+		// Steps of more than the table only leave one pixel in it, the clamp keeps the fixed point in range
+		const float clampedStep = std::min(std::max(step, -scale), scale);
+		int32_t position = static_cast<int32_t>(std::floor((start + first * step) * kFixedOne));
+		const int32_t positionStep = static_cast<int32_t>(std::floor(clampedStep * kFixedOne));
+		for (int i = first; i < last; ++i, position += positionStep)
+			colors[i] = mTable[std::min(std::max(position >> 16, 0), kTableSize - 1)];
+		return;
+	}
+
+	// Radial, the offset from the center steps by one pixel along the row
+	const float radialScale = mInverseRadius * scale;
+	const float dy = y - mOrigin.y;
+	const float dySquared = dy * dy;
+	const float dx = x - mOrigin.x;
+	int i = 0;
+#if PIX_SSE
+	// The reciprocal square root estimate is good to 12 bits, well within one table entry
+	__m128 dx4 = _mm_add_ps(_mm_set1_ps(dx), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+	const __m128 four = _mm_set1_ps(4.0f);
+	const __m128 dySquared4 = _mm_set1_ps(dySquared);
+	const __m128 radialScale4 = _mm_set1_ps(radialScale);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 maxPosition = _mm_set1_ps(scale);
+	const __m128 tiny = _mm_set1_ps(1e-20f);
+	alignas(16) int32_t indices[4];
+	for (; i + 4 <= count; i += 4, dx4 = _mm_add_ps(dx4, four))
+	{
+		const __m128 distanceSquared = _mm_add_ps(_mm_mul_ps(dx4, dx4), dySquared4);
+		const __m128 distance = _mm_mul_ps(distanceSquared, _mm_rsqrt_ps(_mm_max_ps(distanceSquared, tiny)));
+		const __m128 position = _mm_min_ps(_mm_add_ps(_mm_mul_ps(distance, radialScale4), half), maxPosition);
+		_mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvttps_epi32(position));
+		colors[i] = mTable[indices[0]];
+		colors[i + 1] = mTable[indices[1]];
+		colors[i + 2] = mTable[indices[2]];
+		colors[i + 3] = mTable[indices[3]];
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		const float offset = dx + i;
+		const float position = std::sqrt(offset * offset + dySquared) * radialScale + 0.5f;
+		colors[i] = mTable[static_cast<int>(std::min(position, scale))];
+	}
+}
+
+void Gradient::BuildTable()
+{
+	// Stops are blended premultiplied, so a transparent stop fades without darkening the colors next to it
+	size_t next = 0;
+	for (int i = 0; i < kTableSize; ++i)
+	{
+		const float t = static_cast<float>(i) / (kTableSize - 1);
+		while (next < mStops.size() && mStops[next].offset <= t)
+			++next;
+
+		if (next == 0 || next == mStops.size())
+		{
+			mTable[i] = mStops[next == 0 ? 0 : next - 1].color;
+			continue;
+		}
+
+		const Stop& from = mStops[next - 1];
+		const Stop& to = mStops[next];
+		mTable[i] = Blend::LerpColor(from.color, to.color, (t - from.offset) / (to.offset - from.offset));
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Vector2.h"
+
+#include <cstdint>
+#include <vector>
+
+// Color ramp for the gradient shade mode, in screen pixels with pixel centers on whole numbers.
+// The stops are baked into a table of premultiplied colors, so shading a pixel is finding its place along
+// the ramp and one lookup. Places before the first stop or past the last one take the color of that stop.
+class Gradient
+{
+public:
+	enum class Type
+	{
+		Linear,	// 0 at the start point to 1 at the end point, constant across
+		Radial	// 0 at the center to 1 at the radius
+	};
+
+	void SetLinear(const Vector2& from, const Vector2& to);
+	void SetRadial(const Vector2& center, float radius);
+
+	// Color is packed premultiplied, stops at the same offset make a hard edge
+	void AddStop(float offset, uint32_t color);
+	void ClearStops();
+	bool HasStops() const { return !mStops.empty(); }
+
+	uint32_t Shade(float x, float y) const;
+
+	// Colors of count pixels along row y starting at x. Linear ramps step a fixed point table index by a
+	// constant per pixel, radial ones step the offset from the center and take 4 approximate square roots
+	// at a time where SSE2 is available.
+	void ShadeSpan(int x, int y, int count, uint32_t* colors) const;
+
+private:
+	static constexpr int kTableSize = 256;
+
+	struct Stop
+	{
+		float offset;
+		uint32_t color;
+	};
+
+	void BuildTable();
+
+	Type mType = Type::Linear;
+	Vector2 mOrigin;			// Start point or center
+	Vector2 mSlope;				// Ramp change per pixel along x and y, linear only
+	float mInverseRadius = 0.0f;
+	std::vector<Stop> mStops;	// Sorted by offset, equal offsets in the order they were added
+	uint32_t mTable[kTableSize] = {};
+};
@@ -1,8 +1,51 @@
 #include "Graphics.h"
 
+#include "AccumulationBuffer.h"
+#include "Camera.h"
+#include "Culler.h"
+#include "DepthBuffer.h"
+#include "Dither.h"
+#include "FrameBuffer.h"
+#include "LayerStack.h"
+#include "MatrixStack.h"
+#include "MeshCache.h"
+#include "PostEffects.h"
+#include "PrimitivesManager.h"
+#include "Rasterizer.h"
+#include "RayTracer.h"
 #include "Viewport.h"
 
 void Graphics::NewFrame()
 {
 	Viewport::Get()->OnNewFrame();
+	Camera::Get()->OnNewFrame();
+	Culler::Get()->OnNewFrame();
+	MatrixStack::Get()->OnNewFrame();
+	MeshCache::Get()->OnNewFrame();
+	PrimitivesManager::Get()->OnNewFrame();
+	Rasterizer::Get()->OnNewFrame();
+	DepthBuffer::Get()->OnNewFrame();
+	LayerStack::Get()->OnNewFrame();
+	FrameBuffer::Get()->OnNewFrame();
+	PostEffects::Get()->OnNewFrame();
+	Dither::Get()->OnNewFrame();
+	RayTracer::Get()->OnNewFrame();
+	AccumulationBuffer::Get()->OnNewFrame();
+}
+
+void Graphics::EndFrame()
+{
+	FrameBuffer::Get()->Present();
+}
+
+void Graphics::EndSample()
+{
+	FrameBuffer::Get()->Accumulate();
+}
+
+void Graphics::SetResolution(int width, int height)
+{
+	Viewport::Get()->SetScreenSize(width, height);
+	DepthBuffer::Get()->Initialize(width, height);
+	FrameBuffer::Get()->Initialize(width, height);
 }
\ No newline at end of file
@@ -3,4 +3,9 @@
 namespace Graphics
 {
 	void NewFrame();
+	void EndFrame();
+
+	// Ends a frame that is only added to the accumulation buffer, see AccumulationBuffer
+	void EndSample();
+	void SetResolution(int width, int height);
 }
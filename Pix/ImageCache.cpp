@@ -0,0 +1,52 @@
+#include "ImageCache.h"
+
+#include <XEngine.h>
+#include <stb/stb_image.h>
+
+ImageCache* ImageCache::Get()
+{
+	static ImageCache sInstance;
+	return &sInstance;
+}
+
+const Image* ImageCache::GetImage(const std::string& fileName)
+{
+	auto iter = mImages.find(fileName);
+	if (iter == mImages.end())
+	{
+		std::unique_ptr<Image> image = Load(fileName);
+		if (image == nullptr)
+		{
+			XLOG("Failed to load image: %s", fileName.c_str());
+		}
+		iter = mImages.emplace(fileName, std::move(image)).first;
+	}
+	return iter->second.get();
+}
+
+std::unique_ptr<Image> ImageCache::Load(const std::string& fileName)
+{
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	stbi_uc* pixels = stbi_load(fileName.c_str(), &width, &height, &channels, 4);
+	if (pixels == nullptr)
+		return nullptr;
+
+	// Premultiplied once here, so blits blend the pixels as they are
+	auto image = std::make_unique<Image>();
+	image->width = width;
+	image->height = height;
+	image->pixels.resize(width * height);
+	for (int i = 0; i < width * height; ++i)
+	{
+		const stbi_uc* texel = &pixels[i * 4];
+		const uint32_t a = texel[3];
+		const uint32_t r = (texel[0] * a + 127) / 255;
+		const uint32_t g = (texel[1] * a + 127) / 255;
+		const uint32_t b = (texel[2] * a + 127) / 255;
+		image->pixels[i] = r | (g << 8) | (b << 16) | (a << 24);
+	}
+	stbi_image_free(pixels);
+	return image;
+}
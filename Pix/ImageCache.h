@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Decoded image for DrawImage at its own size, premultiplied RGBA8 with red in the low byte
+struct Image
+{
+	int width = 0;
+	int height = 0;
+	std::vector<uint32_t> pixels;
+};
+
+class ImageCache
+{
+public:
+	static ImageCache* Get();
+
+public:
+	// Images are decoded once and kept for later frames and scripts, failed loads are not retried
+	const Image* GetImage(const std::string& fileName);
+
+	// Decodes an image without keeping it, nullptr if it fails to load
+	static std::unique_ptr<Image> Load(const std::string& fileName);
+
+private:
+	std::map<std::string, std::unique_ptr<Image>> mImages;
+};
@@ -0,0 +1,105 @@
+#include "ImageDiff.h"
+
+#include "Simd.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+	const int kBlockRows = 16;
+
+	int GetDifference(uint32_t color, uint32_t reference)
+	{
+		int difference = 0;
+		for (int channel = 0; channel < 4; ++channel)
+		{
+			const int a = static_cast<int>((color >> (channel * 8)) & 0xff);
+			const int b = static_cast<int>((reference >> (channel * 8)) & 0xff);
+			difference = std::max(difference, std::abs(a - b));
+		}
+		return difference;
+	}
+
+	uint32_t GetHeat(int difference, int tolerance, uint32_t reference)
+	{
+		if (difference > tolerance)
+			return 0xff0000ffu | static_cast<uint32_t>(std::min(difference * 2, 255)) << 8;
+		return 0xff000000u | ((reference >> 2) & 0x3f3f3fu);
+	}
+}
+
+ImageDiff::Result ImageDiff::Compare(const uint32_t* pixels, const uint32_t* reference, int width, int height, int tolerance, uint32_t* heatmap)
+{
+	if (width <= 0 || height <= 0)
+		return Result();
+
+	std::vector<Result> blockResults((height + kBlockRows - 1) / kBlockRows);
+	ThreadPool::Get()->ParallelFor(height, kBlockRows, [&](int begin, int end)
+	{
+		Result result;
+		for (int y = begin; y < end; ++y)
+		{
+			const uint32_t* row = pixels + static_cast<size_t>(y) * width;
+			const uint32_t* referenceRow = reference + static_cast<size_t>(y) * width;
+			uint32_t* heatRow = heatmap != nullptr ? heatmap + static_cast<size_t>(y) * width : nullptr;
+			int x = 0;
+#if PIX_SSE
+			// The largest channel difference ends up in the low byte of each pixel
+			static const int kBitCounts[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+			const __m128i lowByte = _mm_set1_epi32(0xff);
+			const __m128i tolerance4 = _mm_set1_epi32(tolerance);
+			const __m128i hotBase = _mm_set1_epi32(static_cast<int>(0xff0000ffu));
+			const __m128i dimBase = _mm_set1_epi32(static_cast<int>(0xff000000u));
+			const __m128i dimMask = _mm_set1_epi32(0x3f3f3f);
+			__m128i maxDifference = _mm_setzero_si128();
+			for (; x + 4 <= width; x += 4)
+			{
+				const __m128i color = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+				const __m128i expected = _mm_loadu_si128(reinterpret_cast<const __m128i*>(referenceRow + x));
+				__m128i difference = _mm_or_si128(_mm_subs_epu8(color, expected), _mm_subs_epu8(expected, color));
+				difference = _mm_max_epu8(difference, _mm_srli_epi32(difference, 8));
+				difference = _mm_max_epu8(difference, _mm_srli_epi32(difference, 16));
+				difference = _mm_and_si128(difference, lowByte);
+
+				const __m128i over = _mm_cmpgt_epi32(difference, tolerance4);
+				result.differing += kBitCounts[_mm_movemask_ps(_mm_castsi128_ps(over))];
+				maxDifference = _mm_max_epi16(maxDifference, difference);
+
+				if (heatRow != nullptr)
+				{
+					const __m128i green = _mm_min_epi16(_mm_slli_epi32(difference, 1), lowByte);
+					const __m128i hot = _mm_or_si128(hotBase, _mm_slli_epi32(green, 8));
+					const __m128i dim = _mm_or_si128(dimBase, _mm_and_si128(_mm_srli_epi32(expected, 2), dimMask));
+					const __m128i heat = _mm_or_si128(_mm_and_si128(over, hot), _mm_andnot_si128(over, dim));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(heatRow + x), heat);
+				}
+			}
+
+			alignas(16) int32_t lanes[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), maxDifference);
+			result.maxDifference = std::max({ result.maxDifference, lanes[0], lanes[1], lanes[2], lanes[3] });
+#endif
+			for (; x < width; ++x)
+			{
+				const int difference = GetDifference(row[x], referenceRow[x]);
+				if (difference > tolerance)
+					++result.differing;
+				result.maxDifference = std::max(result.maxDifference, difference);
+				if (heatRow != nullptr)
+					heatRow[x] = GetHeat(difference, tolerance, referenceRow[x]);
+			}
+		}
+		blockResults[begin / kBlockRows] = result;
+	});
+
+	Result result;
+	for (const Result& blockResult : blockResults)
+	{
+		result.differing += blockResult.differing;
+		result.maxDifference = std::max(result.maxDifference, blockResult.maxDifference);
+	}
+	return result;
+}
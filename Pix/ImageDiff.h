@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+// Per pixel comparison of two premultiplied RGBA8 images of the same size, four pixels per SSE2 register.
+// A pixel differs when any channel is further than tolerance from the reference.
+namespace ImageDiff
+{
+	struct Result
+	{
+		uint32_t differing = 0;		// Pixels beyond the tolerance
+		int maxDifference = 0;		// Largest channel difference of any pixel
+	};
+
+	// Rows are split across the ThreadPool. heatmap is optional and gets the reference dimmed to a quarter
+	// for pixels within the tolerance, and red through yellow by the size of the difference for the others.
+	Result Compare(const uint32_t* pixels, const uint32_t* reference, int width, int height, int tolerance, uint32_t* heatmap = nullptr);
+}
@@ -0,0 +1,368 @@
+#include "ImageWriter.h"
+
+#include "Deflate.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+
+namespace
+{
+	// Filtered bytes per independently compressed band, big enough that restarting the matches costs little
+	const size_t kBandBytes = 256 * 1024;
+
+	enum Filter
+	{
+		None,
+		Sub,
+		Up,
+		Average,
+		Paeth,
+		FilterCount
+	};
+
+	struct Tables
+	{
+		uint8_t unpremultiply[256][256];	// By alpha, then by premultiplied value
+		uint32_t crc[256];
+
+		Tables()
+		{
+			for (int alpha = 0; alpha < 256; ++alpha)
+			{
+				for (int value = 0; value < 256; ++value)
+					unpremultiply[alpha][value] = alpha == 0 ? 0 : static_cast<uint8_t>(std::min((value * 255 + alpha / 2) / alpha, 255));
+			}
+
+			for (uint32_t i = 0; i < 256; ++i)
+			{
+				uint32_t value = i;
+				for (int bit = 0; bit < 8; ++bit)
+					value = (value & 1) ? 0xedb88320u ^ (value >> 1) : value >> 1;
+				crc[i] = value;
+			}
+		}
+	};
+
+	const Tables kTables;
+
+	void ConvertRow(const uint32_t* pixels, int width, int channels, uint8_t* out)
+	{
+		for (int x = 0; x < width; ++x, out += channels)
+		{
+			const uint32_t color = pixels[x];
+			const uint8_t* unpremultiply = kTables.unpremultiply[color >> 24];
+			out[0] = unpremultiply[color & 0xff];
+			out[1] = unpremultiply[(color >> 8) & 0xff];
+			out[2] = unpremultiply[(color >> 16) & 0xff];
+			if (channels == 4)
+				out[3] = static_cast<uint8_t>(color >> 24);
+		}
+	}
+
+	uint8_t GetPaeth(int left, int up, int upLeft)
+	{
+		const int estimate = left + up - upLeft;
+		const int toLeft = std::abs(estimate - left);
+		const int toUp = std::abs(estimate - up);
+		const int toUpLeft = std::abs(estimate - upLeft);
+		if (toLeft <= toUp && toLeft <= toUpLeft)
+			return static_cast<uint8_t>(left);
+		return static_cast<uint8_t>(toUp <= toUpLeft ? up : upLeft);
+	}
+
+	uint8_t ApplyFilter(int filter, const uint8_t* row, const uint8_t* above, size_t i, int channels)
+	{
+		const int left = i >= static_cast<size_t>(channels) ? row[i - channels] : 0;
+		const int upLeft = i >= static_cast<size_t>(channels) ? above[i - channels] : 0;
+		switch (filter)
+		{
+		case Sub:
+			return static_cast<uint8_t>(row[i] - left);
+		case Up:
+			return static_cast<uint8_t>(row[i] - above[i]);
+		case Average:
+			return static_cast<uint8_t>(row[i] - ((left + above[i]) >> 1));
+		case Paeth:
+			return static_cast<uint8_t>(row[i] - GetPaeth(left, above[i], upLeft));
+		default:
+			return row[i];
+		}
+	}
+
+	// Writes the filter byte and the row with the filter whose bytes are smallest as signed values
+	void FilterRow(const uint8_t* row, const uint8_t* above, size_t size, int channels, uint8_t* out)
+	{
+		int best = None;
+		uint64_t bestScore = UINT64_MAX;
+		for (int filter = None; filter < FilterCount; ++filter)
+		{
+			uint64_t score = 0;
+			for (size_t i = 0; i < size && score < bestScore; ++i)
+				score += std::abs(static_cast<int8_t>(ApplyFilter(filter, row, above, i, channels)));
+			if (score < bestScore)
+			{
+				bestScore = score;
+				best = filter;
+			}
+		}
+
+		out[0] = static_cast<uint8_t>(best);
+		for (size_t i = 0; i < size; ++i)
+			out[i + 1] = ApplyFilter(best, row, above, i, channels);
+	}
+
+	uint32_t GetCrc32(const uint8_t* data, size_t size)
+	{
+		uint32_t crc = 0xffffffffu;
+		for (size_t i = 0; i < size; ++i)
+			crc = kTables.crc[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+		return crc ^ 0xffffffffu;
+	}
+
+	void PutBigEndian(std::vector<uint8_t>& out, uint32_t value)
+	{
+		out.push_back(static_cast<uint8_t>(value >> 24));
+		out.push_back(static_cast<uint8_t>(value >> 16));
+		out.push_back(static_cast<uint8_t>(value >> 8));
+		out.push_back(static_cast<uint8_t>(value));
+	}
+
+	void PutChunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& data)
+	{
+		PutBigEndian(png, static_cast<uint32_t>(data.size()));
+		const size_t start = png.size();
+		png.insert(png.end(), type, type + 4);
+		png.insert(png.end(), data.begin(), data.end());
+		PutBigEndian(png, GetCrc32(&png[start], png.size() - start));
+	}
+}
+
+ImageWriter* ImageWriter::Get()
+{
+	static ImageWriter sInstance;
+	return &sInstance;
+}
+
+ImageWriter::~ImageWriter()
+{
+	// Queued saves are still written
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mWake.notify_all();
+	if (mThread.joinable())
+		mThread.join();
+}
+
+void ImageWriter::RequestSave(const std::string& fileName, bool always)
+{
+	mRequests.push_back({ fileName, always });
+}
+
+void ImageWriter::OnPresent(const uint32_t* pixels, int width, int height, bool changed)
+{
+	if (changed)
+		mSavedFiles.clear();
+	if (mRequests.empty() || width <= 0 || height <= 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (const auto& request : mRequests)
+		{
+			if (!request.second && mSavedFiles.count(request.first) > 0)
+				continue;
+			mSavedFiles.insert(request.first);
+
+			Queue(request.first, pixels, width, height);
+		}
+	}
+	mRequests.clear();
+	mWake.notify_one();
+}
+
+void ImageWriter::Save(const std::string& fileName, const uint32_t* pixels, int width, int height)
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		Queue(fileName, pixels, width, height);
+	}
+	mWake.notify_one();
+}
+
+void ImageWriter::Flush()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mIdle.wait(lock, [this]() { return mJobs.empty() && !mBusy; });
+}
+
+ImageWriter::Stats ImageWriter::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	Stats stats = mStats;
+	stats.pending = static_cast<uint32_t>(mJobs.size()) + (mBusy ? 1 : 0);
+	return stats;
+}
+
+void ImageWriter::Queue(const std::string& fileName, const uint32_t* pixels, int width, int height)
+{
+	// A save of the same file that has not started yet takes the newer pixels
+	auto iter = std::find_if(mJobs.begin(), mJobs.end(), [&](const auto& job) { return job->fileName == fileName; });
+	if (iter == mJobs.end())
+	{
+		mJobs.push_back(std::make_unique<Job>());
+		iter = std::prev(mJobs.end());
+	}
+
+	Job& job = **iter;
+	job.fileName = fileName;
+	job.pixels.assign(pixels, pixels + width * height);
+	job.width = width;
+	job.height = height;
+
+	if (!mThread.joinable())
+		mThread = std::thread(&ImageWriter::WorkerLoop, this);
+}
+
+void ImageWriter::WorkerLoop()
+{
+	while (true)
+	{
+		std::unique_ptr<Job> job;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWake.wait(lock, [this]() { return mStop || !mJobs.empty(); });
+			if (mJobs.empty())
+				return;
+
+			job = std::move(mJobs.front());
+			mJobs.pop_front();
+			mBusy = true;
+		}
+
+		const auto startTime = std::chrono::high_resolution_clock::now();
+		std::vector<uint8_t> png;
+		int threads = 0;
+		bool saved = Encode(*job, png, threads);
+		if (saved)
+		{
+			std::ofstream file(job->fileName, std::ios::binary);
+			file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+			saved = file.good();
+		}
+		const float timeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mBusy = false;
+			if (saved)
+			{
+				++mStats.saved;
+				mStats.lastFile = job->fileName;
+				mStats.lastBytes = png.size();
+				mStats.lastMs = timeMs;
+				mStats.threads = threads;
+			}
+			else
+			{
+				++mStats.failed;
+			}
+		}
+		mIdle.notify_all();
+	}
+}
+
+bool ImageWriter::Encode(const Job& job, std::vector<uint8_t>& png, int& threads) const
+{
+	// Opaque frames drop the alpha channel
+	const int width = job.width;
+	const int height = job.height;
+	const uint32_t* pixels = job.pixels.data();
+	const bool opaque = std::all_of(job.pixels.begin(), job.pixels.end(), [](uint32_t color) { return (color >> 24) == 0xff; });
+	const int channels = opaque ? 3 : 4;
+	const size_t rowBytes = static_cast<size_t>(width) * channels;
+	const int bandRows = static_cast<int>(std::max<size_t>(kBandBytes / (rowBytes + 1), 1));
+	const int bandCount = (height + bandRows - 1) / bandRows;
+
+	// Each band converts the row above it again, which the Up, Average and Paeth filters look at
+	struct Band
+	{
+		std::vector<uint8_t> compressed;
+		uint32_t adler = 1;
+		size_t size = 0;
+	};
+	std::vector<Band> bands(bandCount);
+	std::atomic<int> nextBand{ 0 };
+	auto encodeBands = [&]()
+	{
+		std::vector<uint8_t> above(rowBytes);
+		std::vector<uint8_t> row(rowBytes);
+		std::vector<uint8_t> filtered;
+		for (int band = nextBand++; band < bandCount; band = nextBand++)
+		{
+			const int begin = band * bandRows;
+			const int end = std::min(begin + bandRows, height);
+			if (begin > 0)
+				ConvertRow(pixels + static_cast<size_t>(begin - 1) * width, width, channels, above.data());
+			else
+				std::fill(above.begin(), above.end(), static_cast<uint8_t>(0));
+
+			filtered.resize(static_cast<size_t>(end - begin) * (rowBytes + 1));
+			for (int y = begin; y < end; ++y)
+			{
+				ConvertRow(pixels + static_cast<size_t>(y) * width, width, channels, row.data());
+				FilterRow(row.data(), above.data(), rowBytes, channels, &filtered[static_cast<size_t>(y - begin) * (rowBytes + 1)]);
+				above.swap(row);
+			}
+
+			bands[band].adler = Deflate::Adler32(filtered.data(), filtered.size());
+			bands[band].size = filtered.size();
+			Deflate::CompressPiece(filtered.data(), filtered.size(), band == bandCount - 1, bands[band].compressed);
+		}
+	};
+
+	// The save thread takes bands too. These threads are separate from the ThreadPool, which belongs to the
+	// render loop.
+	threads = std::min(static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)), bandCount);
+	std::vector<std::thread> workers;
+	for (int i = 1; i < threads; ++i)
+		workers.emplace_back(encodeBands);
+	encodeBands();
+	for (std::thread& worker : workers)
+		worker.join();
+
+	// Zlib stream, fastest compression level in the header
+	std::vector<uint8_t> stream = { 0x78, 0x01 };
+	uint32_t adler = bands[0].adler;
+	for (int band = 0; band < bandCount; ++band)
+	{
+		stream.insert(stream.end(), bands[band].compressed.begin(), bands[band].compressed.end());
+		if (band > 0)
+			adler = Deflate::CombineAdler32(adler, bands[band].adler, bands[band].size);
+	}
+	PutBigEndian(stream, adler);
+
+	std::vector<uint8_t> header;
+	PutBigEndian(header, static_cast<uint32_t>(width));
+	PutBigEndian(header, static_cast<uint32_t>(height));
+	header.push_back(8);					// Bits per channel
+	header.push_back(opaque ? 2 : 6);		// RGB or RGBA
+	header.push_back(0);					// Deflate
+	header.push_back(0);					// Adaptive filters
+	header.push_back(0);					// Not interlaced
+
+	const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	png.assign(signature, signature + 8);
+	png.reserve(stream.size() + 64);
+	PutChunk(png, "IHDR", header);
+	PutChunk(png, "IDAT", stream);
+	PutChunk(png, "IEND", {});
+	return stream.size() < UINT32_MAX;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// Saves presented frames as PNG files without holding up the render loop. Present only copies the frame,
+// a background thread converts, filters and compresses it. The image is split into bands of rows that
+// deflate on their own, on as many threads as there are cores, and the pieces join into one stream.
+// Scripts ask for a save every frame, so a file is only written again when the frame changed.
+class ImageWriter
+{
+public:
+	static ImageWriter* Get();
+
+public:
+	struct Stats
+	{
+		uint32_t saved = 0;
+		uint32_t failed = 0;
+		uint32_t pending = 0;
+		std::string lastFile;
+		size_t lastBytes = 0;
+		float lastMs = 0.0f;	// Encode and write time of the last save
+		int threads = 0;
+	};
+
+	~ImageWriter();
+
+	// Saves the next presented frame to fileName, always also writes a frame that was saved before
+	void RequestSave(const std::string& fileName, bool always = false);
+
+	// Queues the requested saves of premultiplied RGBA8 pixels in linear row order, changed is false when
+	// the frame is the same as the last one
+	void OnPresent(const uint32_t* pixels, int width, int height, bool changed);
+
+	// Queues a save of premultiplied RGBA8 pixels that are not the presented frame
+	void Save(const std::string& fileName, const uint32_t* pixels, int width, int height);
+
+	// Waits for every queued save to be written
+	void Flush();
+
+	Stats GetStats() const;
+
+private:
+	struct Job
+	{
+		std::string fileName;
+		std::vector<uint32_t> pixels;
+		int width = 0;
+		int height = 0;
+	};
+
+	// Call with the mutex held
+	void Queue(const std::string& fileName, const uint32_t* pixels, int width, int height);
+	void WorkerLoop();
+	bool Encode(const Job& job, std::vector<uint8_t>& png, int& threads) const;
+
+	std::vector<std::pair<std::string, bool>> mRequests;
+	std::unordered_set<std::string> mSavedFiles;	// Files holding the current frame
+
+	std::thread mThread;
+	mutable std::mutex mMutex;
+	std::condition_variable mWake;
+	std::condition_variable mIdle;
+	std::deque<std::unique_ptr<Job>> mJobs;
+	bool mBusy = false;
+	bool mStop = false;
+	Stats mStats;
+};
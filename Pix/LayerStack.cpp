@@ -0,0 +1,274 @@
+#include "LayerStack.h"
+
+#include "AccumulationBuffer.h"
+#include "DepthBuffer.h"
+#include "FrameBuffer.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	// Pixels composited by one task, every layer is blended over a tile while it is in the cache
+	const int kTilePixels = 4096;
+
+	// Key of a layer that was created but not drawn into this frame
+	const uint64_t kEmptyLayer = 1;
+
+	uint64_t HashCombine(uint64_t hash, uint64_t value)
+	{
+		return hash ^ (value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+	}
+
+	uint32_t FloatBits(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	// Multiplies every channel by scale / 256, scale in 0..256, so the pixels stay premultiplied
+	void ScalePixels(uint32_t* dest, const uint32_t* source, int count, uint32_t scale)
+	{
+		int i = 0;
+#if PIX_SSE
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i factor = _mm_set1_epi16(static_cast<short>(scale));
+		const __m128i half = _mm_set1_epi16(128);
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+			__m128i low = _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), factor);
+			__m128i high = _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), factor);
+			low = _mm_srli_epi16(_mm_add_epi16(low, half), 8);
+			high = _mm_srli_epi16(_mm_add_epi16(high, half), 8);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packus_epi16(low, high));
+		}
+#endif
+		for (; i < count; ++i)
+		{
+			uint32_t result = 0;
+			for (int shift = 0; shift < 32; shift += 8)
+				result |= ((((source[i] >> shift) & 0xff) * scale + 128) >> 8) << shift;
+			dest[i] = result;
+		}
+	}
+}
+
+LayerStack* LayerStack::Get()
+{
+	static LayerStack sInstance;
+	return &sInstance;
+}
+
+void LayerStack::OnNewFrame()
+{
+	SetTarget(kBase);
+
+	// Layers the last frame did not create are gone
+	mLayers.erase(std::remove_if(mLayers.begin(), mLayers.end(), [](const Layer& layer) { return !layer.created; }), mLayers.end());
+	for (Layer& layer : mLayers)
+	{
+		layer.created = false;
+		layer.visited = false;
+		layer.cached = false;
+	}
+	mOrder.clear();
+	mSignatures.clear();
+	mStats = {};
+}
+
+bool LayerStack::CreateLayer(const std::string& name, float opacity, BlendMode blendMode)
+{
+	// Layers hold colors, palette mode only has the frame buffer
+	if (FrameBuffer::Get()->IsPaletteMode())
+		return false;
+
+	int index = FindLayer(name);
+	if (index < 0)
+	{
+		index = static_cast<int>(mLayers.size());
+		mLayers.emplace_back();
+		mLayers.back().name = name;
+	}
+
+	Layer& layer = mLayers[index];
+	if (layer.created)
+		return false;
+
+	layer.opacity = std::min(std::max(opacity, 0.0f), 1.0f);
+	layer.blendMode = blendMode;
+	layer.created = true;
+	mOrder.push_back(index);
+	++mStats.layers;
+	return true;
+}
+
+bool LayerStack::SetLayer(const std::string& name)
+{
+	FrameBuffer* frameBuffer = FrameBuffer::Get();
+	const int index = FindLayer(name);
+	if (index < 0 || !mLayers[index].created || frameBuffer->IsPaletteMode())
+		return false;
+
+	// The first time this frame decides whether last frame's pixels are still what the script draws
+	Layer& layer = mLayers[index];
+	if (!layer.visited)
+	{
+		const uint64_t signature = GetSignature(name);
+		const size_t size = static_cast<size_t>(frameBuffer->GetTargetSize());
+		layer.cached = signature != 0 && signature == layer.signature && layer.pixels.size() == size;
+		if (layer.cached)
+			++mStats.layersCached;
+		else
+			layer.pixels.assign(size, 0);
+		layer.signature = signature;
+		layer.visited = true;
+	}
+
+	SetTarget(index);
+
+	// Depth drawn into other layers does not hide this one
+	DepthBuffer::Get()->Clear();
+	return true;
+}
+
+void LayerStack::SetSignature(const std::string& name, uint64_t signature)
+{
+	mSignatures[name] = signature;
+}
+
+bool LayerStack::Composite()
+{
+	if (mOrder.empty())
+		return false;
+
+	const auto startTime = std::chrono::high_resolution_clock::now();
+	SetTarget(kBase);
+
+	FrameBuffer* frameBuffer = FrameBuffer::Get();
+	uint32_t* pixels = frameBuffer->GetTargetPixels();
+	const int size = frameBuffer->GetTargetSize();
+	const int entries = static_cast<int>(mOrder.size()) + 1;
+
+	// One key per entry, base first, 0 for an entry that can differ from any earlier frame
+	mKeys.assign(entries, 0);
+	mKeys[0] = GetSignature("");
+	for (int entry = 1; entry < entries; ++entry)
+	{
+		const Layer& layer = mLayers[mOrder[entry - 1]];
+		if (!layer.visited)
+			mKeys[entry] = kEmptyLayer;
+		else if (layer.signature != 0 && layer.pixels.size() == static_cast<size_t>(size))
+			mKeys[entry] = HashCombine(HashCombine(layer.signature, FloatBits(layer.opacity)), static_cast<uint64_t>(layer.blendMode));
+	}
+
+	// The cached composite replaces the entries at the bottom when all of them are unchanged
+	int reuse = 0;
+	if (mComposite.size() == static_cast<size_t>(size) && !mCompositeKeys.empty() && mCompositeKeys.size() <= mKeys.size() &&
+		std::equal(mCompositeKeys.begin(), mCompositeKeys.end(), mKeys.begin()))
+	{
+		reuse = static_cast<int>(mCompositeKeys.size());
+	}
+
+	// Entries that did not change since last frame are likely to stay the same while a layer above is edited,
+	// keep the composite up to the last of them when it covers more than the cached one
+	int stable = 0;
+	while (stable < entries && stable < static_cast<int>(mLastKeys.size()) && mKeys[stable] != 0 && mKeys[stable] == mLastKeys[stable])
+		++stable;
+
+	const int snapshot = stable > reuse ? stable : 0;
+	if (snapshot > 0)
+	{
+		mComposite.resize(size);
+		mCompositeKeys.assign(mKeys.begin(), mKeys.begin() + snapshot);
+	}
+
+	const int first = std::max(reuse, 1);
+	for (int entry = first; entry < entries; ++entry)
+	{
+		if (mKeys[entry] != kEmptyLayer)
+			++mStats.layersComposited;
+	}
+
+	// Tiles are independent, each one goes through every layer before the next one is loaded
+	const int tiles = (size + kTilePixels - 1) / kTilePixels;
+	ThreadPool::Get()->ParallelFor(tiles, 1, [&](int begin, int end)
+	{
+		uint32_t scaled[kTilePixels];
+		for (int tile = begin; tile < end; ++tile)
+		{
+			const int offset = tile * kTilePixels;
+			const int count = std::min(kTilePixels, size - offset);
+			uint32_t* dest = pixels + offset;
+			if (reuse > 0)
+				memcpy(dest, &mComposite[offset], count * sizeof(uint32_t));
+
+			for (int entry = first; entry < entries; ++entry)
+			{
+				if (entry == snapshot)
+					memcpy(&mComposite[offset], dest, count * sizeof(uint32_t));
+
+				const Layer& layer = mLayers[mOrder[entry - 1]];
+				if (!layer.visited || layer.opacity <= 0.0f || layer.pixels.size() != static_cast<size_t>(size))
+					continue;
+
+				const uint32_t* source = &layer.pixels[offset];
+				if (layer.opacity < 1.0f)
+				{
+					ScalePixels(scaled, source, count, static_cast<uint32_t>(std::lround(layer.opacity * 256.0f)));
+					source = scaled;
+				}
+				Blend::BlendPixels(layer.blendMode, dest, source, count);
+			}
+
+			if (snapshot == entries)
+				memcpy(&mComposite[offset], dest, count * sizeof(uint32_t));
+		}
+	});
+
+	mLastKeys.swap(mKeys);
+	mStats.compositeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	return true;
+}
+
+int LayerStack::FindLayer(const std::string& name) const
+{
+	for (size_t i = 0; i < mLayers.size(); ++i)
+	{
+		if (mLayers[i].name == name)
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+uint64_t LayerStack::GetSignature(const std::string& name) const
+{
+	auto iter = mSignatures.find(name);
+	if (iter == mSignatures.end() || iter->second == 0)
+		return 0;
+
+	// The same statements draw different pixels at another size, layout or accumulation jitter
+	const FrameBuffer* frameBuffer = FrameBuffer::Get();
+	const Vector2 jitter = AccumulationBuffer::Get()->GetJitter();
+	uint64_t signature = HashCombine(iter->second, static_cast<uint64_t>(frameBuffer->GetWidth()) << 32 | static_cast<uint32_t>(frameBuffer->GetHeight()));
+	signature = HashCombine(signature, static_cast<uint64_t>(frameBuffer->GetLayout()));
+	signature = HashCombine(signature, static_cast<uint64_t>(FloatBits(jitter.x)) << 32 | FloatBits(jitter.y));
+	return signature != 0 ? signature : kEmptyLayer + 1;
+}
+
+void LayerStack::SetTarget(int target)
+{
+	if (target == mTarget)
+		return;
+
+	// Hand the pixels drawn so far back to their owner, then take the new target's
+	FrameBuffer* frameBuffer = FrameBuffer::Get();
+	frameBuffer->SwapTarget(mTarget == kBase ? mBase : mLayers[mTarget].pixels);
+	frameBuffer->SwapTarget(target == kBase ? mBase : mLayers[target].pixels);
+	mTarget = target;
+}
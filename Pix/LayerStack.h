@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Blend.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Named color buffers the script draws into with SetLayer, composited over the frame buffer at the end of
+// the frame in the order they were created, each with its own opacity and blend mode. Drawing before the
+// first SetLayer goes to the frame buffer itself, the base the layers are composited over.
+// Layers start transparent and with a clear depth buffer, so a layer only depends on the script statements
+// up to the last one drawing into it. The script parser hashes those statements, and a layer whose hash
+// did not change keeps last frame's pixels and skips its drawing commands. The composite of the unchanged
+// layers at the bottom is kept too, so editing a layer only composites it and the ones above it again.
+class LayerStack
+{
+public:
+	static LayerStack* Get();
+
+public:
+	struct Stats
+	{
+		uint32_t layers = 0;
+		uint32_t layersCached = 0;		// Kept last frame's pixels
+		uint32_t layersComposited = 0;	// The others came from the cached composite
+		float compositeMs = 0.0f;
+	};
+
+	void OnNewFrame();
+
+	// Adds a layer above the ones created so far this frame, fails if the name was already created this frame.
+	// Layers that are not created again the next frame are dropped.
+	bool CreateLayer(const std::string& name, float opacity, BlendMode blendMode);
+
+	// Draws into a layer created this frame from now on
+	bool SetLayer(const std::string& name);
+
+	// Hash of the statements up to the last one drawing into the layer, "" for the base. Set by the script
+	// parser before the script runs, layers without one are drawn every frame.
+	void SetSignature(const std::string& name, uint64_t signature);
+
+	// True while drawing into a layer that kept last frame's pixels, drawing commands have nothing to do
+	bool IsTargetCached() const { return mTarget >= 0 && mLayers[mTarget].cached; }
+
+	// Makes the frame buffer the target again and composites the layers onto it, returns false without layers
+	bool Composite();
+
+	const Stats& GetStats() const { return mStats; }
+
+private:
+	static constexpr int kBase = -1;
+
+	struct Layer
+	{
+		std::string name;
+		std::vector<uint32_t> pixels;	// Frame buffer layout, swapped into the frame buffer while it is the target
+		uint64_t signature = 0;			// Of the statements that drew the pixels, 0 if they cannot be reused
+		float opacity = 1.0f;
+		BlendMode blendMode = BlendMode::Over;
+		bool created = false;
+		bool visited = false;
+		bool cached = false;
+	};
+
+	int FindLayer(const std::string& name) const;
+
+	// Signature set for name combined with the frame buffer state the pixels depend on, 0 if none was set
+	uint64_t GetSignature(const std::string& name) const;
+
+	void SetTarget(int target);
+
+	std::vector<Layer> mLayers;
+	std::vector<int> mOrder;					// Layers created this frame, bottom first
+	std::unordered_map<std::string, uint64_t> mSignatures;
+	std::vector<uint32_t> mBase;				// Frame buffer pixels while a layer is the target
+	std::vector<uint32_t> mComposite;			// Base and the layers at the bottom that did not change
+	std::vector<uint64_t> mCompositeKeys;		// What mComposite holds, base first
+	std::vector<uint64_t> mKeys;				// What this frame composites, base first
+	std::vector<uint64_t> mLastKeys;
+	Stats mStats;
+	int mTarget = kBase;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+// Read only view of a whole file, mapped into memory instead of copied through a stream
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const char* fileName);
+	void Close();
+
+	const char* GetData() const { return mData; }
+	size_t GetSize() const { return mSize; }
+
+private:
+	const char* mData = nullptr;
+	size_t mSize = 0;
+#ifdef _WIN32
+	void* mFile = nullptr;
+	void* mMapping = nullptr;
+#endif
+};
@@ -0,0 +1,55 @@
+#include "MatrixStack.h"
+
+#include <XEngine.h>
+
+MatrixStack* MatrixStack::Get()
+{
+	static MatrixStack sInstance;
+	return &sInstance;
+}
+
+void MatrixStack::OnNewFrame()
+{
+	mStack.clear();
+	mStack.push_back(Matrix4::Identity());
+	++mVersion;
+}
+
+void MatrixStack::PushMatrix()
+{
+	// Copying the top keeps the transform the same, no version bump needed
+	mStack.push_back(mStack.back());
+}
+
+bool MatrixStack::PopMatrix()
+{
+	if (mStack.size() <= 1)
+		return false;
+
+	mStack.pop_back();
+	++mVersion;
+	return true;
+}
+
+void MatrixStack::Translate(const Vector3& offset)
+{
+	Apply(Matrix4::Translation(offset));
+}
+
+void MatrixStack::Rotate(const Vector3& degrees)
+{
+	Apply(Matrix4::RotationX(degrees.x * X::Math::kDegToRad)
+		* Matrix4::RotationY(degrees.y * X::Math::kDegToRad)
+		* Matrix4::RotationZ(degrees.z * X::Math::kDegToRad));
+}
+
+void MatrixStack::Scale(const Vector3& scale)
+{
+	Apply(Matrix4::Scaling(scale));
+}
+
+void MatrixStack::Apply(const Matrix4& matrix)
+{
+	mStack.back() = matrix * mStack.back();
+	++mVersion;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Matrix4.h"
+
+#include <cstdint>
+#include <vector>
+
+class MatrixStack
+{
+public:
+	static MatrixStack* Get();
+
+public:
+	void OnNewFrame();
+
+	void PushMatrix();
+	bool PopMatrix();
+
+	// Applied to the top matrix, before the transforms already on it
+	void Translate(const Vector3& offset);
+	void Rotate(const Vector3& degrees);
+	void Scale(const Vector3& scale);
+
+	const Matrix4& GetTransform() const { return mStack.back(); }
+
+	// Bumped whenever the top matrix changes so users can cache what they derive from it
+	uint32_t GetVersion() const { return mVersion; }
+
+private:
+	void Apply(const Matrix4& matrix);
+
+	std::vector<Matrix4> mStack{ Matrix4::Identity() };
+	uint32_t mVersion = 0;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Sphere.h"
+#include "Vertex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Indexed triangle list, front faces wind clockwise on screen
+struct Mesh
+{
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+
+	// Model space bounds for object level culling
+	Sphere bounds;
+
+	// Load stats for the render view
+	size_t fileSize = 0;
+	float loadSeconds = 0.0f;
+
+	// Modeled vertex transforms per triangle before and after the cache optimisation
+	float originalTransformsPerTriangle = 0.0f;
+	float transformsPerTriangle = 0.0f;
+};
@@ -0,0 +1,54 @@
+#include "MeshCache.h"
+
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+
+#include <XEngine.h>
+#include <chrono>
+
+MeshCache* MeshCache::Get()
+{
+	static MeshCache sInstance;
+	return &sInstance;
+}
+
+void MeshCache::OnNewFrame()
+{
+	mCurrentMesh = nullptr;
+}
+
+bool MeshCache::LoadMesh(const std::string& fileName)
+{
+	auto iter = mMeshes.find(fileName);
+	if (iter == mMeshes.end())
+	{
+		const auto startTime = std::chrono::high_resolution_clock::now();
+
+		std::unique_ptr<Mesh> mesh = std::make_unique<Mesh>();
+		if (ObjLoader::Load(fileName.c_str(), *mesh))
+		{
+			mesh->originalTransformsPerTriangle = MeshOptimizer::GetTransformsPerTriangle(mesh->indices, mesh->vertices.size());
+			MeshOptimizer::OptimizeVertexCache(mesh->indices, mesh->vertices.size());
+			MeshOptimizer::OptimizeVertexFetch(mesh->vertices, mesh->indices);
+			mesh->transformsPerTriangle = MeshOptimizer::GetTransformsPerTriangle(mesh->indices, mesh->vertices.size());
+
+			mesh->loadSeconds = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - startTime).count();
+			XLOG("Loaded %s: %zu vertices, %zu triangles, %.1f MB/s, transforms per triangle %.2f -> %.2f",
+				fileName.c_str(),
+				mesh->vertices.size(),
+				mesh->indices.size() / 3,
+				mesh->fileSize / (mesh->loadSeconds * 1000000.0f),
+				mesh->originalTransformsPerTriangle,
+				mesh->transformsPerTriangle);
+		}
+		else
+		{
+			XLOG("Failed to load mesh: %s", fileName.c_str());
+			mesh.reset();
+		}
+		iter = mMeshes.emplace(fileName, std::move(mesh)).first;
+	}
+
+	mCurrentMesh = iter->second.get();
+	return mCurrentMesh != nullptr;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Mesh.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+class MeshCache
+{
+public:
+	static MeshCache* Get();
+
+public:
+	void OnNewFrame();
+
+	// Meshes are loaded once and kept for later frames, failed loads are not retried
+	bool LoadMesh(const std::string& fileName);
+
+	// Mesh from the last successful LoadMesh this frame
+	const Mesh* GetCurrentMesh() const { return mCurrentMesh; }
+
+private:
+	std::map<std::string, std::unique_ptr<Mesh>> mMeshes;
+	const Mesh* mCurrentMesh = nullptr;
+};
@@ -0,0 +1,190 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const float kCacheDecayPower = 1.5f;
+	const float kLastTriangleScore = 0.75f;
+	const float kValenceBoostScale = 2.0f;
+	const float kValenceBoostPower = 0.5f;
+
+	// Favors vertices near the front of the cache and vertices with few triangles left
+	float GetVertexScore(int cachePosition, uint32_t remainingTriangles)
+	{
+		if (remainingTriangles == 0)
+			return -1.0f;
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			// The last triangle's vertices get a fixed score so the next pick does not just repeat them
+			if (cachePosition < 3)
+				score = kLastTriangleScore;
+			else
+				score = std::pow(1.0f - (cachePosition - 3) / static_cast<float>(MeshOptimizer::kCacheSize - 3), kCacheDecayPower);
+		}
+		score += kValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -kValenceBoostPower);
+		return score;
+	}
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+		return;
+
+	// Triangles touching each vertex, packed into one array
+	std::vector<uint32_t> remaining(vertexCount, 0);
+	for (uint32_t index : indices)
+		++remaining[index];
+
+	std::vector<uint32_t> offsets(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; ++v)
+		offsets[v + 1] = offsets[v] + remaining[v];
+
+	std::vector<uint32_t> adjacency(indices.size());
+	std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t t = 0; t < triangleCount; ++t)
+	{
+		for (size_t k = 0; k < 3; ++k)
+			adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v)
+		vertexScore[v] = GetVertexScore(-1, remaining[v]);
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	int bestTriangle = -1;
+	float bestScore = -1.0f;
+	for (size_t t = 0; t < triangleCount; ++t)
+	{
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+		if (triangleScore[t] > bestScore)
+		{
+			bestScore = triangleScore[t];
+			bestTriangle = static_cast<int>(t);
+		}
+	}
+
+	// Modeled LRU cache, three extra slots hold the vertices pushed out by the last triangle
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> nextCache;
+	cache.reserve(kCacheSize + 3);
+	nextCache.reserve(kCacheSize + 3);
+
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+	size_t scanCursor = 0;
+
+	for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+	{
+		// Nothing in the cache is useful, take the next unused triangle in the original order
+		if (bestTriangle < 0)
+		{
+			while (emitted[scanCursor])
+				++scanCursor;
+			bestTriangle = static_cast<int>(scanCursor);
+		}
+
+		const uint32_t* triangle = &indices[bestTriangle * 3];
+		output.insert(output.end(), triangle, triangle + 3);
+		emitted[bestTriangle] = true;
+
+		// Drop the triangle from its vertices' adjacency lists
+		for (size_t k = 0; k < 3; ++k)
+		{
+			const uint32_t v = triangle[k];
+			uint32_t* begin = &adjacency[offsets[v]];
+			uint32_t* last = begin + remaining[v] - 1;
+			std::iter_swap(std::find(begin, last, static_cast<uint32_t>(bestTriangle)), last);
+			--remaining[v];
+		}
+
+		// Move the triangle's vertices to the front of the cache
+		nextCache.assign(triangle, triangle + 3);
+		for (uint32_t v : cache)
+		{
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+				nextCache.push_back(v);
+		}
+		for (size_t i = kCacheSize; i < nextCache.size(); ++i)
+		{
+			cachePosition[nextCache[i]] = -1;
+			vertexScore[nextCache[i]] = GetVertexScore(-1, remaining[nextCache[i]]);
+		}
+		if (nextCache.size() > static_cast<size_t>(kCacheSize))
+			nextCache.resize(kCacheSize);
+		cache.swap(nextCache);
+
+		for (size_t i = 0; i < cache.size(); ++i)
+		{
+			cachePosition[cache[i]] = static_cast<int>(i);
+			vertexScore[cache[i]] = GetVertexScore(static_cast<int>(i), remaining[cache[i]]);
+		}
+
+		// Only triangles touching cached vertices changed score, pick the best of them
+		bestTriangle = -1;
+		bestScore = -1.0f;
+		for (uint32_t v : cache)
+		{
+			for (uint32_t i = 0; i < remaining[v]; ++i)
+			{
+				const uint32_t t = adjacency[offsets[v] + i];
+				const uint32_t* other = &indices[t * 3];
+				triangleScore[t] = vertexScore[other[0]] + vertexScore[other[1]] + vertexScore[other[2]];
+				if (triangleScore[t] > bestScore)
+				{
+					bestScore = triangleScore[t];
+					bestTriangle = static_cast<int>(t);
+				}
+			}
+		}
+	}
+
+	indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+	const uint32_t kUnused = ~0u;
+	std::vector<uint32_t> remap(vertices.size(), kUnused);
+	std::vector<Vertex> output;
+	output.reserve(vertices.size());
+	for (uint32_t& index : indices)
+	{
+		if (remap[index] == kUnused)
+		{
+			remap[index] = static_cast<uint32_t>(output.size());
+			output.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+	vertices.swap(output);
+}
+
+float MeshOptimizer::GetTransformsPerTriangle(const std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+		return 0.0f;
+
+	// FIFO cache modeled with insertion times, a vertex is cached if it went in less than kCacheSize misses ago
+	const uint32_t kNever = ~0u;
+	std::vector<uint32_t> insertedAt(vertexCount, kNever);
+	uint32_t misses = 0;
+	for (uint32_t index : indices)
+	{
+		if (insertedAt[index] == kNever || misses - insertedAt[index] >= static_cast<uint32_t>(kCacheSize))
+		{
+			insertedAt[index] = misses;
+			++misses;
+		}
+	}
+	return static_cast<float>(misses) / triangleCount;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Vertex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MeshOptimizer
+{
+	// Size of the post-transform cache the triangle order is tuned for
+	constexpr int kCacheSize = 32;
+
+	// Reorders triangles so shared vertices are reused while still in the post-transform cache.
+	// Uses Tom Forsyth's linear-speed vertex cache optimisation.
+	void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+	// Renumbers vertices in the order the indices first use them so fetches walk memory forwards
+	void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+	// Average vertex transforms per triangle for a FIFO cache of kCacheSize, lower is better
+	float GetTransformsPerTriangle(const std::vector<uint32_t>& indices, size_t vertexCount);
+}
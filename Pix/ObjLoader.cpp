@@ -0,0 +1,210 @@
+#include "ObjLoader.h"
+
+#include "MappedFile.h"
+#include "MathHelper.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <unordered_map>
+
+namespace
+{
+	bool IsDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	const char* SkipSpaces(const char* p, const char* end)
+	{
+		while (p < end && (*p == ' ' || *p == '\t'))
+			++p;
+		return p;
+	}
+
+	const char* SkipLine(const char* p, const char* end)
+	{
+		while (p < end && *p != '\n')
+			++p;
+		return p < end ? p + 1 : end;
+	}
+
+	const char* ParseInt(const char* p, const char* end, int& out)
+	{
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+'))
+			negative = *p++ == '-';
+
+		int value = 0;
+		while (p < end && IsDigit(*p))
+			value = value * 10 + (*p++ - '0');
+
+		out = negative ? -value : value;
+		return p;
+	}
+
+	// Handles the [sign]digits[.digits][e[sign]digits] forms OBJ exporters write
+	const char* ParseFloat(const char* p, const char* end, float& out)
+	{
+		p = SkipSpaces(p, end);
+
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+'))
+			negative = *p++ == '-';
+
+		double value = 0.0;
+		while (p < end && IsDigit(*p))
+			value = value * 10.0 + (*p++ - '0');
+
+		if (p < end && *p == '.')
+		{
+			++p;
+			double scale = 0.1;
+			while (p < end && IsDigit(*p))
+			{
+				value += (*p++ - '0') * scale;
+				scale *= 0.1;
+			}
+		}
+
+		if (p < end && (*p == 'e' || *p == 'E'))
+		{
+			int exponent = 0;
+			p = ParseInt(p + 1, end, exponent);
+			value *= std::pow(10.0, exponent);
+		}
+
+		out = static_cast<float>(negative ? -value : value);
+		return p;
+	}
+
+	// OBJ indices are 1 based, negative ones count back from the last element read
+	int ResolveIndex(int index, size_t count)
+	{
+		if (index > 0)
+			return index - 1;
+		if (index < 0)
+			return static_cast<int>(count) + index;
+		return -1;
+	}
+}
+
+bool ObjLoader::Load(const char* fileName, Mesh& mesh)
+{
+	MappedFile file;
+	if (!file.Open(fileName))
+		return false;
+
+	const char* p = file.GetData();
+	const char* end = p + file.GetSize();
+
+	std::vector<Vector3> positions;
+	std::vector<Vector2> uvs;
+	std::unordered_map<uint64_t, uint32_t> vertexLookup;
+	std::vector<uint32_t> polygon;
+
+	// Rough guesses from the file size to avoid most regrowth
+	const size_t estimate = file.GetSize() / 64;
+	positions.reserve(estimate);
+	uvs.reserve(estimate);
+	vertexLookup.reserve(estimate);
+	mesh.vertices.clear();
+	mesh.vertices.reserve(estimate);
+	mesh.indices.clear();
+	mesh.indices.reserve(estimate * 3);
+
+	while (p < end)
+	{
+		p = SkipSpaces(p, end);
+		if (p + 1 >= end)
+			break;
+
+		if (p[0] == 'v' && (p[1] == ' ' || p[1] == '\t'))
+		{
+			// Flip z to go from the right handed OBJ space to our left handed one
+			Vector3 position;
+			p = ParseFloat(p + 1, end, position.x);
+			p = ParseFloat(p, end, position.y);
+			p = ParseFloat(p, end, position.z);
+			position.z = -position.z;
+			positions.push_back(position);
+		}
+		else if (p[0] == 'v' && p[1] == 't')
+		{
+			// OBJ puts v = 0 at the bottom of the image
+			Vector2 uv;
+			p = ParseFloat(p + 2, end, uv.x);
+			p = ParseFloat(p, end, uv.y);
+			uv.y = 1.0f - uv.y;
+			uvs.push_back(uv);
+		}
+		else if (p[0] == 'f' && (p[1] == ' ' || p[1] == '\t'))
+		{
+			polygon.clear();
+			p = SkipSpaces(p + 1, end);
+			while (p < end && *p != '\n' && *p != '\r' && *p != '#')
+			{
+				int positionIndex = 0;
+				int uvIndex = 0;
+				int normalIndex = 0;
+				const char* token = p;
+				p = ParseInt(p, end, positionIndex);
+				if (p == token)
+					return false;
+				if (p < end && *p == '/')
+				{
+					if (p + 1 < end && p[1] != '/')
+						p = ParseInt(p + 1, end, uvIndex);
+					else
+						++p;
+					if (p < end && *p == '/')
+						p = ParseInt(p + 1, end, normalIndex);
+				}
+				p = SkipSpaces(p, end);
+
+				positionIndex = ResolveIndex(positionIndex, positions.size());
+				uvIndex = ResolveIndex(uvIndex, uvs.size());
+				if (positionIndex < 0 || positionIndex >= static_cast<int>(positions.size()) || uvIndex >= static_cast<int>(uvs.size()))
+					return false;
+
+				// Share vertices that use the same position and uv
+				const uint64_t key = (static_cast<uint64_t>(positionIndex) << 32) | static_cast<uint32_t>(uvIndex + 1);
+				auto [iter, inserted] = vertexLookup.try_emplace(key, static_cast<uint32_t>(mesh.vertices.size()));
+				if (inserted)
+				{
+					Vertex& v = mesh.vertices.emplace_back();
+					v.pos = positions[positionIndex];
+					if (uvIndex >= 0)
+						v.uv = uvs[uvIndex];
+				}
+				polygon.push_back(iter->second);
+			}
+
+			// Fan the polygon, reversing the winding along with the z flip
+			for (size_t i = 2; i < polygon.size(); ++i)
+			{
+				mesh.indices.push_back(polygon[0]);
+				mesh.indices.push_back(polygon[i]);
+				mesh.indices.push_back(polygon[i - 1]);
+			}
+		}
+
+		p = SkipLine(p, end);
+	}
+
+	// Sphere around the center of the bounding box
+	Vector3 minPos(FLT_MAX);
+	Vector3 maxPos(-FLT_MAX);
+	for (const Vertex& v : mesh.vertices)
+	{
+		minPos = Vector3(std::min(minPos.x, v.pos.x), std::min(minPos.y, v.pos.y), std::min(minPos.z, v.pos.z));
+		maxPos = Vector3(std::max(maxPos.x, v.pos.x), std::max(maxPos.y, v.pos.y), std::max(maxPos.z, v.pos.z));
+	}
+	mesh.bounds.center = (minPos + maxPos) * 0.5f;
+	mesh.bounds.radius = 0.0f;
+	for (const Vertex& v : mesh.vertices)
+		mesh.bounds.radius = std::max(mesh.bounds.radius, MathHelper::Magnitude(v.pos - mesh.bounds.center));
+
+	mesh.fileSize = file.GetSize();
+	return !mesh.indices.empty();
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "Mesh.h"
+
+namespace ObjLoader
+{
+	// Reads positions, texture coordinates and faces from a Wavefront OBJ file.
+	// Polygons are fanned into triangles and identical position/uv pairs share one vertex.
+	bool Load(const char* fileName, Mesh& mesh);
+}
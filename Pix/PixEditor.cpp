@@ -5,16 +5,31 @@
 
 #include "PixEditor.h"
 
+#include "AccumulationBuffer.h"
 #include "CommandDictionary.h"
+#include "Culler.h"
+#include "DepthBuffer.h"
+#include "Dither.h"
+#include "ImageWriter.h"
+#include "FrameBuffer.h"
 #include "Graphics.h"
+#include "LayerStack.h"
+#include "MeshCache.h"
+#include "PostEffects.h"
+#include "PrimitivesManager.h"
+#include "Rasterizer.h"
+#include "RayTracer.h"
 #include "VariableCache.h"
 #include "Viewport.h"
 #include <ImGui/imgui.h>
+#include <chrono>
 
 namespace
 {
 	const char* const sPixFileExtension = "pix";
 	const char* const sFileDialogFilters = "Pix Files (*.pix)\0*.pix;\0All Files (*.*)\0*.*;\0";
+	const char* const sImageDialogFilters = "PNG Files (*.png)\0*.png;\0All Files (*.*)\0*.*;\0";
+	const char* const sImageFileExtension = "png";
 	const uint32_t sDefaultRenderViewWidth = 500;
 	const uint32_t sDefaultRenderViewHeight = 500;
 	const uint32_t sDefaultPixelSize = 1;
@@ -53,6 +68,7 @@ void PixEditor::Initialize()
 {
 	// Enable render to texture
 	X::InitRenderTexture(sDefaultRenderViewWidth, sDefaultRenderViewHeight, sDefaultPixelSize);
+	Graphics::SetResolution(sDefaultRenderViewWidth, sDefaultRenderViewHeight);
 
 	// Initialize language definition
 	mLanguageDefinition = CommandDictionary::Get()->GenerateLanguageDefinition();
@@ -68,6 +84,8 @@ void PixEditor::Initialize()
 
 void PixEditor::Terminate()
 {
+	// Finish writing the images still queued
+	ImageWriter::Get()->Flush();
 }
 
 bool PixEditor::Run(float deltaTime)
@@ -148,6 +166,8 @@ void PixEditor::ShowFileMenu()
 		Save();
 	if (ImGui::MenuItem("Save As..", "Ctrl+Shift+S"))
 		SaveAs();
+	if (ImGui::MenuItem("Save Image.."))
+		SaveImage();
 
 	ImGui::Separator();
 
@@ -356,15 +376,28 @@ void PixEditor::ShowRenderView(float deltaTime)
 	snprintf(title, sizeof(title), "Render - fps: %.3f###Render", fps);
 	ImGui::Begin(title, &mShowRenderView, ImGuiWindowFlags_AlwaysAutoResize);
 
+	const auto scriptStart = std::chrono::high_resolution_clock::now();
 	Graphics::NewFrame();
 	mScriptParser.ExecuteScript();
 
+	// Accumulating scripts can take more samples per frame, the last one is presented with the average
+	for (int i = 1; i < AccumulationBuffer::Get()->GetSamplesPerFrame() && !AccumulationBuffer::Get()->IsConverged(); ++i)
+	{
+		Graphics::EndSample();
+		Graphics::NewFrame();
+		mScriptParser.ExecuteScript();
+	}
+	mScriptTimeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - scriptStart).count();
+	Graphics::EndFrame();
+
 	Viewport::Get()->DrawViewport();
 
 	const float renderTextureWidth = static_cast<float>(X::GetRenderTextureWidth());
 	const float renderTextureHeight = static_cast<float>(X::GetRenderTextureHeight());
 	ImGui::Image(X::GetRenderTexture(), { renderTextureWidth, renderTextureHeight });
 
+	ShowRenderStats();
+
 	mHasDockedWindow = ImGui::IsWindowDocked();
 
 	if (ImGui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows))
@@ -373,6 +406,139 @@ void PixEditor::ShowRenderView(float deltaTime)
 	ImGui::End();
 }
 
+void PixEditor::ShowRenderStats()
+{
+	const uint32_t pixelCount = Rasterizer::Get()->GetPixelCount();
+	ImGui::Text("Script: %.2f ms, pixels: %u, %.1f ns/px",
+		mScriptTimeMs,
+		pixelCount,
+		pixelCount > 0 ? mScriptTimeMs * 1000000.0f / pixelCount : 0.0f);
+
+	const FrameBuffer::Stats& frameBufferStats = FrameBuffer::Get()->GetStats();
+	ImGui::Text("Uploaded: %u rects, %.1f KB", frameBufferStats.rectsUploaded, frameBufferStats.bytesUploaded / 1024.0f);
+	if (frameBufferStats.pixelsResolved > 0)
+		ImGui::Text("Resolved: %u pixels", frameBufferStats.pixelsResolved);
+	if (FrameBuffer::Get()->IsPaletteMode())
+		ImGui::Text("Palette: %d colors", FrameBuffer::Get()->GetPaletteSize());
+
+	const LayerStack::Stats& layerStats = LayerStack::Get()->GetStats();
+	if (layerStats.layers > 0)
+	{
+		ImGui::Text("Layers: %u, %u cached, %u composited in %.2f ms",
+			layerStats.layers,
+			layerStats.layersCached,
+			layerStats.layersComposited,
+			layerStats.compositeMs);
+	}
+
+	const PostEffects::Stats& postStats = PostEffects::Get()->GetStats();
+	if (postStats.effects > 0)
+	{
+		ImGui::Text("Post effects: %u, %.2f ms, %.1f MPx/s",
+			postStats.effects,
+			postStats.timeMs,
+			postStats.timeMs > 0.0f ? postStats.pixels / (postStats.timeMs * 1000.0f) : 0.0f);
+	}
+
+	const Dither::Stats& ditherStats = Dither::Get()->GetStats();
+	if (ditherStats.pixels > 0)
+	{
+		ImGui::Text("Dither: %.2f ms, %.1f MPx/s on %d threads",
+			ditherStats.timeMs,
+			ditherStats.timeMs > 0.0f ? ditherStats.pixels / (ditherStats.timeMs * 1000.0f) : 0.0f,
+			ditherStats.threads);
+	}
+
+	const ImageWriter::Stats imageStats = ImageWriter::Get()->GetStats();
+	if (imageStats.saved > 0 || imageStats.pending > 0 || imageStats.failed > 0)
+	{
+		ImGui::Text("Images: %u saved, %u pending, %u failed, last %.1f KB in %.2f ms on %d threads",
+			imageStats.saved,
+			imageStats.pending,
+			imageStats.failed,
+			imageStats.lastBytes / 1024.0f,
+			imageStats.lastMs,
+			imageStats.threads);
+	}
+
+	const AccumulationBuffer* accumulation = AccumulationBuffer::Get();
+	if (accumulation->IsEnabled())
+		ImGui::Text("Accumulated: %d / %d samples", accumulation->GetSampleCount(), accumulation->GetMaxSamples());
+
+	const RayTracer::Stats& rayStats = RayTracer::Get()->GetStats();
+	if (rayStats.rays > 0)
+	{
+		ImGui::Text("Ray traced: %u primitives, %u nodes, build %.2f ms, trace %.2f ms",
+			rayStats.primitives,
+			rayStats.nodes,
+			rayStats.buildMs,
+			rayStats.traceMs);
+		ImGui::Text("Rays: %llu, %.1f Mrays/s on %d threads",
+			static_cast<unsigned long long>(rayStats.rays),
+			rayStats.traceMs > 0.0f ? rayStats.rays / (rayStats.traceMs * 1000.0f) : 0.0f,
+			rayStats.threads);
+	}
+
+	const uint64_t texelCount = Rasterizer::Get()->GetTexelCount();
+	if (texelCount > 0 && mScriptTimeMs > 0.0f)
+		ImGui::Text("Texels: %llu, %.1f Mtexels/s", static_cast<unsigned long long>(texelCount), texelCount / (mScriptTimeMs * 1000.0f));
+
+	const Mesh* mesh = MeshCache::Get()->GetCurrentMesh();
+	if (mesh != nullptr)
+	{
+		ImGui::Text("Mesh: %zu vertices, %zu triangles, loaded at %.1f MB/s, cache optimized %.2f -> %.2f",
+			mesh->vertices.size(),
+			mesh->indices.size() / 3,
+			mesh->loadSeconds > 0.0f ? mesh->fileSize / (mesh->loadSeconds * 1000000.0f) : 0.0f,
+			mesh->originalTransformsPerTriangle,
+			mesh->transformsPerTriangle);
+	}
+
+	const Culler::Stats& cullStats = Culler::Get()->GetStats();
+	if (cullStats.trianglesSubmitted > 0)
+	{
+		ImGui::Text("Triangles submitted: %u, frustum culled: %u, back face culled: %u, degenerate: %u",
+			cullStats.trianglesSubmitted,
+			cullStats.trianglesFrustumCulled,
+			cullStats.trianglesBackFaceCulled,
+			cullStats.trianglesDegenerate);
+	}
+
+	const PrimitivesManager::Stats& primitiveStats = PrimitivesManager::Get()->GetStats();
+	if (primitiveStats.meshTriangles > 0)
+	{
+		ImGui::Text("Mesh triangles: %u, transformed vertices per triangle: %.2f",
+			primitiveStats.meshTriangles,
+			static_cast<float>(primitiveStats.meshTransforms) / primitiveStats.meshTriangles);
+	}
+	if (primitiveStats.strokeTriangles > 0)
+	{
+		ImGui::Text("Curves: %u, segments: %u, stroke triangles: %u",
+			primitiveStats.curves,
+			primitiveStats.curveSegments,
+			primitiveStats.strokeTriangles);
+	}
+
+	const Rasterizer::ShapeStats& shapeStats = Rasterizer::Get()->GetShapeStats();
+	if (shapeStats.shapes > 0)
+	{
+		ImGui::Text("Shapes: %u, solid tiles: %u, edge tiles: %u",
+			shapeStats.shapes,
+			shapeStats.solidTiles,
+			shapeStats.edgeTiles);
+	}
+
+	const DepthBuffer::Stats& depthStats = DepthBuffer::Get()->GetStats();
+	if (depthStats.pixelsTested > 0)
+	{
+		const float percent = 100.0f / depthStats.pixelsTested;
+		ImGui::Text("Depth tested: %u px, hi-z culled: %.1f%%, depth culled: %.1f%%",
+			depthStats.pixelsTested,
+			depthStats.pixelsTileCulled * percent,
+			depthStats.pixelsDepthCulled * percent);
+	}
+}
+
 void PixEditor::ShowAboutDialog()
 {
 	ImGui::OpenPopup("About Pix");
@@ -530,6 +696,31 @@ bool PixEditor::SaveAs()
 	return false;
 }
 
+void PixEditor::SaveImage()
+{
+	XLOG("Save image...");
+
+	char fileName[MAX_PATH] = {};
+	if (!X::SaveFileDialog(fileName, "Save Image", sImageDialogFilters))
+	{
+		XLOG("Canceled.");
+		return;
+	}
+
+	std::filesystem::path path = fileName;
+	if (!path.has_filename())
+	{
+		XLOG("Invalid file.");
+		return;
+	}
+	if (!path.has_extension())
+		path.replace_extension(sImageFileExtension);
+
+	// Written from the next presented frame
+	XLOG("Saving [%s]...", path.u8string().c_str());
+	ImageWriter::Get()->RequestSave(path.u8string(), true);
+}
+
 void PixEditor::Run(TextEditor* textEditor)
 {
 	XLOG("Run...");
@@ -552,6 +743,7 @@ void PixEditor::Run(TextEditor* textEditor)
 	{
 		Save();
 		VariableCache::Get()->Clear();
+		FrameBuffer::Get()->SetPaletteMode(false);
 		mScriptParser.ParseScript(textEditor->GetText());
 	}
 
@@ -29,12 +29,14 @@ private:
 	void ShowScriptFileWindows();
 	void ShowCloseConfirmationDialog();
 	void ShowRenderView(float deltaTime);
+	void ShowRenderStats();
 	void ShowAboutDialog();
 
 	void New();
 	void Open();
 	bool Save();
 	bool SaveAs();
+	void SaveImage();
 
 	void Run(TextEditor* textEditor = nullptr);
 
@@ -59,6 +61,7 @@ private:
 	int mNextWindowId = 0;
 	float mNextWindowPosX = 0.0f;
 	float mNextWindowPosY = 0.0f;
+	float mScriptTimeMs = 0.0f;
 	bool mShowRenderView = false;
 	bool mShowCloseConfirmationDialog = false;
 	bool mShowAboutDialog = false;
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Vector3.h"
+
+// Points with Dot(n, p) + d >= 0 are in front of the plane
+struct Plane
+{
+	Vector3 n;
+	float d;
+
+	Plane() : n(0.0f, 1.0f, 0.0f), d(0.0f) {}
+	Plane(float a, float b, float c, float d) : n(a, b, c), d(d) {}
+};
@@ -0,0 +1,307 @@
+#include "PostEffects.h"
+
+#include "Simd.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+	// Rows are filtered in blocks and transposed through a staging buffer, so each column
+	// written to the destination covers kBlockRows consecutive pixels instead of one
+	const int kBlockRows = 16;
+
+	// The four channels of a pixel as floats in 0..255
+#if PIX_SSE
+	// Wrapped so vectors of it keep the 16 byte alignment
+	struct Channels
+	{
+		__m128 v;
+	};
+
+	Channels Unpack(uint32_t color)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i bytes = _mm_cvtsi32_si128(static_cast<int>(color));
+		return { _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero)) };
+	}
+
+	// Rounds and saturates to 0..255
+	uint32_t Pack(Channels c)
+	{
+		__m128i values = _mm_cvtps_epi32(c.v);
+		values = _mm_packs_epi32(values, values);
+		return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(values, values)));
+	}
+
+	Channels Splat(float value) { return { _mm_set1_ps(value) }; }
+	Channels Set(float r, float g, float b, float a) { return { _mm_setr_ps(r, g, b, a) }; }
+	Channels Add(Channels a, Channels b) { return { _mm_add_ps(a.v, b.v) }; }
+	Channels Sub(Channels a, Channels b) { return { _mm_sub_ps(a.v, b.v) }; }
+	Channels Mul(Channels a, Channels b) { return { _mm_mul_ps(a.v, b.v) }; }
+	Channels Max(Channels a, Channels b) { return { _mm_max_ps(a.v, b.v) }; }
+
+	// Keeps color within alpha, as premultiplied colors must be
+	Channels ClampToAlpha(Channels c)
+	{
+		return { _mm_min_ps(c.v, _mm_shuffle_ps(c.v, c.v, _MM_SHUFFLE(3, 3, 3, 3))) };
+	}
+
+	// Raises alpha to the brightest color channel
+	Channels RaiseAlpha(Channels c)
+	{
+		__m128 brightest = _mm_max_ps(c.v, _mm_shuffle_ps(c.v, c.v, _MM_SHUFFLE(2, 3, 0, 1)));
+		brightest = _mm_max_ps(brightest, _mm_shuffle_ps(brightest, brightest, _MM_SHUFFLE(1, 0, 3, 2)));
+		const __m128 alphaMask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+		return { _mm_or_ps(_mm_and_ps(alphaMask, brightest), _mm_andnot_ps(alphaMask, c.v)) };
+	}
+#else
+	struct Channels
+	{
+		float v[4];
+	};
+
+	Channels Unpack(uint32_t color)
+	{
+		Channels c;
+		for (int i = 0; i < 4; ++i)
+			c.v[i] = static_cast<float>((color >> (i * 8)) & 0xff);
+		return c;
+	}
+
+	uint32_t Pack(Channels c)
+	{
+		uint32_t color = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			const float value = std::min(std::max(std::nearbyint(c.v[i]), 0.0f), 255.0f);
+			color |= static_cast<uint32_t>(value) << (i * 8);
+		}
+		return color;
+	}
+
+	Channels Splat(float value) { return { { value, value, value, value } }; }
+	Channels Set(float r, float g, float b, float a) { return { { r, g, b, a } }; }
+	Channels Add(Channels a, Channels b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+	Channels Sub(Channels a, Channels b) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+	Channels Mul(Channels a, Channels b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+	Channels Max(Channels a, Channels b) { return { { std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3]) } }; }
+
+	Channels ClampToAlpha(Channels c)
+	{
+		for (int i = 0; i < 3; ++i)
+			c.v[i] = std::min(c.v[i], c.v[3]);
+		return c;
+	}
+
+	Channels RaiseAlpha(Channels c)
+	{
+		c.v[3] = std::max(std::max(c.v[3], c.v[0]), std::max(c.v[1], c.v[2]));
+		return c;
+	}
+#endif
+
+	struct Kernel
+	{
+		int radius = 0;
+		bool box = false;
+		std::vector<Channels> weights;	// Gaussian weights from the center out, splatted
+	};
+
+	Kernel MakeKernel(PostEffectType type, int radius)
+	{
+		Kernel kernel;
+		kernel.radius = std::max(radius, 0);
+		kernel.box = type == PostEffectType::BoxBlur;
+		if (kernel.box)
+			return kernel;
+
+		// The kernel reaches two standard deviations
+		const float sigma = std::max(kernel.radius * 0.5f, 0.5f);
+		std::vector<float> weights(kernel.radius + 1);
+		float total = 0.0f;
+		for (int i = 0; i <= kernel.radius; ++i)
+		{
+			weights[i] = std::exp(-0.5f * i * i / (sigma * sigma));
+			total += i == 0 ? weights[i] : 2.0f * weights[i];
+		}
+		for (float weight : weights)
+			kernel.weights.push_back(Splat(weight / total));
+		return kernel;
+	}
+
+	// padded holds the row with radius edge pixels repeated on the left and radius + 1 on the right
+	void GaussianRow(const Channels* padded, uint32_t* output, int width, const Kernel& kernel)
+	{
+		const int radius = kernel.radius;
+		const Channels* weights = kernel.weights.data();
+		for (int x = 0; x < width; ++x)
+		{
+			// The kernel is symmetric, pair the taps to halve the multiplies
+			const Channels* center = padded + x + radius;
+			Channels sum = Mul(center[0], weights[0]);
+			for (int i = 1; i <= radius; ++i)
+				sum = Add(sum, Mul(Add(center[-i], center[i]), weights[i]));
+			output[x] = Pack(sum);
+		}
+	}
+
+	// The window sum moves one pixel per step, whatever the radius. Sums of 8 bit values stay exact in floats.
+	void BoxRow(const Channels* padded, uint32_t* output, int width, const Kernel& kernel)
+	{
+		const int size = kernel.radius * 2 + 1;
+		const Channels scale = Splat(1.0f / size);
+		Channels sum = Splat(0.0f);
+		for (int i = 0; i < size; ++i)
+			sum = Add(sum, padded[i]);
+
+		for (int x = 0; x < width; ++x)
+		{
+			output[x] = Pack(Mul(sum, scale));
+			sum = Add(sum, Sub(padded[x + size], padded[x]));
+		}
+	}
+
+	// Row buffers of each thread, kept between calls so chunks do not allocate
+	thread_local std::vector<Channels> tPadded;
+	thread_local std::vector<uint32_t> tStaging;
+
+	// Filters each row of source and writes it as a column of dest, which is height wide and width high
+	void FilterRows(const uint32_t* source, uint32_t* dest, int width, int height, const Kernel& kernel)
+	{
+		const int blockCount = (height + kBlockRows - 1) / kBlockRows;
+		ThreadPool::Get()->ParallelFor(blockCount, 1, [&](int begin, int end)
+		{
+			const int radius = kernel.radius;
+			std::vector<Channels>& padded = tPadded;
+			std::vector<uint32_t>& staging = tStaging;
+			padded.resize(width + radius * 2 + 1);
+			staging.resize(kBlockRows * width);
+			for (int block = begin; block < end; ++block)
+			{
+				const int y0 = block * kBlockRows;
+				const int rows = std::min(kBlockRows, height - y0);
+				for (int row = 0; row < rows; ++row)
+				{
+					// Edges repeat the border pixel
+					const uint32_t* line = source + (y0 + row) * width;
+					std::fill(padded.begin(), padded.begin() + radius, Unpack(line[0]));
+					for (int x = 0; x < width; ++x)
+						padded[radius + x] = Unpack(line[x]);
+					std::fill(padded.begin() + radius + width, padded.end(), Unpack(line[width - 1]));
+
+					if (kernel.box)
+						BoxRow(padded.data(), &staging[row * width], width, kernel);
+					else
+						GaussianRow(padded.data(), &staging[row * width], width, kernel);
+				}
+
+				for (int x = 0; x < width; ++x)
+				{
+					uint32_t* column = dest + x * height + y0;
+					for (int row = 0; row < rows; ++row)
+						column[row] = staging[row * width + x];
+				}
+			}
+		});
+	}
+
+	// Runs per pixel work over rows in parallel
+	template <typename Function>
+	void ForEachPixel(int width, int height, Function function)
+	{
+		ThreadPool::Get()->ParallelFor(height, kBlockRows, [&](int begin, int end)
+		{
+			for (int i = begin * width; i < end * width; ++i)
+				function(i);
+		});
+	}
+}
+
+PostEffects* PostEffects::Get()
+{
+	static PostEffects sInstance;
+	return &sInstance;
+}
+
+void PostEffects::OnNewFrame()
+{
+	mEffects.clear();
+}
+
+void PostEffects::AddEffect(const PostEffect& effect)
+{
+	mEffects.push_back(effect);
+}
+
+void PostEffects::Apply(uint32_t* pixels, int width, int height)
+{
+	mStats = Stats();
+	if (mEffects.empty() || width <= 0 || height <= 0)
+		return;
+
+	const auto startTime = std::chrono::high_resolution_clock::now();
+	const int count = width * height;
+	mTransposed.resize(count);
+	mFiltered.resize(count);
+
+	// Two passes blur both directions, source and dest may be the same
+	auto blur = [&](const uint32_t* source, uint32_t* dest, const Kernel& kernel)
+	{
+		FilterRows(source, mTransposed.data(), width, height, kernel);
+		FilterRows(mTransposed.data(), dest, height, width, kernel);
+	};
+
+	for (const PostEffect& effect : mEffects)
+	{
+		const Kernel kernel = MakeKernel(effect.type, effect.radius);
+		switch (effect.type)
+		{
+		case PostEffectType::Blur:
+		case PostEffectType::BoxBlur:
+		{
+			blur(pixels, pixels, kernel);
+			break;
+		}
+		case PostEffectType::Sharpen:
+		{
+			blur(pixels, mFiltered.data(), kernel);
+			const Channels amount = Splat(effect.amount);
+			const uint32_t* blurred = mFiltered.data();
+			ForEachPixel(width, height, [&](int i)
+			{
+				const Channels color = Unpack(pixels[i]);
+				const Channels detail = Sub(color, Unpack(blurred[i]));
+				pixels[i] = Pack(ClampToAlpha(Max(Add(color, Mul(detail, amount)), Splat(0.0f))));
+			});
+			break;
+		}
+		case PostEffectType::Bloom:
+		{
+			// Only the color above the threshold glows, alpha is raised to cover what is added
+			const float threshold = effect.threshold * 255.0f;
+			const Channels cutoff = Set(threshold, threshold, threshold, 255.0f);
+			uint32_t* bright = mFiltered.data();
+			ForEachPixel(width, height, [&](int i)
+			{
+				bright[i] = Pack(Max(Sub(Unpack(pixels[i]), cutoff), Splat(0.0f)));
+			});
+
+			blur(bright, bright, kernel);
+
+			const Channels amount = Splat(effect.amount);
+			ForEachPixel(width, height, [&](int i)
+			{
+				pixels[i] = Pack(RaiseAlpha(Add(Unpack(pixels[i]), Mul(Unpack(bright[i]), amount))));
+			});
+			break;
+		}
+		}
+	}
+
+	mStats.effects = static_cast<uint32_t>(mEffects.size());
+	mStats.pixels = static_cast<uint32_t>(count) * mStats.effects;
+	mStats.timeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+enum class PostEffectType
+{
+	Blur,		// Separable Gaussian
+	BoxBlur,	// Running sums, the same cost for any radius
+	Sharpen,	// Unsharp mask, adds amount times the difference to a Gaussian blur
+	Bloom		// Blurs what is brighter than threshold and adds amount times it back
+};
+
+struct PostEffect
+{
+	PostEffectType type = PostEffectType::Blur;
+	int radius = 1;
+	float amount = 1.0f;
+	float threshold = 0.0f;	// 0..1 of full brightness
+};
+
+// Image filters applied to the frame buffer at present, in the order they were added.
+// Rows are filtered in parallel on the ThreadPool. Each pass filters rows and writes them out as
+// columns, so a second identical pass filters the other direction and restores the orientation.
+class PostEffects
+{
+public:
+	static PostEffects* Get();
+
+public:
+	struct Stats
+	{
+		uint32_t effects = 0;
+		uint32_t pixels = 0;
+		float timeMs = 0.0f;
+	};
+
+	// Effects last one frame
+	void OnNewFrame();
+
+	void AddEffect(const PostEffect& effect);
+	bool HasEffects() const { return !mEffects.empty(); }
+
+	// Filters premultiplied RGBA8 pixels in linear row order in place
+	void Apply(uint32_t* pixels, int width, int height);
+
+	// Work done by the last apply
+	const Stats& GetStats() const { return mStats; }
+
+private:
+	std::vector<PostEffect> mEffects;
+	std::vector<uint32_t> mTransposed;
+	std::vector<uint32_t> mFiltered;
+	Stats mStats;
+};
@@ -0,0 +1,326 @@
+#include "PrimitivesManager.h"
+
+#include "AccumulationBuffer.h"
+#include "Camera.h"
+#include "Clipper.h"
+#include "Culler.h"
+#include "Curves.h"
+#include "LayerStack.h"
+#include "MatrixStack.h"
+#include "MeshOptimizer.h"
+#include "Rasterizer.h"
+#include "Viewport.h"
+
+namespace
+{
+	void PerspectiveDivide(Vertex& v)
+	{
+		// Keep 1/w for perspective correct interpolation
+		v.pos /= v.w;
+		v.w = 1.0f / v.w;
+	}
+}
+
+PrimitivesManager* PrimitivesManager::Get()
+{
+	static PrimitivesManager sInstance;
+	return &sInstance;
+}
+
+void PrimitivesManager::OnNewFrame()
+{
+	mVertexBuffer.clear();
+	mDrawBegin = false;
+	mTexCoord = Vector2();
+	mStats = Stats();
+}
+
+void PrimitivesManager::SetTexCoord(const Vector2& texCoord)
+{
+	mTexCoord = texCoord;
+}
+
+bool PrimitivesManager::BeginDraw(Topology topology, bool applyTransform)
+{
+	if (mDrawBegin)
+		return false;
+
+	mTopology = topology;
+	mApplyTransform = applyTransform;
+	mVertexBuffer.clear();
+	mDrawBegin = true;
+	return true;
+}
+
+void PrimitivesManager::AddVertex(const Vertex& vertex)
+{
+	if (mDrawBegin)
+		mVertexBuffer.push_back(vertex);
+}
+
+bool PrimitivesManager::EndDraw()
+{
+	if (!mDrawBegin)
+		return false;
+
+	// The layer already holds what these vertices draw
+	if (LayerStack::Get()->IsTargetCached())
+	{
+		mDrawBegin = false;
+		return true;
+	}
+
+	if (mApplyTransform)
+		TransformVertices();
+
+	Clipper* clipper = Clipper::Get();
+	Rasterizer* rasterizer = Rasterizer::Get();
+
+	switch (mTopology)
+	{
+	case Topology::Point:
+	{
+		for (Vertex v : mVertexBuffer)
+		{
+			if (!clipper->ClipPointNear(v))
+				continue;
+			PerspectiveDivide(v);
+			const int x = static_cast<int>(std::round(v.pos.x));
+			const int y = static_cast<int>(std::round(v.pos.y));
+			if (clipper->ClipPoint(x, y))
+				rasterizer->DrawPoint(x, y, v.pos.z, v.color);
+		}
+		break;
+	}
+	case Topology::Line:
+	{
+		for (size_t i = 1; i < mVertexBuffer.size(); i += 2)
+		{
+			Vertex v0 = mVertexBuffer[i - 1];
+			Vertex v1 = mVertexBuffer[i];
+			if (!clipper->ClipLineNear(v0, v1))
+				continue;
+			PerspectiveDivide(v0);
+			PerspectiveDivide(v1);
+			if (clipper->ClipLine(v0, v1))
+				rasterizer->DrawLine(v0, v1);
+		}
+		break;
+	}
+	case Topology::Triangle:
+	{
+		// Untransformed vertices still go through the batch so culling sees one layout
+		const size_t vertexCount = mVertexBuffer.size() - mVertexBuffer.size() % 3;
+		if (!mApplyTransform)
+		{
+			mClipBatch.Resize(vertexCount);
+			for (size_t i = 0; i < vertexCount; ++i)
+			{
+				const Vertex& v = mVertexBuffer[i];
+				mClipBatch.x[i] = v.pos.x;
+				mClipBatch.y[i] = v.pos.y;
+				mClipBatch.z[i] = v.pos.z;
+				mClipBatch.w[i] = v.w;
+			}
+		}
+
+		mTransformedIndices.resize(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i)
+			mTransformedIndices[i] = static_cast<uint32_t>(i);
+
+		Culler::Get()->CullTriangles(mClipBatch, mTransformedIndices.data(), vertexCount / 3, mTriangleVisible);
+		for (size_t i = 2; i < vertexCount; i += 3)
+		{
+			if (mTriangleVisible[i / 3])
+				DrawTriangle(mVertexBuffer[i - 2], mVertexBuffer[i - 1], mVertexBuffer[i]);
+		}
+		break;
+	}
+	}
+
+	mDrawBegin = false;
+	return true;
+}
+
+bool PrimitivesManager::DrawMesh(const Mesh& mesh)
+{
+	if (mDrawBegin)
+		return false;
+
+	const size_t triangleCount = mesh.indices.size() / 3;
+	UpdateTransform();
+	if (!Culler::Get()->IsSphereVisible(mesh.bounds, mClipTransform, static_cast<uint32_t>(triangleCount)))
+		return true;
+
+	// Post-transform FIFO cache: a vertex is reused if it was transformed less than
+	// kCacheSize transforms ago, otherwise it is queued to be transformed again
+	const uint32_t kNever = ~0u;
+	const uint32_t kCacheSize = MeshOptimizer::kCacheSize;
+	mCacheInsertedAt.assign(mesh.vertices.size(), kNever);
+	mTransformedIndices.resize(mesh.indices.size());
+	mTransformSources.clear();
+	for (size_t i = 0; i < mesh.indices.size(); ++i)
+	{
+		const uint32_t index = mesh.indices[i];
+		const uint32_t transformCount = static_cast<uint32_t>(mTransformSources.size());
+		if (mCacheInsertedAt[index] == kNever || transformCount - mCacheInsertedAt[index] >= kCacheSize)
+		{
+			mCacheInsertedAt[index] = transformCount;
+			mTransformSources.push_back(index);
+		}
+		mTransformedIndices[i] = mCacheInsertedAt[index];
+	}
+
+	// Transform the cache misses as one batch
+	const size_t transformCount = mTransformSources.size();
+	mModelBatch.Resize(transformCount);
+	for (size_t i = 0; i < transformCount; ++i)
+	{
+		const Vector3& pos = mesh.vertices[mTransformSources[i]].pos;
+		mModelBatch.x[i] = pos.x;
+		mModelBatch.y[i] = pos.y;
+		mModelBatch.z[i] = pos.z;
+	}
+	mClipBatch.Transform(mTransform, mModelBatch);
+
+	const uint32_t color = Rasterizer::Get()->GetColor();
+	mVertexBuffer.resize(transformCount);
+	for (size_t i = 0; i < transformCount; ++i)
+	{
+		Vertex& v = mVertexBuffer[i];
+		v.pos = Vector3(mClipBatch.x[i], mClipBatch.y[i], mClipBatch.z[i]);
+		v.w = mClipBatch.w[i];
+		v.color = color;
+		v.uv = mesh.vertices[mTransformSources[i]].uv;
+	}
+
+	Culler::Get()->CullTriangles(mClipBatch, mTransformedIndices.data(), triangleCount, mTriangleVisible);
+	for (size_t t = 0; t < triangleCount; ++t)
+	{
+		if (!mTriangleVisible[t])
+			continue;
+
+		const uint32_t* triangle = &mTransformedIndices[t * 3];
+		DrawTriangle(mVertexBuffer[triangle[0]], mVertexBuffer[triangle[1]], mVertexBuffer[triangle[2]]);
+	}
+
+	mStats.meshTriangles += static_cast<uint32_t>(triangleCount);
+	mStats.meshTransforms += static_cast<uint32_t>(transformCount);
+	mVertexBuffer.clear();
+	return true;
+}
+
+bool PrimitivesManager::DrawPolyline(const std::vector<Vector2>& points, float width)
+{
+	if (mDrawBegin || width <= 0.0f)
+		return false;
+
+	mStrokeTriangles.clear();
+	Curves::StrokePolyline(points, width, Curves::kTolerance, mStrokeTriangles);
+
+	// Stroke triangles wind both ways and are never culled
+	Vertex vertex;
+	vertex.color = Rasterizer::Get()->GetColor();
+	vertex.uv = mTexCoord;
+	Vertex triangle[3] = { vertex, vertex, vertex };
+	for (size_t i = 0; i < mStrokeTriangles.size(); i += 3)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			triangle[j].pos.x = mStrokeTriangles[i + j].x;
+			triangle[j].pos.y = mStrokeTriangles[i + j].y;
+		}
+		DrawTriangle(triangle[0], triangle[1], triangle[2]);
+	}
+
+	mStats.strokeTriangles += static_cast<uint32_t>(mStrokeTriangles.size() / 3);
+	return true;
+}
+
+bool PrimitivesManager::DrawBezier(const std::vector<Vector2>& controlPoints, float width)
+{
+	mCurvePoints.clear();
+	if (controlPoints.size() == 3)
+		Curves::FlattenQuadratic(controlPoints[0], controlPoints[1], controlPoints[2], Curves::kTolerance, mCurvePoints);
+	else if (controlPoints.size() == 4)
+		Curves::FlattenCubic(controlPoints[0], controlPoints[1], controlPoints[2], controlPoints[3], Curves::kTolerance, mCurvePoints);
+	else
+		return false;
+
+	++mStats.curves;
+	mStats.curveSegments += static_cast<uint32_t>(mCurvePoints.size() - 1);
+	return DrawPolyline(mCurvePoints, width);
+}
+
+void PrimitivesManager::DrawTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2)
+{
+	mClipBuffer.assign({ v0, v1, v2 });
+	if (!Clipper::Get()->ClipTriangle(mClipBuffer))
+		return;
+
+	for (Vertex& v : mClipBuffer)
+		PerspectiveDivide(v);
+
+	// Clipped polygons are convex, draw them as a fan
+	Rasterizer* rasterizer = Rasterizer::Get();
+	for (size_t j = 2; j < mClipBuffer.size(); ++j)
+		rasterizer->DrawFilledTriangle(mClipBuffer[0], mClipBuffer[j - 1], mClipBuffer[j]);
+}
+
+void PrimitivesManager::UpdateTransform()
+{
+	const MatrixStack* matrixStack = MatrixStack::Get();
+	const Camera* camera = Camera::Get();
+	const Viewport* viewport = Viewport::Get();
+	const Vector2 jitter = AccumulationBuffer::Get()->GetJitter();
+	if (mTransformValid &&
+		mMatrixStackVersion == matrixStack->GetVersion() &&
+		mCameraVersion == camera->GetVersion() &&
+		mViewportVersion == viewport->GetVersion() &&
+		mJitter.x == jitter.x && mJitter.y == jitter.y)
+		return;
+
+	// Map NDC onto the viewport with pixel centers on integers, y pointing down, offset by the accumulation jitter
+	const float left = viewport->GetMinX();
+	const float top = viewport->GetMinY();
+	const float width = viewport->GetMaxX() - left;
+	const float height = viewport->GetMaxY() - top;
+	const Matrix4 screen(
+		width * 0.5f, 0.0f, 0.0f, 0.0f,
+		0.0f, -height * 0.5f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		left + width * 0.5f - 0.5f + jitter.x, top + height * 0.5f - 0.5f + jitter.y, 0.0f, 1.0f);
+
+	const float aspectRatio = height > 0.0f ? width / height : 1.0f;
+	mClipTransform = matrixStack->GetTransform() * camera->GetViewMatrix() * camera->GetProjectionMatrix(aspectRatio);
+	mTransform = mClipTransform * screen;
+	mMatrixStackVersion = matrixStack->GetVersion();
+	mCameraVersion = camera->GetVersion();
+	mViewportVersion = viewport->GetVersion();
+	mJitter = jitter;
+	mTransformValid = true;
+}
+
+void PrimitivesManager::TransformVertices()
+{
+	// Gather positions into SoA form, transform them in one pass and scatter them back
+	const size_t count = mVertexBuffer.size();
+	mModelBatch.Resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const Vector3& pos = mVertexBuffer[i].pos;
+		mModelBatch.x[i] = pos.x;
+		mModelBatch.y[i] = pos.y;
+		mModelBatch.z[i] = pos.z;
+	}
+
+	UpdateTransform();
+	mClipBatch.Transform(mTransform, mModelBatch);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		Vertex& v = mVertexBuffer[i];
+		v.pos = Vector3(mClipBatch.x[i], mClipBatch.y[i], mClipBatch.z[i]);
+		v.w = mClipBatch.w[i];
+	}
+}
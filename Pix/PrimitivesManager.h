@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Matrix4.h"
+#include "Mesh.h"
+#include "Vertex.h"
+#include "VertexBatch.h"
+
+#include <vector>
+
+enum class Topology
+{
+	Point,
+	Line,
+	Triangle
+};
+
+class PrimitivesManager
+{
+public:
+	struct Stats
+	{
+		uint32_t meshTriangles = 0;
+		uint32_t meshTransforms = 0;
+		uint32_t curves = 0;
+		uint32_t curveSegments = 0;
+		uint32_t strokeTriangles = 0;
+	};
+
+	static PrimitivesManager* Get();
+
+public:
+	void OnNewFrame();
+
+	bool BeginDraw(Topology topology, bool applyTransform = false);
+	void AddVertex(const Vertex& vertex);
+	bool EndDraw();
+
+	// Draws an indexed mesh through the 3D transform with the current color
+	bool DrawMesh(const Mesh& mesh);
+
+	// Screen space strokes with the current color, width in pixels.
+	// Bezier curves take 3 control points for a quadratic or 4 for a cubic.
+	bool DrawPolyline(const std::vector<Vector2>& points, float width);
+	bool DrawBezier(const std::vector<Vector2>& controlPoints, float width);
+
+	// Texture coordinate given to new vertices
+	void SetTexCoord(const Vector2& texCoord);
+	const Vector2& GetTexCoord() const { return mTexCoord; }
+
+	const Stats& GetStats() const { return mStats; }
+
+private:
+	void UpdateTransform();
+	void TransformVertices();
+	void DrawTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2);
+
+	std::vector<Vertex> mVertexBuffer;
+	std::vector<Vertex> mClipBuffer;
+	std::vector<Vector2> mCurvePoints;
+	std::vector<Vector2> mStrokeTriangles;
+	VertexBatch mModelBatch;
+	VertexBatch mClipBatch;
+
+	// Post-transform cache state for DrawMesh
+	std::vector<uint32_t> mCacheInsertedAt;
+	std::vector<uint32_t> mTransformedIndices;
+	std::vector<uint32_t> mTransformSources;
+	std::vector<uint8_t> mTriangleVisible;
+
+	// Model to clip and model to screen space transforms, rebuilt only when one of their inputs changes
+	Matrix4 mClipTransform;
+	Matrix4 mTransform;
+	uint32_t mMatrixStackVersion = 0;
+	uint32_t mCameraVersion = 0;
+	uint32_t mViewportVersion = 0;
+	Vector2 mJitter;
+	bool mTransformValid = false;
+
+	Stats mStats;
+	Vector2 mTexCoord;
+	Topology mTopology = Topology::Point;
+	bool mDrawBegin = false;
+	bool mApplyTransform = false;
+};
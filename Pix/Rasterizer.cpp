@@ -1,17 +1,980 @@
 #include "Rasterizer.h"
 
+#include "Clipper.h"
+#include "DepthBuffer.h"
+#include "FrameBuffer.h"
+#include "ImageCache.h"
+#include "Shapes.h"
+#include "Simd.h"
+
+namespace
+{
+	// Edge function a * x + b * y + c, positive on the inside of the triangle
+	struct Edge
+	{
+		float a, b, c;
+		bool inclusive;
+
+		Edge() = default;
+		Edge(const Vector3& from, const Vector3& to)
+			: a(from.y - to.y)
+			, b(to.x - from.x)
+			, c(-(a * from.x + b * from.y))
+			// Top-left fill rule, so shared edges are only drawn once
+			, inclusive(a > 0.0f || (a == 0.0f && b > 0.0f))
+		{}
+
+		bool Covers(float x, float y) const
+		{
+			const float e = a * x + b * y + c;
+			return inclusive ? e >= 0.0f : e > 0.0f;
+		}
+
+		// The same edge tested at (x + ox, y + oy)
+		Edge Offset(float ox, float oy) const
+		{
+			Edge edge = *this;
+			edge.c += a * ox + b * oy;
+			return edge;
+		}
+	};
+
+	// Narrow [xMin, xMax] to the pixels covered by this edge on row y
+	void ClipSpan(const Edge& edge, int y, int& xMin, int& xMax)
+	{
+		const float fy = static_cast<float>(y);
+		if (edge.a == 0.0f)
+		{
+			if (!edge.Covers(0.0f, fy))
+				xMax = xMin - 1;
+			return;
+		}
+
+		const float bound = -(edge.b * fy + edge.c) / edge.a;
+		if (edge.a > 0.0f)
+		{
+			// Left edge, nudge the rounded bound to where the edge test flips
+			int x = static_cast<int>(std::ceil(bound));
+			if (edge.Covers(static_cast<float>(x - 1), fy))
+				--x;
+			else if (!edge.Covers(static_cast<float>(x), fy))
+				++x;
+			xMin = X::Math::Max(xMin, x);
+		}
+		else
+		{
+			// Right edge
+			int x = static_cast<int>(std::floor(bound));
+			if (edge.Covers(static_cast<float>(x + 1), fy))
+				++x;
+			else if (!edge.Covers(static_cast<float>(x), fy))
+				--x;
+			xMax = X::Math::Min(xMax, x);
+		}
+	}
+
+	// Screen space plane equations for depth, 1/w and the attributes divided by w.
+	// Built once per triangle so spans only add a constant step per pixel.
+	struct TriangleSetup
+	{
+		enum Plane { kZ, kRhw, kR, kG, kB, kA, kU, kV, kNumPlanes };
+
+		float dx[kNumPlanes];
+		float dy[kNumPlanes];
+		float c[kNumPlanes];
+		int numPlanes = 1;
+		ShadeMode shadeMode = ShadeMode::Flat;
+		uint32_t flatColor = 0;
+		const Texture* texture = nullptr;
+		const Gradient* gradient = nullptr;
+		TextureFilter filter = TextureFilter::Nearest;
+		float textureWidth = 0.0f;
+		float textureHeight = 0.0f;
+		uint32_t texelsPerPixel = 0;
+
+		TriangleSetup(const Vertex& v0, const Vertex& v1, const Vertex& v2, float area, ShadeMode mode, const Texture* texture, TextureFilter filter, const Gradient* gradient)
+			: shadeMode(mode)
+			, flatColor(v0.color)
+		{
+			// Gradients are shaded from the screen position, only depth needs a plane
+			if (mode == ShadeMode::Gradient)
+			{
+				if (gradient != nullptr && gradient->HasStops())
+					this->gradient = gradient;
+				else
+					shadeMode = ShadeMode::Flat;
+				SetPlane(kZ, v0, v1, v2, area, v0.pos.z, v1.pos.z, v2.pos.z);
+				return;
+			}
+
+			// Texturing without a texture falls back to the vertex colors
+			if (mode == ShadeMode::Texture)
+			{
+				if (texture != nullptr)
+				{
+					this->texture = texture;
+					this->filter = filter;
+					textureWidth = static_cast<float>(texture->GetWidth());
+					textureHeight = static_cast<float>(texture->GetHeight());
+					texelsPerPixel = Texture::GetTexelsPerSample(filter);
+				}
+				else
+				{
+					shadeMode = ShadeMode::Gouraud;
+				}
+			}
+
+			// Depth is already divided by w and interpolates linearly on screen
+			SetPlane(kZ, v0, v1, v2, area, v0.pos.z, v1.pos.z, v2.pos.z);
+			if (mode == ShadeMode::Flat)
+				return;
+
+			// Vertex w holds 1/w after the perspective divide
+			numPlanes = kNumPlanes;
+			SetPlane(kRhw, v0, v1, v2, area, v0.w, v1.w, v2.w);
+			const X::Color c0 = Blend::UnpackColor(v0.color);
+			const X::Color c1 = Blend::UnpackColor(v1.color);
+			const X::Color c2 = Blend::UnpackColor(v2.color);
+			SetPlane(kR, v0, v1, v2, area, c0.x * v0.w, c1.x * v1.w, c2.x * v2.w);
+			SetPlane(kG, v0, v1, v2, area, c0.y * v0.w, c1.y * v1.w, c2.y * v2.w);
+			SetPlane(kB, v0, v1, v2, area, c0.z * v0.w, c1.z * v1.w, c2.z * v2.w);
+			SetPlane(kA, v0, v1, v2, area, c0.w * v0.w, c1.w * v1.w, c2.w * v2.w);
+			SetPlane(kU, v0, v1, v2, area, v0.uv.x * v0.w, v1.uv.x * v1.w, v2.uv.x * v2.w);
+			SetPlane(kV, v0, v1, v2, area, v0.uv.y * v0.w, v1.uv.y * v1.w, v2.uv.y * v2.w);
+		}
+
+		void SetPlane(Plane plane, const Vertex& v0, const Vertex& v1, const Vertex& v2, float area, float a0, float a1, float a2)
+		{
+			const Vector3& p0 = v0.pos;
+			const Vector3& p1 = v1.pos;
+			const Vector3& p2 = v2.pos;
+			dx[plane] = ((a1 - a0) * (p2.y - p0.y) - (a2 - a0) * (p1.y - p0.y)) / area;
+			dy[plane] = ((a2 - a0) * (p1.x - p0.x) - (a1 - a0) * (p2.x - p0.x)) / area;
+			c[plane] = a0 - dx[plane] * p0.x - dy[plane] * p0.y;
+		}
+
+		void Evaluate(float x, float y, float* values) const
+		{
+			for (int i = 0; i < numPlanes; ++i)
+				values[i] = dx[i] * x + dy[i] * y + c[i];
+		}
+
+		void Step(float* values) const
+		{
+			for (int i = 0; i < numPlanes; ++i)
+				values[i] += dx[i];
+		}
+
+		// Returns a packed premultiplied color for the pixel or sample at (x, y), flat shading needs no conversion at all
+		uint32_t Shade(const float* values, float x, float y) const
+		{
+			if (shadeMode == ShadeMode::Flat)
+				return flatColor;
+			if (shadeMode == ShadeMode::Gradient)
+				return gradient->Shade(x, y);
+
+			// One divide per pixel recovers the perspective correct attributes
+			const float w = 1.0f / values[kRhw];
+			if (shadeMode == ShadeMode::Gouraud)
+				return Blend::PackColor(X::Color(values[kR] * w, values[kG] * w, values[kB] * w, values[kA] * w));
+
+			const float u = values[kU] * w;
+			const float v = values[kV] * w;
+			if (shadeMode == ShadeMode::TexCoord)
+				return Blend::PackColor(X::Color(u, v, 0.0f, 1.0f));
+
+			// Screen space derivatives of u and v by the quotient rule give the mip level
+			float lod = 0.0f;
+			if (texture->GetLevelCount() > 1)
+			{
+				const float dudx = (dx[kU] - u * dx[kRhw]) * w * textureWidth;
+				const float dvdx = (dx[kV] - v * dx[kRhw]) * w * textureHeight;
+				const float dudy = (dy[kU] - u * dy[kRhw]) * w * textureWidth;
+				const float dvdy = (dy[kV] - v * dy[kRhw]) * w * textureHeight;
+				const float footprint = X::Math::Max(dudx * dudx + dvdx * dvdx, dudy * dudy + dvdy * dvdy);
+				lod = 0.5f * std::log2(footprint);
+			}
+
+			// Premultiply the texel and modulate it by the vertex color
+			const X::Color texel = texture->Sample(u, v, lod, filter);
+			const float alpha = texel.w * w;
+			return Blend::PackColor(X::Color(texel.x * alpha * values[kR], texel.y * alpha * values[kG], texel.z * alpha * values[kB], alpha * values[kA]));
+		}
+	};
+
+	enum class SpanDepth
+	{
+		None,
+		Write,
+		Test
+	};
+
+	// Draws pixels xStart to xEnd on row y, returns the number of pixels drawn.
+	// Shaded pixels are gathered into runs so the frame buffer can blend several at once.
+	uint32_t DrawSpan(const TriangleSetup& setup, int xStart, int xEnd, int y, SpanDepth depth)
+	{
+		DepthBuffer* depthBuffer = DepthBuffer::Get();
+		FrameBuffer* frameBuffer = FrameBuffer::Get();
+
+		const int kMaxRun = 64;
+		uint32_t run[kMaxRun];
+		int runStart = xStart;
+		int runCount = 0;
+		auto flushRun = [&]()
+		{
+			if (runCount > 0)
+				frameBuffer->BlendSpan(runStart, y, run, runCount);
+			runCount = 0;
+		};
+
+		// Without depth tests every pixel is drawn, gradients shade each run in one go
+		if (setup.shadeMode == ShadeMode::Gradient && depth == SpanDepth::None)
+		{
+			for (runStart = xStart; runStart <= xEnd; runStart += kMaxRun)
+			{
+				runCount = X::Math::Min(kMaxRun, xEnd - runStart + 1);
+				setup.gradient->ShadeSpan(runStart, y, runCount, run);
+				flushRun();
+			}
+			return xEnd >= xStart ? xEnd - xStart + 1 : 0;
+		}
+
+		uint32_t count = 0;
+		float values[TriangleSetup::kNumPlanes];
+		setup.Evaluate(xStart, y, values);
+		for (int x = xStart; x <= xEnd; ++x, setup.Step(values))
+		{
+			const float z = values[TriangleSetup::kZ];
+			if (depth == SpanDepth::Test && !depthBuffer->CheckDepth(x, y, z))
+			{
+				flushRun();
+				continue;
+			}
+			if (depth == SpanDepth::Write)
+				depthBuffer->WriteDepth(x, y, z);
+
+			if (runCount == 0)
+				runStart = x;
+			run[runCount++] = setup.Shade(values, static_cast<float>(x), static_cast<float>(y));
+			if (runCount == kMaxRun)
+				flushRun();
+			++count;
+		}
+		flushRun();
+		return count;
+	}
+
+	// Sample positions in 1/16 pixel around the pixel center, a rotated grid and the usual 8x pattern
+	const int kPattern4x[4][2] = { { -2, -6 }, { 6, -2 }, { -6, 2 }, { 2, 6 } };
+	const int kPattern8x[8][2] = { { 1, -3 }, { -1, 3 }, { 5, 1 }, { -3, -5 }, { -5, 5 }, { -7, -1 }, { 3, 7 }, { 7, -7 } };
+
+	int GetSampleCount(AntiAliasing antiAliasing)
+	{
+		switch (antiAliasing)
+		{
+		case AntiAliasing::Coverage4x:		return 4;
+		case AntiAliasing::Coverage8x:		return 8;
+		case AntiAliasing::Supersample4x:	return 4;
+		default:							return 1;
+		}
+	}
+
+	// Triangle edges moved to each sample position, a sample is covered where all its edges are
+	struct SampleEdges
+	{
+		int count = 0;
+		float x[FrameBuffer::kMaxSamples];
+		float y[FrameBuffer::kMaxSamples];
+		Edge edges[FrameBuffer::kMaxSamples][3];
+		const Edge* center = nullptr;
+
+		SampleEdges(const Edge* edges, AntiAliasing antiAliasing)
+			: count(GetSampleCount(antiAliasing))
+			, center(edges)
+		{
+			const int (*pattern)[2] = count == 8 ? kPattern8x : kPattern4x;
+			for (int s = 0; s < count; ++s)
+			{
+				x[s] = pattern[s][0] / 16.0f;
+				y[s] = pattern[s][1] / 16.0f;
+				for (int i = 0; i < 3; ++i)
+					this->edges[s][i] = edges[i].Offset(x[s], y[s]);
+			}
+		}
+
+		static bool Covers(const Edge* edges, int x, int y)
+		{
+			const float fx = static_cast<float>(x);
+			const float fy = static_cast<float>(y);
+			return edges[0].Covers(fx, fy) && edges[1].Covers(fx, fy) && edges[2].Covers(fx, fy);
+		}
+	};
+
+	struct SampleCounts
+	{
+		uint32_t pixels = 0;
+		uint32_t shades = 0;
+	};
+
+	// Draws the pixels of row y covered by any sample. Pixels with every sample covered take the
+	// span path when coverage is shaded once, the others only blend into their covered samples.
+	void DrawMultisampledRow(const TriangleSetup& setup, const SampleEdges& samples, int minX, int maxX, int y, bool supersample, SampleCounts& counts)
+	{
+		// The row touches the union of the sample spans, their intersection is fully covered
+		int outerStart = maxX + 1;
+		int outerEnd = minX - 1;
+		int innerStart = minX;
+		int innerEnd = maxX;
+		for (int s = 0; s < samples.count; ++s)
+		{
+			int xStart = minX;
+			int xEnd = maxX;
+			for (const Edge& edge : samples.edges[s])
+				ClipSpan(edge, y, xStart, xEnd);
+
+			innerStart = X::Math::Max(innerStart, xStart);
+			innerEnd = X::Math::Min(innerEnd, xEnd);
+			if (xStart <= xEnd)
+			{
+				outerStart = X::Math::Min(outerStart, xStart);
+				outerEnd = X::Math::Max(outerEnd, xEnd);
+			}
+		}
+		if (outerStart > outerEnd)
+			return;
+
+		DepthBuffer* depthBuffer = DepthBuffer::Get();
+		const bool depthTest = depthBuffer->IsDepthTest();
+		if (supersample || innerStart > innerEnd)
+		{
+			innerStart = outerEnd + 1;
+			innerEnd = outerEnd;
+		}
+		else
+		{
+			const uint32_t count = DrawSpan(setup, innerStart, innerEnd, y, depthTest ? SpanDepth::Test : SpanDepth::None);
+			counts.pixels += count;
+			counts.shades += count;
+		}
+
+		FrameBuffer* frameBuffer = FrameBuffer::Get();
+		const float depthSlope = std::abs(setup.dx[TriangleSetup::kZ]) + std::abs(setup.dy[TriangleSetup::kZ]);
+		float values[TriangleSetup::kNumPlanes];
+		for (int x = outerStart; x <= outerEnd; ++x)
+		{
+			if (x == innerStart)
+			{
+				x = innerEnd;
+				continue;
+			}
+
+			uint32_t mask = 0;
+			float centroidX = 0.0f;
+			float centroidY = 0.0f;
+			int covered = 0;
+			for (int s = 0; s < samples.count; ++s)
+			{
+				if (SampleEdges::Covers(samples.edges[s], x, y))
+				{
+					mask |= 1u << s;
+					centroidX += samples.x[s];
+					centroidY += samples.y[s];
+					++covered;
+				}
+			}
+			if (mask == 0)
+				continue;
+
+			// Attributes at the centroid of the covered samples are never extrapolated past the triangle
+			const float shadeX = x + centroidX / covered;
+			const float shadeY = y + centroidY / covered;
+			setup.Evaluate(shadeX, shadeY, values);
+			if (depthTest)
+			{
+				// The triangle covering the pixel center owns the single depth value of the pixel
+				// The others only test, allowing for up to a pixel between the two depths
+				const float z = values[TriangleSetup::kZ];
+				const bool passed = SampleEdges::Covers(samples.center, x, y) ? depthBuffer->CheckDepth(x, y, z) : depthBuffer->TestDepth(x, y, z - depthSlope);
+				if (!passed)
+					continue;
+			}
+
+			if (supersample)
+			{
+				uint32_t colors[FrameBuffer::kMaxSamples];
+				for (int s = 0; s < samples.count; ++s)
+				{
+					if (mask & (1u << s))
+					{
+						const float sampleX = x + samples.x[s];
+						const float sampleY = y + samples.y[s];
+						setup.Evaluate(sampleX, sampleY, values);
+						colors[s] = setup.Shade(values, sampleX, sampleY);
+					}
+				}
+				frameBuffer->BlendSamples(x, y, colors, mask);
+				counts.shades += covered;
+			}
+			else
+			{
+				frameBuffer->BlendSamples(x, y, setup.Shade(values, shadeX, shadeY), mask);
+				++counts.shades;
+			}
+			++counts.pixels;
+		}
+	}
+
+	// Narrows the pixel offsets [first, last] to those whose image coordinate start + i * step is within 0..size
+	void NarrowToImage(float start, float step, int size, float& first, float& last)
+	{
+		if (step == 0.0f)
+		{
+			if (start < 0.0f || start > size)
+				last = first - 1.0f;
+			return;
+		}
+
+		float low = -start / step;
+		float high = (size - start) / step;
+		if (step < 0.0f)
+			std::swap(low, high);
+		first = X::Math::Max(first, low);
+		last = X::Math::Min(last, high);
+	}
+
+	// Bilinearly samples count pixels along a line through the image, clamping to its edges. Texel positions
+	// are 16.16 fixed point with texel centers at whole numbers, so every pixel only adds the steps.
+	// Weights have 8 bits, the SSE2 path blends two pixels per register in 16 bit lanes with the same rounding.
+	void SampleImageRow(const Image& image, int32_t u, int32_t v, int32_t du, int32_t dv, int count, uint32_t* colors)
+	{
+		const int maxX = image.width - 1;
+		const int maxY = image.height - 1;
+		const uint32_t* pixels = image.pixels.data();
+
+		struct Footprint
+		{
+			uint32_t t00, t10, t01, t11;
+			uint32_t fx, fy;
+		};
+
+		auto fetch = [&](int32_t texelU, int32_t texelV)
+		{
+			const int x = texelU >> 16;
+			const int y = texelV >> 16;
+			const int x0 = X::Math::Clamp(x, 0, maxX);
+			const int x1 = X::Math::Clamp(x + 1, 0, maxX);
+			const uint32_t* row0 = pixels + X::Math::Clamp(y, 0, maxY) * image.width;
+			const uint32_t* row1 = pixels + X::Math::Clamp(y + 1, 0, maxY) * image.width;
+			return Footprint{ row0[x0], row0[x1], row1[x0], row1[x1], static_cast<uint32_t>(texelU >> 8) & 0xff, static_cast<uint32_t>(texelV >> 8) & 0xff };
+		};
+
+		int i = 0;
+#if PIX_SSE
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i full = _mm_set1_epi16(256);
+		const __m128i half = _mm_set1_epi16(128);
+		for (; i + 2 <= count; i += 2)
+		{
+			const Footprint a = fetch(u, v);
+			const Footprint b = fetch(u + du, v + dv);
+			u += 2 * du;
+			v += 2 * dv;
+
+			// Left texels of both pixels in one register, right texels in the other, top rows in the low halves
+			const __m128i left = _mm_setr_epi32(static_cast<int>(a.t00), static_cast<int>(b.t00), static_cast<int>(a.t01), static_cast<int>(b.t01));
+			const __m128i right = _mm_setr_epi32(static_cast<int>(a.t10), static_cast<int>(b.t10), static_cast<int>(a.t11), static_cast<int>(b.t11));
+			const __m128i fx = _mm_setr_epi16(a.fx, a.fx, a.fx, a.fx, b.fx, b.fx, b.fx, b.fx);
+			const __m128i fy = _mm_setr_epi16(a.fy, a.fy, a.fy, a.fy, b.fy, b.fy, b.fy, b.fy);
+			const __m128i fxInverse = _mm_sub_epi16(full, fx);
+			const __m128i fyInverse = _mm_sub_epi16(full, fy);
+
+			// 255 * 256 + 128 still fits an unsigned 16 bit lane
+			__m128i top = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(left, zero), fxInverse), _mm_mullo_epi16(_mm_unpacklo_epi8(right, zero), fx));
+			__m128i bottom = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(left, zero), fxInverse), _mm_mullo_epi16(_mm_unpackhi_epi8(right, zero), fx));
+			top = _mm_srli_epi16(_mm_add_epi16(top, half), 8);
+			bottom = _mm_srli_epi16(_mm_add_epi16(bottom, half), 8);
+			__m128i result = _mm_add_epi16(_mm_mullo_epi16(top, fyInverse), _mm_mullo_epi16(bottom, fy));
+			result = _mm_srli_epi16(_mm_add_epi16(result, half), 8);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(colors + i), _mm_packus_epi16(result, result));
+		}
+#endif
+		for (; i < count; ++i)
+		{
+			const Footprint f = fetch(u, v);
+			u += du;
+			v += dv;
+
+			uint32_t color = 0;
+			for (int shift = 0; shift < 32; shift += 8)
+			{
+				const uint32_t top = (((f.t00 >> shift) & 0xff) * (256 - f.fx) + ((f.t10 >> shift) & 0xff) * f.fx + 128) >> 8;
+				const uint32_t bottom = (((f.t01 >> shift) & 0xff) * (256 - f.fx) + ((f.t11 >> shift) & 0xff) * f.fx + 128) >> 8;
+				color |= ((top * (256 - f.fy) + bottom * f.fy + 128) >> 8) << shift;
+			}
+			colors[i] = color;
+		}
+	}
+}
+
 Rasterizer* Rasterizer::Get()
 {
 	static Rasterizer sInstance;
 	return &sInstance;
 }
 
-void Rasterizer::SetColor(X::Color color)
+void Rasterizer::OnNewFrame()
 {
-	mColor = color;
+	mShadeMode = ShadeMode::Flat;
+	mTexture = nullptr;
+	mTextureFilter = TextureFilter::Bilinear;
+	mGradient = Gradient();
+	mAntiAliasing = AntiAliasing::None;
+	mPixelCount = 0;
+	mTexelCount = 0;
+	mShapeStats = {};
+}
+
+void Rasterizer::SetColor(const X::Color& color)
+{
+	mColor = Blend::PackPremultiplied(color);
+}
+
+void Rasterizer::SetShadeMode(ShadeMode shadeMode)
+{
+	mShadeMode = shadeMode;
+}
+
+void Rasterizer::SetTexture(const Texture* texture)
+{
+	mTexture = texture;
+}
+
+void Rasterizer::SetTextureFilter(TextureFilter filter)
+{
+	mTextureFilter = filter;
+}
+
+void Rasterizer::SetLinearGradient(const Vector2& from, const Vector2& to)
+{
+	mGradient.ClearStops();
+	mGradient.SetLinear(from, to);
+}
+
+void Rasterizer::SetRadialGradient(const Vector2& center, float radius)
+{
+	mGradient.ClearStops();
+	mGradient.SetRadial(center, radius);
+}
+
+void Rasterizer::AddGradientStop(float offset, const X::Color& color)
+{
+	mGradient.AddStop(offset, Blend::PackPremultiplied(color));
+}
+
+void Rasterizer::SetAntiAliasing(AntiAliasing antiAliasing)
+{
+	mAntiAliasing = antiAliasing;
+	FrameBuffer::Get()->SetSampleCount(GetSampleCount(antiAliasing));
 }
 
 void Rasterizer::DrawPoint(int x, int y)
 {
-	X::DrawPixel(x, y, mColor);
+	FrameBuffer::Get()->BlendPixel(x, y, mColor);
+	++mPixelCount;
+}
+
+void Rasterizer::DrawPoint(int x, int y, float z, uint32_t color)
+{
+	DepthBuffer* depthBuffer = DepthBuffer::Get();
+	if (depthBuffer->IsDepthTest() && !depthBuffer->CheckDepth(x, y, z))
+		return;
+
+	FrameBuffer::Get()->BlendPixel(x, y, color);
+	++mPixelCount;
+}
+
+void Rasterizer::DrawLine(const Vertex& v0, const Vertex& v1)
+{
+	// Bresenham between the rounded end points, both already inside the clip rect
+	int x0 = static_cast<int>(std::round(v0.pos.x));
+	int y0 = static_cast<int>(std::round(v0.pos.y));
+	const int x1 = static_cast<int>(std::round(v1.pos.x));
+	const int y1 = static_cast<int>(std::round(v1.pos.y));
+
+	const int dx = std::abs(x1 - x0);
+	const int dy = -std::abs(y1 - y0);
+	const int stepX = x0 < x1 ? 1 : -1;
+	const int stepY = y0 < y1 ? 1 : -1;
+	int error = dx + dy;
+
+	// Step depth and color once per pixel along the major axis
+	DepthBuffer* depthBuffer = DepthBuffer::Get();
+	FrameBuffer* frameBuffer = FrameBuffer::Get();
+	const bool depthTest = depthBuffer->IsDepthTest();
+	const int steps = X::Math::Max(dx, -dy);
+	const float t = steps > 0 ? 1.0f / steps : 0.0f;
+	const float dz = (v1.pos.z - v0.pos.z) * t;
+	const bool flat = mShadeMode == ShadeMode::Flat;
+	X::Color color = Blend::UnpackColor(v0.color);
+	const X::Color dcolor = flat ? X::Color() : (Blend::UnpackColor(v1.color) - color) * t;
+	float z = v0.pos.z;
+
+	while (true)
+	{
+		if (!depthTest || depthBuffer->CheckDepth(x0, y0, z))
+		{
+			frameBuffer->BlendPixel(x0, y0, flat ? v0.color : Blend::PackColor(color));
+			++mPixelCount;
+		}
+		if (x0 == x1 && y0 == y1)
+			break;
+
+		z += dz;
+		color += dcolor;
+
+		const int error2 = error * 2;
+		if (error2 >= dy)
+		{
+			error += dy;
+			x0 += stepX;
+		}
+		if (error2 <= dx)
+		{
+			error += dx;
+			y0 += stepY;
+		}
+	}
+}
+
+void Rasterizer::DrawFilledTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2)
+{
+	const Vertex* a = &v0;
+	const Vertex* b = &v1;
+	const Vertex* c = &v2;
+
+	// Wind the triangle so the inside is positive for all edges, skip degenerates
+	float area = (b->pos.x - a->pos.x) * (c->pos.y - a->pos.y) - (b->pos.y - a->pos.y) * (c->pos.x - a->pos.x);
+	if (area == 0.0f)
+		return;
+	if (area < 0.0f)
+	{
+		std::swap(b, c);
+		area = -area;
+	}
+
+	const Vector3& p0 = a->pos;
+	const Vector3& p1 = b->pos;
+	const Vector3& p2 = c->pos;
+	const Edge edges[] = { Edge(p0, p1), Edge(p1, p2), Edge(p2, p0) };
+
+	// Scissor the bounding box against the clip rect once, guard band triangles rely on this.
+	// Samples reach up to half a pixel past the pixel centers.
+	const ClipRect rect = Clipper::Get()->GetClipRect();
+	const float margin = mAntiAliasing == AntiAliasing::None ? 0.0f : 0.5f;
+	const int minX = X::Math::Max(rect.minX, static_cast<int>(std::ceil(X::Math::Min(p0.x, X::Math::Min(p1.x, p2.x)) - margin)));
+	const int maxX = X::Math::Min(rect.maxX, static_cast<int>(std::floor(X::Math::Max(p0.x, X::Math::Max(p1.x, p2.x)) + margin)));
+	const int minY = X::Math::Max(rect.minY, static_cast<int>(std::ceil(X::Math::Min(p0.y, X::Math::Min(p1.y, p2.y)) - margin)));
+	const int maxY = X::Math::Min(rect.maxY, static_cast<int>(std::floor(X::Math::Max(p0.y, X::Math::Max(p1.y, p2.y)) + margin)));
+	if (minX > maxX || minY > maxY)
+		return;
+
+	const TriangleSetup setup(*a, *b, *c, area, mShadeMode, mTexture, mTextureFilter, &mGradient);
+
+	if (mAntiAliasing != AntiAliasing::None)
+	{
+		const SampleEdges samples(edges, mAntiAliasing);
+		const bool supersample = mAntiAliasing == AntiAliasing::Supersample4x;
+		SampleCounts counts;
+		for (int y = minY; y <= maxY; ++y)
+			DrawMultisampledRow(setup, samples, minX, maxX, y, supersample, counts);
+
+		mPixelCount += counts.pixels;
+		mTexelCount += static_cast<uint64_t>(counts.shades) * setup.texelsPerPixel;
+		return;
+	}
+
+	DepthBuffer* depthBuffer = DepthBuffer::Get();
+	if (!depthBuffer->IsDepthTest())
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			// Clip the span once per row, the inner loop needs no tests
+			int xStart = minX;
+			int xEnd = maxX;
+			for (const Edge& edge : edges)
+				ClipSpan(edge, y, xStart, xEnd);
+
+			AddPixels(DrawSpan(setup, xStart, xEnd, y, SpanDepth::None), setup.texelsPerPixel);
+		}
+		return;
+	}
+
+	const float minZ = X::Math::Min(p0.z, X::Math::Min(p1.z, p2.z));
+	const float maxZ = X::Math::Max(p0.z, X::Math::Max(p1.z, p2.z));
+
+	const int kTileSize = DepthBuffer::kTileSize;
+	const int tileMinX = minX / kTileSize;
+	const int tileMaxX = maxX / kTileSize;
+
+	DepthBuffer::Stats& stats = depthBuffer->GetStats();
+	const SpanDepth acceptedDepth = depthBuffer->IsDepthWrite() ? SpanDepth::Write : SpanDepth::None;
+
+	static std::vector<DepthBuffer::TileResult> sTileResults;
+	int tileY = -1;
+	for (int y = minY; y <= maxY; ++y)
+	{
+		// Classify the tiles of this tile row against the triangle depth range
+		if (y / kTileSize != tileY)
+		{
+			tileY = y / kTileSize;
+			sTileResults.clear();
+			for (int tileX = tileMinX; tileX <= tileMaxX; ++tileX)
+				sTileResults.push_back(depthBuffer->TestTile(tileX, tileY, minZ, maxZ));
+		}
+
+		int xStart = minX;
+		int xEnd = maxX;
+		for (const Edge& edge : edges)
+			ClipSpan(edge, y, xStart, xEnd);
+
+		// Walk the span one tile segment at a time
+		int x = xStart;
+		while (x <= xEnd)
+		{
+			const int tileX = x / kTileSize;
+			const int segmentEnd = X::Math::Min(xEnd, (tileX + 1) * kTileSize - 1);
+
+			switch (sTileResults[tileX - tileMinX])
+			{
+			case DepthBuffer::TileResult::Culled:
+			{
+				const int count = segmentEnd - x + 1;
+				stats.pixelsTested += count;
+				stats.pixelsTileCulled += count;
+				break;
+			}
+			case DepthBuffer::TileResult::Accepted:
+			{
+				stats.pixelsTested += segmentEnd - x + 1;
+				AddPixels(DrawSpan(setup, x, segmentEnd, y, acceptedDepth), setup.texelsPerPixel);
+				break;
+			}
+			case DepthBuffer::TileResult::Test:
+			{
+				AddPixels(DrawSpan(setup, x, segmentEnd, y, SpanDepth::Test), setup.texelsPerPixel);
+				break;
+			}
+			}
+
+			x = segmentEnd + 1;
+		}
+	}
+}
+
+void Rasterizer::FloodFill(int x, int y, bool eightConnected)
+{
+	mPixelCount += FrameBuffer::Get()->FloodFill(x, y, mColor, eightConnected, Clipper::Get()->GetClipRect());
+}
+
+void Rasterizer::DrawImage(const Image& image, float x, float y, float scale, float rotation)
+{
+	const ClipRect clip = Clipper::Get()->GetClipRect();
+	if (clip.IsEmpty() || image.width <= 0 || image.height <= 0 || scale <= 0.0f)
+		return;
+
+	FrameBuffer* frameBuffer = FrameBuffer::Get();
+
+	// Unscaled and unrotated images blend their rows straight from the cache, opaque runs are copies
+	if (scale == 1.0f && rotation == 0.0f)
+	{
+		const int left = static_cast<int>(std::floor(x + 0.5f));
+		const int top = static_cast<int>(std::floor(y + 0.5f));
+		const int minX = X::Math::Max(left, clip.minX);
+		const int maxX = X::Math::Min(left + image.width - 1, clip.maxX);
+		const int minY = X::Math::Max(top, clip.minY);
+		const int maxY = X::Math::Min(top + image.height - 1, clip.maxY);
+		if (minX > maxX || minY > maxY)
+			return;
+
+		for (int row = minY; row <= maxY; ++row)
+			frameBuffer->BlendSpan(minX, row, &image.pixels[(row - top) * image.width + (minX - left)], maxX - minX + 1);
+		AddPixels((maxX - minX + 1) * (maxY - minY + 1), 1);
+		return;
+	}
+
+	// Scaled and rotated about the image center, the rotation in degrees
+	const float radians = rotation * X::Math::kDegToRad;
+	const float cosine = std::cos(radians);
+	const float sine = std::sin(radians);
+	const float halfWidth = image.width * 0.5f;
+	const float halfHeight = image.height * 0.5f;
+	const float centerX = x + halfWidth * scale;
+	const float centerY = y + halfHeight * scale;
+
+	// Bounds of the rotated corners
+	const float extentX = (std::abs(cosine) * halfWidth + std::abs(sine) * halfHeight) * scale;
+	const float extentY = (std::abs(sine) * halfWidth + std::abs(cosine) * halfHeight) * scale;
+	const int minX = X::Math::Max(static_cast<int>(std::floor(centerX - extentX)), clip.minX);
+	const int maxX = X::Math::Min(static_cast<int>(std::ceil(centerX + extentX)), clip.maxX);
+	const int minY = X::Math::Max(static_cast<int>(std::floor(centerY - extentY)), clip.minY);
+	const int maxY = X::Math::Min(static_cast<int>(std::ceil(centerY + extentY)), clip.maxY);
+	if (minX > maxX || minY > maxY)
+		return;
+
+	// Inverse mapping from pixel centers to image coordinates, one step per pixel along a row
+	const float inverseScale = 1.0f / scale;
+	const float stepU = cosine * inverseScale;
+	const float stepV = -sine * inverseScale;
+	const float kFixedOne = 65536.0f;
+
+	static std::vector<uint32_t> sColors;
+	sColors.resize(maxX - minX + 1);
+	uint32_t pixelCount = 0;
+	for (int row = minY; row <= maxY; ++row)
+	{
+		const float dx = minX + 0.5f - centerX;
+		const float dy = row + 0.5f - centerY;
+		const float u = halfWidth + (cosine * dx + sine * dy) * inverseScale;
+		const float v = halfHeight + (cosine * dy - sine * dx) * inverseScale;
+
+		// Only the pixels whose center lands on the image
+		float first = 0.0f;
+		float last = static_cast<float>(maxX - minX);
+		NarrowToImage(u, stepU, image.width, first, last);
+		NarrowToImage(v, stepV, image.height, first, last);
+		const int start = static_cast<int>(std::ceil(first));
+		const int end = static_cast<int>(std::floor(last));
+		if (start > end)
+			continue;
+
+		// Texel centers sit at half coordinates
+		const float startU = u + start * stepU - 0.5f;
+		const float startV = v + start * stepV - 0.5f;
+		const int count = end - start + 1;
+		SampleImageRow(image,
+			static_cast<int32_t>(std::floor(startU * kFixedOne)),
+			static_cast<int32_t>(std::floor(startV * kFixedOne)),
+			static_cast<int32_t>(std::floor(stepU * kFixedOne)),
+			static_cast<int32_t>(std::floor(stepV * kFixedOne)),
+			count,
+			sColors.data());
+		frameBuffer->BlendSpan(minX + start, row, sColors.data(), count);
+		pixelCount += count;
+	}
+	AddPixels(pixelCount, 4);
+}
+
+void Rasterizer::DrawShape(const Shape& shape)
+{
+	const ClipRect clip = Clipper::Get()->GetClipRect();
+	if (clip.IsEmpty())
+		return;
+
+	float left, top, right, bottom;
+	shape.GetBounds(left, top, right, bottom);
+	const int minX = X::Math::Max(static_cast<int>(std::ceil(left)), clip.minX);
+	const int maxX = X::Math::Min(static_cast<int>(std::floor(right)), clip.maxX);
+	const int minY = X::Math::Max(static_cast<int>(std::ceil(top)), clip.minY);
+	const int maxY = X::Math::Min(static_cast<int>(std::floor(bottom)), clip.maxY);
+	++mShapeStats.shapes;
+	if (minX > maxX || minY > maxY)
+		return;
+
+	enum class TileClass : uint8_t
+	{
+		Empty,	// Every pixel is more than half a pixel outside
+		Solid,	// Every pixel is more than half a pixel inside
+		Edge
+	};
+
+	// Tiles are classified from the distance at their center, which is within the distance to their farthest
+	// pixel of every pixel's distance. Only edge tiles evaluate the distance per pixel.
+	const int kTileSize = 8;
+	const int tilesX = (maxX - minX) / kTileSize + 1;
+	static std::vector<TileClass> sTileClasses;
+	static std::vector<uint32_t> sColors;
+	sTileClasses.resize(tilesX);
+	sColors.resize(maxX - minX + 1);
+
+	FrameBuffer* frameBuffer = FrameBuffer::Get();
+	const bool gradient = mShadeMode == ShadeMode::Gradient && mGradient.HasStops();
+	uint32_t pixelCount = 0;
+	for (int tileTop = minY; tileTop <= maxY; tileTop += kTileSize)
+	{
+		const int tileBottom = X::Math::Min(tileTop + kTileSize - 1, maxY);
+		for (int tile = 0; tile < tilesX; ++tile)
+		{
+			const int tileLeft = minX + tile * kTileSize;
+			const int tileRight = X::Math::Min(tileLeft + kTileSize - 1, maxX);
+			const float halfWidth = (tileRight - tileLeft) * 0.5f;
+			const float halfHeight = (tileBottom - tileTop) * 0.5f;
+			const float reach = std::sqrt(halfWidth * halfWidth + halfHeight * halfHeight);
+			const float distance = shape.Distance(tileLeft + halfWidth, tileTop + halfHeight);
+			if (distance - reach >= 0.5f)
+			{
+				sTileClasses[tile] = TileClass::Empty;
+			}
+			else if (distance + reach <= -0.5f)
+			{
+				sTileClasses[tile] = TileClass::Solid;
+				++mShapeStats.solidTiles;
+			}
+			else
+			{
+				sTileClasses[tile] = TileClass::Edge;
+				++mShapeStats.edgeTiles;
+			}
+		}
+
+		for (int y = tileTop; y <= tileBottom; ++y)
+		{
+			// Each run of tiles that are not empty is one span, solid tiles are plain fills
+			int tile = 0;
+			while (tile < tilesX)
+			{
+				if (sTileClasses[tile] == TileClass::Empty)
+				{
+					++tile;
+					continue;
+				}
+
+				const int runStart = minX + tile * kTileSize;
+				int runEnd = runStart;
+				for (; tile < tilesX && sTileClasses[tile] != TileClass::Empty; ++tile)
+					runEnd = X::Math::Min(minX + (tile + 1) * kTileSize - 1, maxX);
+
+				// Fill the run, then fade the edge tiles by their coverage
+				uint32_t* runColors = &sColors[runStart - minX];
+				if (gradient)
+					mGradient.ShadeSpan(runStart, y, runEnd - runStart + 1, runColors);
+				else
+					std::fill(runColors, runColors + runEnd - runStart + 1, mColor);
+				for (int tileLeft = runStart; tileLeft <= runEnd; tileLeft += kTileSize)
+				{
+					if (sTileClasses[(tileLeft - minX) / kTileSize] == TileClass::Edge)
+						shape.Cover(tileLeft, y, X::Math::Min(kTileSize, runEnd - tileLeft + 1), &sColors[tileLeft - minX]);
+				}
+
+				// Edge tiles at the ends can start and end with uncovered pixels
+				int start = runStart;
+				int end = runEnd;
+				while (start <= end && sColors[start - minX] == 0)
+					++start;
+				while (end >= start && sColors[end - minX] == 0)
+					--end;
+				if (start <= end)
+				{
+					frameBuffer->BlendSpan(start, y, &sColors[start - minX], end - start + 1);
+					pixelCount += end - start + 1;
+				}
+			}
+		}
+	}
+	AddPixels(pixelCount, 0);
+}
+
+void Rasterizer::AddPixels(uint32_t pixelCount, uint32_t texelsPerPixel)
+{
+	mPixelCount += pixelCount;
+	mTexelCount += pixelCount * texelsPerPixel;
 }
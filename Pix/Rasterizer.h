@@ -1,17 +1,102 @@
 #pragma once
 
+#include "Blend.h"
+#include "Gradient.h"
+#include "Texture.h"
+#include "Vertex.h"
+
 #include <XEngine.h>
 
+struct Image;
+struct Shape;
+
+enum class ShadeMode
+{
+	Flat,
+	Gouraud,
+	TexCoord,
+	Texture,
+	Gradient
+};
+
+enum class AntiAliasing
+{
+	None,
+	Coverage4x,		// 4 coverage samples, shaded once per pixel
+	Coverage8x,		// 8 coverage samples, shaded once per pixel
+	Supersample4x	// 4 samples each shaded, the quality reference for coverage
+};
+
 class Rasterizer
 {
 public:
 	static Rasterizer* Get();
 
 public:
-	void SetColor(X::Color color);
+	void OnNewFrame();
+
+	// Converted once to packed premultiplied RGBA8, components are clamped to 0..1
+	void SetColor(const X::Color& color);
+	uint32_t GetColor() const { return mColor; }
+
+	void SetShadeMode(ShadeMode shadeMode);
+	ShadeMode GetShadeMode() const { return mShadeMode; }
+
+	// Texture used by the texture shade mode, owned by the TextureCache
+	void SetTexture(const Texture* texture);
+	void SetTextureFilter(TextureFilter filter);
 
+	// Gradient used by the gradient shade mode for triangles and shapes, in screen pixels. Setting the start and
+	// end or the center and radius starts a new gradient without stops, drawing falls back to flat shading until one
+	// is added. Stop colors are premultiplied and converted like SetColor.
+	void SetLinearGradient(const Vector2& from, const Vector2& to);
+	void SetRadialGradient(const Vector2& center, float radius);
+	void AddGradientStop(float offset, const X::Color& color);
+
+	// Only triangle edges are anti-aliased, lines and points blend into every sample
+	void SetAntiAliasing(AntiAliasing antiAliasing);
+	AntiAliasing GetAntiAliasing() const { return mAntiAliasing; }
+
+	struct ShapeStats
+	{
+		uint32_t shapes = 0;
+		uint32_t solidTiles = 0;	// Filled without evaluating the distance per pixel
+		uint32_t edgeTiles = 0;
+	};
+
+	// Pixels written and texels read since the start of the frame
+	uint32_t GetPixelCount() const { return mPixelCount; }
+	uint64_t GetTexelCount() const { return mTexelCount; }
+	const ShapeStats& GetShapeStats() const { return mShapeStats; }
+
+	// Primitives must already be clipped, no bounds checks are done per pixel
 	void DrawPoint(int x, int y);
+	void DrawPoint(int x, int y, float z, uint32_t color);
+	void DrawLine(const Vertex& v0, const Vertex& v1);
+	void DrawFilledTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2);
+
+	// Fills the region around (x, y) already drawn in one color with the current color, bounded by the clip rect
+	void FloodFill(int x, int y, bool eightConnected);
+
+	// Blends an image with its top left corner at (x, y), scaled and then rotated in degrees about its center.
+	// Bounded by the clip rect and drawn without depth. Transformed images are sampled bilinearly.
+	void DrawImage(const Image& image, float x, float y, float scale, float rotation);
+
+	// Fills a signed distance shape with the current color, or the gradient in the gradient shade mode, and
+	// anti-aliased edges, bounded by the clip rect.
+	// The cost follows the length of the edges, 8x8 pixel tiles inside or outside the shape take no evaluation.
+	void DrawShape(const Shape& shape);
 
 private:
-	X::Color mColor = X::Colors::White;
+	void AddPixels(uint32_t pixelCount, uint32_t texelsPerPixel);
+
+	uint32_t mColor = 0xffffffff;
+	ShadeMode mShadeMode = ShadeMode::Flat;
+	const Texture* mTexture = nullptr;
+	TextureFilter mTextureFilter = TextureFilter::Bilinear;
+	Gradient mGradient;
+	AntiAliasing mAntiAliasing = AntiAliasing::None;
+	uint32_t mPixelCount = 0;
+	uint64_t mTexelCount = 0;
+	ShapeStats mShapeStats;
 };
\ No newline at end of file
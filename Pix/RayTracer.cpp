@@ -0,0 +1,708 @@
+#include "RayTracer.h"
+
+#include "AccumulationBuffer.h"
+#include "Blend.h"
+#include "Camera.h"
+#include "Clipper.h"
+#include "FrameBuffer.h"
+#include "MathHelper.h"
+#include "MatrixStack.h"
+#include "Rasterizer.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+#include "Viewport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	const int kTileSize = 16;
+	const int kBinCount = 16;
+	const int kMaxLeafSize = 4;
+	const int kStackSize = 64;
+
+	// Each level of the tree leaves one more node on the traversal stack. Below kMedianDepth nodes split at
+	// the median, which halves them whatever the scene, and kMaxDepth ends the tree before the stack is full.
+	const int kMedianDepth = kStackSize / 2;
+	const int kMaxDepth = kStackSize - 2;
+
+	// Traversing a node costs about as much as testing one primitive
+	const float kTraversalCost = 1.0f;
+
+	// Hits closer than this are the surface the ray started from
+	const float kHitEpsilon = 1e-4f;
+	const float kAmbient = 0.25f;
+
+	const uint32_t kNoHit = 0xffffffff;
+	const uint32_t kPlaneBit = 0x80000000;
+
+	// Fixed directional light, points towards the light
+	const Vector3 kLightDirection = MathHelper::Normalize(Vector3(-0.4f, 0.8f, -0.45f));
+
+	const float kMaxDistance = std::numeric_limits<float>::max();
+
+	// Four floats, one per ray of a packet
+#if PIX_SSE
+	struct Float4
+	{
+		__m128 v;
+
+		Float4() = default;
+		Float4(__m128 v) : v(v) {}
+		Float4(float s) : v(_mm_set1_ps(s)) {}
+	};
+
+	// Lanes are all bits set or all clear
+	struct Mask4
+	{
+		__m128 v;
+	};
+
+	Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.v, b.v); }
+	Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.v, b.v); }
+	Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.v, b.v); }
+	Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.v, b.v); }
+	Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a.v, b.v); }
+	Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a.v, b.v); }
+	Float4 Sqrt(Float4 a) { return _mm_sqrt_ps(a.v); }
+	Float4 Set(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+	float Lane(Float4 a, int i) { alignas(16) float values[4]; _mm_store_ps(values, a.v); return values[i]; }
+
+	Mask4 operator<(Float4 a, Float4 b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+	Mask4 operator>(Float4 a, Float4 b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+	Mask4 operator<=(Float4 a, Float4 b) { return { _mm_cmple_ps(a.v, b.v) }; }
+	Mask4 operator>=(Float4 a, Float4 b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+	Mask4 operator&(Mask4 a, Mask4 b) { return { _mm_and_ps(a.v, b.v) }; }
+	Mask4 AndNot(Mask4 a, Mask4 b) { return { _mm_andnot_ps(b.v, a.v) }; }
+	Mask4 MaskFromBits(int bits) { return { _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_and_si128(_mm_set1_epi32(bits), _mm_setr_epi32(1, 2, 4, 8)), _mm_setzero_si128())) }; }
+	int Bits(Mask4 m) { return _mm_movemask_ps(m.v); }
+	Float4 Select(Mask4 m, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v)); }
+#else
+	struct Float4
+	{
+		float v[4];
+
+		Float4() = default;
+		Float4(float s) : v{ s, s, s, s } {}
+	};
+
+	struct Mask4
+	{
+		int bits;
+	};
+
+	template <typename Function>
+	Float4 Map(Float4 a, Float4 b, Function function)
+	{
+		Float4 result;
+		for (int i = 0; i < 4; ++i)
+			result.v[i] = function(a.v[i], b.v[i]);
+		return result;
+	}
+
+	template <typename Function>
+	Mask4 Compare(Float4 a, Float4 b, Function function)
+	{
+		Mask4 result{ 0 };
+		for (int i = 0; i < 4; ++i)
+			result.bits |= function(a.v[i], b.v[i]) ? (1 << i) : 0;
+		return result;
+	}
+
+	Float4 operator+(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return x + y; }); }
+	Float4 operator-(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return x - y; }); }
+	Float4 operator*(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return x * y; }); }
+	Float4 operator/(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return x / y; }); }
+	Float4 Min(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return x < y ? x : y; }); }
+	Float4 Max(Float4 a, Float4 b) { return Map(a, b, [](float x, float y) { return x > y ? x : y; }); }
+	Float4 Sqrt(Float4 a) { return Map(a, a, [](float x, float) { return sqrtf(x); }); }
+	Float4 Set(float a, float b, float c, float d) { Float4 result; result.v[0] = a; result.v[1] = b; result.v[2] = c; result.v[3] = d; return result; }
+	float Lane(Float4 a, int i) { return a.v[i]; }
+
+	Mask4 operator<(Float4 a, Float4 b) { return Compare(a, b, [](float x, float y) { return x < y; }); }
+	Mask4 operator>(Float4 a, Float4 b) { return Compare(a, b, [](float x, float y) { return x > y; }); }
+	Mask4 operator<=(Float4 a, Float4 b) { return Compare(a, b, [](float x, float y) { return x <= y; }); }
+	Mask4 operator>=(Float4 a, Float4 b) { return Compare(a, b, [](float x, float y) { return x >= y; }); }
+	Mask4 operator&(Mask4 a, Mask4 b) { return { a.bits & b.bits }; }
+	Mask4 AndNot(Mask4 a, Mask4 b) { return { a.bits & ~b.bits }; }
+	Mask4 MaskFromBits(int bits) { return { bits }; }
+	int Bits(Mask4 m) { return m.bits; }
+
+	Float4 Select(Mask4 m, Float4 a, Float4 b)
+	{
+		Float4 result;
+		for (int i = 0; i < 4; ++i)
+			result.v[i] = (m.bits & (1 << i)) ? a.v[i] : b.v[i];
+		return result;
+	}
+#endif
+
+	Vector3 TransformPoint(const Vector3& p, const Matrix4& m)
+	{
+		return {
+			p.x * m._11 + p.y * m._21 + p.z * m._31 + m._41,
+			p.x * m._12 + p.y * m._22 + p.z * m._32 + m._42,
+			p.x * m._13 + p.y * m._23 + p.z * m._33 + m._43 };
+	}
+
+	float GetComponent(const Vector3& v, int axis)
+	{
+		return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+	}
+
+	Vector3 Minimum(const Vector3& a, const Vector3& b)
+	{
+		return { std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z) };
+	}
+
+	Vector3 Maximum(const Vector3& a, const Vector3& b)
+	{
+		return { std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z) };
+	}
+
+	float GetHalfArea(const Vector3& min, const Vector3& max)
+	{
+		const Vector3 e = max - min;
+		return e.x * e.y + e.y * e.z + e.z * e.x;
+	}
+
+	// Bounds grown one point or box at a time, starts inside out so the first grow sets it
+	struct Extent
+	{
+		Vector3 min = Vector3(kMaxDistance);
+		Vector3 max = Vector3(-kMaxDistance);
+		int count = 0;
+
+		void Grow(const Vector3& p) { min = Minimum(min, p); max = Maximum(max, p); }
+		void Grow(const Vector3& boxMin, const Vector3& boxMax) { min = Minimum(min, boxMin); max = Maximum(max, boxMax); }
+		float GetHalfArea() const { return count > 0 ? ::GetHalfArea(min, max) : 0.0f; }
+	};
+
+	uint32_t Shade(uint32_t color, float light)
+	{
+		const X::Color c = Blend::UnpackColor(color);
+		return Blend::PackColor(X::Color(c.x * light, c.y * light, c.z * light, c.w));
+	}
+}
+
+struct RayTracer::RayPacket
+{
+	Float4 ox, oy, oz;
+	Float4 dx, dy, dz;
+	Float4 ix, iy, iz;
+
+	// Lanes that take part, the rest keep their hit untouched
+	Mask4 active;
+
+	// Children are visited near first along the direction of the first ray
+	bool negative[3];
+
+	void SetDirections(Float4 x, Float4 y, Float4 z)
+	{
+		dx = x;
+		dy = y;
+		dz = z;
+
+		// Zero components would make 0 * inf in the slab test, nudge them off zero instead
+		const Float4 tiny(1e-20f);
+		const Float4 negativeTiny(-1e-20f);
+		const Float4 zero(0.0f);
+		ix = Float4(1.0f) / Select(x < zero, Min(x, negativeTiny), Max(x, tiny));
+		iy = Float4(1.0f) / Select(y < zero, Min(y, negativeTiny), Max(y, tiny));
+		iz = Float4(1.0f) / Select(z < zero, Min(z, negativeTiny), Max(z, tiny));
+		negative[0] = Lane(x, 0) < 0.0f;
+		negative[1] = Lane(y, 0) < 0.0f;
+		negative[2] = Lane(z, 0) < 0.0f;
+	}
+};
+
+struct RayTracer::HitPacket
+{
+	Float4 t = Float4(kMaxDistance);
+	uint32_t primitive[4] = { kNoHit, kNoHit, kNoHit, kNoHit };
+
+	// Lanes that hit anything, only filled in by any hit traces
+	Mask4 occluded = MaskFromBits(0);
+};
+
+RayTracer* RayTracer::Get()
+{
+	static RayTracer sInstance;
+	return &sInstance;
+}
+
+void RayTracer::OnNewFrame()
+{
+	mSpheres.clear();
+	mPlanes.clear();
+	mTriangles.clear();
+}
+
+void RayTracer::AddSphere(const Vector3& center, float radius)
+{
+	// Spheres stay round, the radius takes the scale of the x axis
+	const Matrix4& transform = MatrixStack::Get()->GetTransform();
+	const float scale = MathHelper::Magnitude(Vector3(transform._11, transform._12, transform._13));
+	mSpheres.push_back({ TransformPoint(center, transform), fabsf(radius) * scale, Rasterizer::Get()->GetColor() });
+}
+
+void RayTracer::AddTriangle(const Vector3& p0, const Vector3& p1, const Vector3& p2)
+{
+	const Matrix4& transform = MatrixStack::Get()->GetTransform();
+	const Vector3 q0 = TransformPoint(p0, transform);
+	mTriangles.push_back({ q0, TransformPoint(p1, transform) - q0, TransformPoint(p2, transform) - q0, Rasterizer::Get()->GetColor() });
+}
+
+void RayTracer::AddMesh(const Mesh& mesh)
+{
+	const Matrix4& transform = MatrixStack::Get()->GetTransform();
+	const uint32_t color = Rasterizer::Get()->GetColor();
+	mTriangles.reserve(mTriangles.size() + mesh.indices.size() / 3);
+	for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+	{
+		const Vector3 q0 = TransformPoint(mesh.vertices[mesh.indices[i]].pos, transform);
+		const Vector3 q1 = TransformPoint(mesh.vertices[mesh.indices[i + 1]].pos, transform);
+		const Vector3 q2 = TransformPoint(mesh.vertices[mesh.indices[i + 2]].pos, transform);
+		mTriangles.push_back({ q0, q1 - q0, q2 - q0, color });
+	}
+}
+
+void RayTracer::AddPlane(const Vector3& normal, float distance)
+{
+	const float length = MathHelper::Magnitude(normal);
+	if (length <= 0.0f)
+		return;
+
+	mPlanes.push_back({ normal / length, distance / length, Rasterizer::Get()->GetColor() });
+}
+
+void RayTracer::Build()
+{
+	const uint32_t triangleCount = GetTriangleCount();
+	const uint32_t count = triangleCount + static_cast<uint32_t>(mSpheres.size());
+	mPrimitives.resize(count);
+	mPrimitiveBounds.resize(count);
+	mCentroids.resize(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		Bounds& bounds = mPrimitiveBounds[i];
+		if (i < triangleCount)
+		{
+			const SceneTriangle& triangle = mTriangles[i];
+			const Vector3 p1 = triangle.p0 + triangle.edge1;
+			const Vector3 p2 = triangle.p0 + triangle.edge2;
+			bounds.min = Minimum(triangle.p0, Minimum(p1, p2));
+			bounds.max = Maximum(triangle.p0, Maximum(p1, p2));
+		}
+		else
+		{
+			const SceneSphere& sphere = mSpheres[i - triangleCount];
+			bounds.min = sphere.center - Vector3(sphere.radius);
+			bounds.max = sphere.center + Vector3(sphere.radius);
+		}
+		mPrimitives[i] = i;
+		mCentroids[i] = (bounds.min + bounds.max) * 0.5f;
+	}
+
+	mNodes.clear();
+	if (count == 0)
+		return;
+
+	mNodes.reserve(count * 2);
+	mNodes.emplace_back();
+	Subdivide(0, 0, count, 0);
+}
+
+void RayTracer::Subdivide(uint32_t nodeIndex, uint32_t first, uint32_t count, int depth)
+{
+	Extent bounds;
+	Extent centroids;
+	for (uint32_t i = first; i < first + count; ++i)
+	{
+		const Bounds& box = mPrimitiveBounds[mPrimitives[i]];
+		bounds.Grow(box.min, box.max);
+		centroids.Grow(mCentroids[mPrimitives[i]]);
+	}
+	bounds.count = static_cast<int>(count);
+
+	Node& node = mNodes[nodeIndex];
+	node.min = bounds.min;
+	node.max = bounds.max;
+	node.first = first;
+	node.count = static_cast<uint16_t>(count);
+	node.axis = 0;
+	if (count <= 1 || depth >= kMaxDepth)
+		return;
+
+	// Bin centroids along the longest axis and sweep the bins for the cheapest split
+	const Vector3 extent = centroids.max - centroids.min;
+	const int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+	const float axisMin = GetComponent(centroids.min, axis);
+	const float axisExtent = GetComponent(extent, axis);
+
+	int bestSplit = -1;
+	float bestCost = kMaxDistance;
+	if (axisExtent > 0.0f)
+	{
+		const float binScale = kBinCount / axisExtent;
+		Extent bins[kBinCount];
+		for (uint32_t i = first; i < first + count; ++i)
+		{
+			const uint32_t primitive = mPrimitives[i];
+			const int bin = std::min(static_cast<int>((GetComponent(mCentroids[primitive], axis) - axisMin) * binScale), kBinCount - 1);
+			bins[bin].Grow(mPrimitiveBounds[primitive].min, mPrimitiveBounds[primitive].max);
+			++bins[bin].count;
+		}
+
+		float rightCosts[kBinCount];
+		Extent right;
+		for (int i = kBinCount - 1; i > 0; --i)
+		{
+			right.Grow(bins[i].min, bins[i].max);
+			right.count += bins[i].count;
+			rightCosts[i] = right.GetHalfArea() * right.count;
+		}
+
+		Extent left;
+		for (int i = 0; i < kBinCount - 1; ++i)
+		{
+			left.Grow(bins[i].min, bins[i].max);
+			left.count += bins[i].count;
+			const float cost = left.GetHalfArea() * left.count + rightCosts[i + 1];
+			if (left.count > 0 && left.count < static_cast<int>(count) && cost < bestCost)
+			{
+				bestCost = cost;
+				bestSplit = i;
+			}
+		}
+
+		// Split costs are relative to the area of this node, as is the traversal
+		bestCost = kTraversalCost + bestCost / bounds.GetHalfArea();
+	}
+
+	// Keep a leaf when splitting costs more than testing everything, unless the leaf would be too big
+	const bool splitPays = bestSplit >= 0 && bestCost < static_cast<float>(count);
+	if (!splitPays && count <= static_cast<uint32_t>(kMaxLeafSize))
+		return;
+
+	uint32_t middle = first;
+	if (bestSplit >= 0 && depth < kMedianDepth)
+	{
+		const float binScale = kBinCount / axisExtent;
+		auto begin = mPrimitives.begin() + first;
+		middle = first + static_cast<uint32_t>(std::partition(begin, begin + count, [&](uint32_t primitive)
+		{
+			const int bin = std::min(static_cast<int>((GetComponent(mCentroids[primitive], axis) - axisMin) * binScale), kBinCount - 1);
+			return bin <= bestSplit;
+		}) - begin);
+	}
+	else
+	{
+		// Deep nodes, and nodes with every centroid in the same spot, are halved to keep the tree shallow
+		middle = first + count / 2;
+		auto begin = mPrimitives.begin() + first;
+		std::nth_element(begin, mPrimitives.begin() + middle, begin + count, [&](uint32_t a, uint32_t b)
+		{
+			return GetComponent(mCentroids[a], axis) < GetComponent(mCentroids[b], axis);
+		});
+	}
+
+	// Children sit next to each other so the parent only needs the index of the first
+	const uint32_t leftIndex = static_cast<uint32_t>(mNodes.size());
+	mNodes.emplace_back();
+	mNodes.emplace_back();
+	Node& parent = mNodes[nodeIndex];
+	parent.first = leftIndex;
+	parent.count = 0;
+	parent.axis = static_cast<uint16_t>(axis);
+
+	Subdivide(leftIndex, first, middle - first, depth + 1);
+	Subdivide(leftIndex + 1, middle, first + count - middle, depth + 1);
+}
+
+template <bool kAnyHit>
+void RayTracer::Trace(const RayPacket& rays, HitPacket& hits) const
+{
+	const uint32_t triangleCount = GetTriangleCount();
+	const Float4 epsilon(kHitEpsilon);
+	const Float4 zero(0.0f);
+	const Float4 one(1.0f);
+	Mask4 active = rays.active;
+
+	// Records the lanes in hit, any hit traces drop them from the rest of the search
+	auto recordHit = [&](Mask4 hit, Float4 t, uint32_t primitive)
+	{
+		const int bits = Bits(hit);
+		if (bits == 0)
+			return;
+
+		if (kAnyHit)
+		{
+			hits.occluded = MaskFromBits(Bits(hits.occluded) | bits);
+			active = AndNot(active, hit);
+			return;
+		}
+
+		hits.t = Select(hit, t, hits.t);
+		for (int i = 0; i < 4; ++i)
+		{
+			if (bits & (1 << i))
+				hits.primitive[i] = primitive;
+		}
+	};
+
+	for (uint32_t i = 0; i < static_cast<uint32_t>(mPlanes.size()) && Bits(active) != 0; ++i)
+	{
+		const ScenePlane& plane = mPlanes[i];
+		const Float4 nx(plane.normal.x), ny(plane.normal.y), nz(plane.normal.z);
+		const Float4 denom = nx * rays.dx + ny * rays.dy + nz * rays.dz;
+		const Float4 t = (Float4(plane.distance) - (nx * rays.ox + ny * rays.oy + nz * rays.oz)) / denom;
+		recordHit(active & (t > epsilon) & (t < hits.t), t, kPlaneBit | i);
+	}
+
+	if (mNodes.empty())
+		return;
+
+	// Nodes stop at kMaxDepth, so the stack never holds more than kMaxDepth + 1 of them
+	uint32_t stack[kStackSize];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0 && Bits(active) != 0)
+	{
+		const Node& node = mNodes[stack[--top]];
+
+		// Slab test against the box for every lane still looking
+		const Float4 tx0 = (Float4(node.min.x) - rays.ox) * rays.ix;
+		const Float4 tx1 = (Float4(node.max.x) - rays.ox) * rays.ix;
+		const Float4 ty0 = (Float4(node.min.y) - rays.oy) * rays.iy;
+		const Float4 ty1 = (Float4(node.max.y) - rays.oy) * rays.iy;
+		const Float4 tz0 = (Float4(node.min.z) - rays.oz) * rays.iz;
+		const Float4 tz1 = (Float4(node.max.z) - rays.oz) * rays.iz;
+		const Float4 tEnter = Max(Max(Min(tx0, tx1), Min(ty0, ty1)), Max(Min(tz0, tz1), zero));
+		const Float4 tExit = Min(Min(Max(tx0, tx1), Max(ty0, ty1)), Min(Max(tz0, tz1), hits.t));
+		const Mask4 inside = active & (tEnter <= tExit);
+		if (Bits(inside) == 0)
+			continue;
+
+		if (node.count == 0)
+		{
+			// Push the far child first so the near one is popped next and shrinks t for the far one
+			const bool nearIsRight = rays.negative[node.axis];
+			stack[top++] = nearIsRight ? node.first : node.first + 1;
+			stack[top++] = nearIsRight ? node.first + 1 : node.first;
+			continue;
+		}
+
+		for (uint32_t j = node.first; j < node.first + node.count; ++j)
+		{
+			const uint32_t primitive = mPrimitives[j];
+			if (primitive < triangleCount)
+			{
+				// Moller-Trumbore with the triangle broadcast over the 4 rays
+				const SceneTriangle& triangle = mTriangles[primitive];
+				const Float4 e1x(triangle.edge1.x), e1y(triangle.edge1.y), e1z(triangle.edge1.z);
+				const Float4 e2x(triangle.edge2.x), e2y(triangle.edge2.y), e2z(triangle.edge2.z);
+				const Float4 px = rays.dy * e2z - rays.dz * e2y;
+				const Float4 py = rays.dz * e2x - rays.dx * e2z;
+				const Float4 pz = rays.dx * e2y - rays.dy * e2x;
+				const Float4 invDet = one / (e1x * px + e1y * py + e1z * pz);
+				const Float4 sx = rays.ox - Float4(triangle.p0.x);
+				const Float4 sy = rays.oy - Float4(triangle.p0.y);
+				const Float4 sz = rays.oz - Float4(triangle.p0.z);
+				const Float4 u = (sx * px + sy * py + sz * pz) * invDet;
+				const Float4 qx = sy * e1z - sz * e1y;
+				const Float4 qy = sz * e1x - sx * e1z;
+				const Float4 qz = sx * e1y - sy * e1x;
+				const Float4 v = (rays.dx * qx + rays.dy * qy + rays.dz * qz) * invDet;
+				const Float4 t = (e2x * qx + e2y * qy + e2z * qz) * invDet;
+				recordHit(inside & (u >= zero) & (v >= zero) & (u + v <= one) & (t > epsilon) & (t < hits.t), t, primitive);
+			}
+			else
+			{
+				// Directions are unit length, so the quadratic has a = 1
+				const SceneSphere& sphere = mSpheres[primitive - triangleCount];
+				const Float4 cx = rays.ox - Float4(sphere.center.x);
+				const Float4 cy = rays.oy - Float4(sphere.center.y);
+				const Float4 cz = rays.oz - Float4(sphere.center.z);
+				const Float4 b = cx * rays.dx + cy * rays.dy + cz * rays.dz;
+				const Float4 c = cx * cx + cy * cy + cz * cz - Float4(sphere.radius * sphere.radius);
+				const Float4 discriminant = b * b - c;
+				const Float4 root = Sqrt(Max(discriminant, zero));
+				const Float4 tNear = zero - b - root;
+				const Float4 t = Select(tNear > epsilon, tNear, root - b);
+				recordHit(inside & (discriminant >= zero) & (t > epsilon) & (t < hits.t), t, primitive);
+			}
+		}
+	}
+}
+
+void RayTracer::RenderTile(int left, int top, int right, int bottom, uint64_t& rayCount)
+{
+	const Camera* camera = Camera::Get();
+	const Viewport* viewport = Viewport::Get();
+	const Vector3& position = camera->GetPosition();
+	const Vector3& cameraRight = camera->GetRight();
+	const Vector3& cameraUp = camera->GetUp();
+	const Vector3& look = camera->GetLook();
+
+	// Same mapping as the rasterizer, pixel centers land on the viewport NDC grid.
+	// The rasterizer moves geometry by the jitter, so rays move the other way.
+	const Vector2 jitter = AccumulationBuffer::Get()->GetJitter();
+	const float viewLeft = viewport->GetMinX() + jitter.x;
+	const float viewTop = viewport->GetMinY() + jitter.y;
+	const float halfWidth = (viewport->GetMaxX() - viewLeft) * 0.5f;
+	const float halfHeight = (viewport->GetMaxY() - viewTop) * 0.5f;
+
+	// Pixels are square, the vertical field of view sets the size of one in view space
+	const float scale = halfHeight > 0.0f ? tanf(camera->GetFov() * 0.5f * X::Math::kDegToRad) / halfHeight : 0.0f;
+	const uint32_t triangleCount = GetTriangleCount();
+
+	for (int y = top; y < bottom; y += 2)
+	{
+		for (int x = left; x < right; x += 2)
+		{
+			// Lanes are (x, y), (x + 1, y), (x, y + 1), (x + 1, y + 1), ones past the tile edge sit out
+			int laneBits = 0x1;
+			if (x + 1 < right)
+				laneBits |= 0x2;
+			if (y + 1 < bottom)
+				laneBits |= (laneBits << 2);
+			const float vx0 = (x - viewLeft + 0.5f - halfWidth) * scale;
+			const float vx1 = (x + 1 - viewLeft + 0.5f - halfWidth) * scale;
+			const float vy0 = (halfHeight - (y - viewTop + 0.5f)) * scale;
+			const float vy1 = (halfHeight - (y + 1 - viewTop + 0.5f)) * scale;
+			const Float4 vx = Set(vx0, vx1, vx0, vx1);
+			const Float4 vy = Set(vy0, vy0, vy1, vy1);
+			Float4 dx = vx * Float4(cameraRight.x) + vy * Float4(cameraUp.x) + Float4(look.x);
+			Float4 dy = vx * Float4(cameraRight.y) + vy * Float4(cameraUp.y) + Float4(look.y);
+			Float4 dz = vx * Float4(cameraRight.z) + vy * Float4(cameraUp.z) + Float4(look.z);
+			const Float4 invLength = Float4(1.0f) / Sqrt(dx * dx + dy * dy + dz * dz);
+
+			RayPacket primary;
+			primary.ox = Float4(position.x);
+			primary.oy = Float4(position.y);
+			primary.oz = Float4(position.z);
+			primary.SetDirections(dx * invLength, dy * invLength, dz * invLength);
+			primary.active = MaskFromBits(laneBits);
+
+			HitPacket hits;
+			Trace<false>(primary, hits);
+			rayCount += 4;
+
+			// Shadow rays start just off the surface, along the normal facing the eye
+			RayPacket shadow;
+			float sox[4] = {}, soy[4] = {}, soz[4] = {};
+			Vector3 normals[4];
+			int hitBits = 0;
+			for (int i = 0; i < 4; ++i)
+			{
+				const uint32_t primitive = hits.primitive[i];
+				if (primitive == kNoHit)
+					continue;
+
+				const Vector3 direction(Lane(primary.dx, i), Lane(primary.dy, i), Lane(primary.dz, i));
+				const Vector3 point = position + direction * Lane(hits.t, i);
+				Vector3 normal;
+				if (primitive & kPlaneBit)
+					normal = mPlanes[primitive & ~kPlaneBit].normal;
+				else if (primitive < triangleCount)
+					normal = MathHelper::Normalize(MathHelper::Cross(mTriangles[primitive].edge1, mTriangles[primitive].edge2));
+				else
+					normal = MathHelper::Normalize(point - mSpheres[primitive - triangleCount].center);
+				if (MathHelper::Dot(normal, direction) > 0.0f)
+					normal = -normal;
+
+				const Vector3 origin = point + normal * (kHitEpsilon * 10.0f);
+				sox[i] = origin.x;
+				soy[i] = origin.y;
+				soz[i] = origin.z;
+				normals[i] = normal;
+				hitBits |= 1 << i;
+			}
+			if (hitBits == 0)
+				continue;
+
+			shadow.ox = Set(sox[0], sox[1], sox[2], sox[3]);
+			shadow.oy = Set(soy[0], soy[1], soy[2], soy[3]);
+			shadow.oz = Set(soz[0], soz[1], soz[2], soz[3]);
+			shadow.SetDirections(Float4(kLightDirection.x), Float4(kLightDirection.y), Float4(kLightDirection.z));
+			shadow.active = MaskFromBits(hitBits);
+
+			HitPacket shadowHits;
+			Trace<true>(shadow, shadowHits);
+			const int occludedBits = Bits(shadowHits.occluded);
+			for (int i = 0; i < 4; ++i)
+			{
+				if ((hitBits & (1 << i)) == 0)
+					continue;
+
+				++rayCount;
+				const uint32_t primitive = hits.primitive[i];
+				uint32_t color = 0;
+				if (primitive & kPlaneBit)
+					color = mPlanes[primitive & ~kPlaneBit].color;
+				else if (primitive < triangleCount)
+					color = mTriangles[primitive].color;
+				else
+					color = mSpheres[primitive - triangleCount].color;
+
+				const float diffuse = (occludedBits & (1 << i)) ? 0.0f : std::max(MathHelper::Dot(normals[i], kLightDirection), 0.0f);
+				const int px = x + (i & 1);
+				const int py = y + (i >> 1);
+				mColors[(px - mTargetLeft) + (py - mTargetTop) * mTargetWidth] = Shade(color, std::min(kAmbient + diffuse, 1.0f));
+			}
+		}
+	}
+}
+
+void RayTracer::Render(int maxThreads)
+{
+	mStats = Stats();
+	const ClipRect rect = Clipper::Get()->GetClipRect();
+	if (rect.IsEmpty())
+		return;
+
+	const auto buildStart = std::chrono::high_resolution_clock::now();
+	Build();
+	const auto traceStart = std::chrono::high_resolution_clock::now();
+
+	mTargetLeft = rect.minX;
+	mTargetTop = rect.minY;
+	mTargetWidth = rect.maxX - rect.minX + 1;
+	const int targetHeight = rect.maxY - rect.minY + 1;
+	mColors.assign(static_cast<size_t>(mTargetWidth) * targetHeight, 0);
+
+	// One tile per chunk, threads pick up the next tile as soon as they finish one
+	const int tilesX = (mTargetWidth + kTileSize - 1) / kTileSize;
+	const int tilesY = (targetHeight + kTileSize - 1) / kTileSize;
+	std::atomic<uint64_t> rays{ 0 };
+	ThreadPool* threadPool = ThreadPool::Get();
+	threadPool->ParallelFor(tilesX * tilesY, 1, [&](int begin, int end)
+	{
+		uint64_t tileRays = 0;
+		for (int tile = begin; tile < end; ++tile)
+		{
+			const int left = rect.minX + (tile % tilesX) * kTileSize;
+			const int top = rect.minY + (tile / tilesX) * kTileSize;
+			RenderTile(left, top, std::min(left + kTileSize, rect.maxX + 1), std::min(top + kTileSize, rect.maxY + 1), tileRays);
+		}
+		rays += tileRays;
+	}, maxThreads);
+
+	// Pixels that missed are transparent and leave the frame buffer alone
+	FrameBuffer* frameBuffer = FrameBuffer::Get();
+	for (int y = 0; y < targetHeight; ++y)
+		frameBuffer->BlendSpan(rect.minX, rect.minY + y, &mColors[static_cast<size_t>(y) * mTargetWidth], mTargetWidth);
+
+	const auto end = std::chrono::high_resolution_clock::now();
+	mStats.primitives = static_cast<uint32_t>(mPrimitives.size() + mPlanes.size());
+	mStats.nodes = static_cast<uint32_t>(mNodes.size());
+	mStats.rays = rays;
+	mStats.buildMs = std::chrono::duration<float, std::milli>(traceStart - buildStart).count();
+	mStats.traceMs = std::chrono::duration<float, std::milli>(end - traceStart).count();
+	mStats.threads = maxThreads > 0 ? std::min(maxThreads, threadPool->GetThreadCount()) : threadPool->GetThreadCount();
+}
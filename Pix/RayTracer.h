@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Mesh.h"
+#include "Vector3.h"
+
+#include <cstdint>
+#include <vector>
+
+// Scene of spheres, planes and triangles rendered by tracing rays from the camera.
+// Spheres and triangles are kept in a bounding volume hierarchy built with the surface area
+// heuristic, planes are unbounded and tested on their own. Rays are traced in packets of 4
+// covering 2x2 pixels, so each node and primitive test runs for all 4 rays at once.
+class RayTracer
+{
+public:
+	static RayTracer* Get();
+
+public:
+	struct Stats
+	{
+		uint32_t primitives = 0;
+		uint32_t nodes = 0;
+		uint64_t rays = 0;
+		float buildMs = 0.0f;
+		float traceMs = 0.0f;
+		int threads = 0;
+	};
+
+	// The scene lasts one frame
+	void OnNewFrame();
+
+	// Positions go through the matrix stack, every primitive takes the current rasterizer color
+	void AddSphere(const Vector3& center, float radius);
+	void AddTriangle(const Vector3& p0, const Vector3& p1, const Vector3& p2);
+	void AddMesh(const Mesh& mesh);
+
+	// Points p with dot(normal, p) = distance, in world space
+	void AddPlane(const Vector3& normal, float distance);
+
+	// Traces the clip rect from the camera into the frame buffer, pixels that hit nothing are left as they are.
+	// Tiles are spread over the thread pool, maxThreads limits the threads used, 0 uses all of them.
+	void Render(int maxThreads);
+
+	// Work done by the last render
+	const Stats& GetStats() const { return mStats; }
+
+private:
+	struct SceneSphere
+	{
+		Vector3 center;
+		float radius;
+		uint32_t color;
+	};
+
+	struct ScenePlane
+	{
+		Vector3 normal;
+		float distance;
+		uint32_t color;
+	};
+
+	struct SceneTriangle
+	{
+		Vector3 p0;
+		Vector3 edge1;
+		Vector3 edge2;
+		uint32_t color;
+	};
+
+	// Inner nodes have a count of 0 and their children at first and first + 1,
+	// leaves hold count primitives from mPrimitives[first]
+	struct Node
+	{
+		Vector3 min;
+		uint32_t first = 0;
+		Vector3 max;
+		uint16_t count = 0;
+		uint16_t axis = 0;
+	};
+
+	struct RayPacket;
+	struct HitPacket;
+
+	struct Bounds
+	{
+		Vector3 min;
+		Vector3 max;
+	};
+
+	void Build();
+	void Subdivide(uint32_t nodeIndex, uint32_t first, uint32_t count, int depth);
+
+	// Primitives below the triangle count are triangles, the rest are spheres
+	uint32_t GetTriangleCount() const { return static_cast<uint32_t>(mTriangles.size()); }
+
+	void RenderTile(int left, int top, int right, int bottom, uint64_t& rays);
+
+	template <bool kAnyHit>
+	void Trace(const RayPacket& rays, HitPacket& hits) const;
+
+	std::vector<SceneSphere> mSpheres;
+	std::vector<ScenePlane> mPlanes;
+	std::vector<SceneTriangle> mTriangles;
+	std::vector<uint32_t> mPrimitives;
+	std::vector<Bounds> mPrimitiveBounds;
+	std::vector<Vector3> mCentroids;
+	std::vector<Node> mNodes;
+	std::vector<uint32_t> mColors;
+	int mTargetLeft = 0;
+	int mTargetTop = 0;
+	int mTargetWidth = 0;
+	Stats mStats;
+};
@@ -1,6 +1,8 @@
 #include "ScriptParser.h"
 
 #include "CommandDictionary.h"
+#include "LayerStack.h"
+#include "VariableCache.h"
 
 #include <XEngine.h>
 #include <sstream>
@@ -31,6 +33,24 @@ namespace
 
 		return tokens;
 	}
+
+	// FNV-1a
+	const uint64_t kHashOffset = 14695981039346656037ull;
+	const uint64_t kHashPrime = 1099511628211ull;
+
+	uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+			hash = (hash ^ bytes[i]) * kHashPrime;
+		return hash;
+	}
+
+	uint64_t HashString(uint64_t hash, const std::string& text)
+	{
+		// The terminator keeps "ab", "c" apart from "a", "bc"
+		return HashBytes(hash, text.c_str(), text.size() + 1);
+	}
 }
 
 // Parse script into commands and parameters
@@ -44,9 +64,10 @@ void ScriptParser::ParseScript(const std::string& script)
 	// For each command line, split out keyword and parameters
 	for (auto& line : scriptLines)
 	{
-		// Ignore comments
-		if (line.size() > 0 && line[0] == '/' && line[1] == '/')
-			continue;
+		// Ignore comments, whole lines and the rest of a line after a command
+		const std::size_t comment = line.find("//");
+		if (comment != std::string::npos)
+			line.erase(comment);
 
 		auto tokens = TokenizeString(line, " ,()");
 		if (tokens.empty())
@@ -67,7 +88,10 @@ void ScriptParser::ParseScript(const std::string& script)
 
 void ScriptParser::ExecuteScript()
 {
+	HashLayers();
+
 	// Execute script commands
+	LayerStack* layerStack = LayerStack::Get();
 	for (auto& statement : mStatements)
 	{
 		Command* command = CommandDictionary::Get()->CommandLookup(statement.command);
@@ -76,9 +100,44 @@ void ScriptParser::ExecuteScript()
 			XLOG("Unknown command: %s", statement.command.c_str());
 			continue;
 		}
+		if (command->IsDrawCommand() && layerStack->IsTargetCached())
+			continue;
 		if (!command->Execute(statement.params))
 		{
 			XLOG("Failed to run command: %s", statement.command.c_str());
 		}
 	}
 }
+
+void ScriptParser::HashLayers()
+{
+	// The hash runs over every statement with its variables replaced by their values, so it changes with
+	// anything that runs before the point it is taken at but not with what runs after. A layer takes it at
+	// the end of its last run of statements, the base at the first SetLayer.
+	LayerStack* layerStack = LayerStack::Get();
+	const VariableCache* variableCache = VariableCache::Get();
+	std::string layer;
+	uint64_t hash = kHashOffset;
+	for (const Statement& statement : mStatements)
+	{
+		if (statement.command == "SetLayer" && !statement.params.empty())
+		{
+			layerStack->SetSignature(layer, hash);
+			layer = statement.params[0];
+		}
+
+		hash = HashString(hash, statement.command);
+		for (size_t i = 0; i < statement.params.size(); ++i)
+		{
+			// A declaration names its variable, edits to the value only change the statements using it
+			const std::string& param = statement.params[i];
+			const bool declared = i == 0 && statement.params.size() > 1 && statement.params[1] == "=";
+			float value = 0.0f;
+			if (!declared && variableCache->IsVarName(param) && variableCache->FindFloat(param, value))
+				hash = HashBytes(hash, &value, sizeof(value));
+			else
+				hash = HashString(hash, param);
+		}
+	}
+	layerStack->SetSignature(layer, hash);
+}
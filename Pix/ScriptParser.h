@@ -10,6 +10,9 @@ public:
 	void ExecuteScript();
 
 private:
+	// Gives each layer the hash of the statements up to its last one, see LayerStack
+	void HashLayers();
+
 	struct Statement
 	{
 		std::string command;
@@ -0,0 +1,202 @@
+#include "Shapes.h"
+
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Coverage in 0..256 of a pixel at distance d, the same rounding in both paths
+	uint32_t Coverage(float distance)
+	{
+		const float coverage = std::min(std::max(0.5f - distance, 0.0f), 1.0f);
+		return static_cast<uint32_t>(coverage * 256.0f + 0.5f);
+	}
+
+	uint32_t ScaleColor(uint32_t color, uint32_t coverage)
+	{
+		uint32_t result = 0;
+		for (int shift = 0; shift < 32; shift += 8)
+			result |= ((((color >> shift) & 0xff) * coverage + 128) >> 8) << shift;
+		return result;
+	}
+
+#if PIX_SSE
+	__m128 Abs(__m128 v)
+	{
+		return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+	}
+
+	__m128 Length(__m128 x, __m128 y)
+	{
+		return _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+	}
+
+	// Same operations in the same order as Shape::Distance, so both paths agree exactly
+	__m128 Distance4(const Shape& shape, __m128 x, __m128 y)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		switch (shape.type)
+		{
+		case Shape::Type::RoundedRect:
+		{
+			const __m128 qx = _mm_sub_ps(Abs(_mm_sub_ps(x, _mm_set1_ps(shape.a.x))), _mm_set1_ps(shape.b.x));
+			const __m128 qy = _mm_sub_ps(Abs(_mm_sub_ps(y, _mm_set1_ps(shape.a.y))), _mm_set1_ps(shape.b.y));
+			const __m128 outside = Length(_mm_max_ps(qx, zero), _mm_max_ps(qy, zero));
+			const __m128 inside = _mm_min_ps(_mm_max_ps(qx, qy), zero);
+			return _mm_sub_ps(_mm_add_ps(outside, inside), _mm_set1_ps(shape.radius));
+		}
+		case Shape::Type::Ring:
+		{
+			const __m128 length = Length(_mm_sub_ps(x, _mm_set1_ps(shape.a.x)), _mm_sub_ps(y, _mm_set1_ps(shape.a.y)));
+			return _mm_sub_ps(Abs(_mm_sub_ps(length, _mm_set1_ps(shape.radius))), _mm_set1_ps(shape.halfWidth));
+		}
+		case Shape::Type::Capsule:
+		default:
+		{
+			const float baX = shape.b.x - shape.a.x;
+			const float baY = shape.b.y - shape.a.y;
+			const float lengthSquared = baX * baX + baY * baY;
+			const float inverse = lengthSquared > 0.0f ? 1.0f / lengthSquared : 0.0f;
+			const __m128 paX = _mm_sub_ps(x, _mm_set1_ps(shape.a.x));
+			const __m128 paY = _mm_sub_ps(y, _mm_set1_ps(shape.a.y));
+			__m128 h = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(paX, _mm_set1_ps(baX)), _mm_mul_ps(paY, _mm_set1_ps(baY))), _mm_set1_ps(inverse));
+			h = _mm_min_ps(_mm_max_ps(h, zero), _mm_set1_ps(1.0f));
+			const __m128 dx = _mm_sub_ps(paX, _mm_mul_ps(_mm_set1_ps(baX), h));
+			const __m128 dy = _mm_sub_ps(paY, _mm_mul_ps(_mm_set1_ps(baY), h));
+			return _mm_sub_ps(Length(dx, dy), _mm_set1_ps(shape.radius));
+		}
+		}
+	}
+#endif
+}
+
+Shape Shape::RoundedRect(const Vector2& center, const Vector2& halfSize, float cornerRadius)
+{
+	Shape shape;
+	shape.type = Type::RoundedRect;
+	shape.a = center;
+	shape.radius = std::min(std::max(cornerRadius, 0.0f), std::min(halfSize.x, halfSize.y));
+	shape.b = Vector2(halfSize.x - shape.radius, halfSize.y - shape.radius);
+	return shape;
+}
+
+Shape Shape::Ring(const Vector2& center, float radius, float width)
+{
+	Shape shape;
+	shape.type = Type::Ring;
+	shape.a = center;
+	shape.radius = radius;
+	shape.halfWidth = width * 0.5f;
+	return shape;
+}
+
+Shape Shape::Capsule(const Vector2& from, const Vector2& to, float radius)
+{
+	Shape shape;
+	shape.type = Type::Capsule;
+	shape.a = from;
+	shape.b = to;
+	shape.radius = radius;
+	return shape;
+}
+
+float Shape::Distance(float x, float y) const
+{
+	switch (type)
+	{
+	case Type::RoundedRect:
+	{
+		const float qx = std::abs(x - a.x) - b.x;
+		const float qy = std::abs(y - a.y) - b.y;
+		const float outsideX = std::max(qx, 0.0f);
+		const float outsideY = std::max(qy, 0.0f);
+		const float outside = std::sqrt(outsideX * outsideX + outsideY * outsideY);
+		const float inside = std::min(std::max(qx, qy), 0.0f);
+		return outside + inside - radius;
+	}
+	case Type::Ring:
+	{
+		const float dx = x - a.x;
+		const float dy = y - a.y;
+		return std::abs(std::sqrt(dx * dx + dy * dy) - radius) - halfWidth;
+	}
+	case Type::Capsule:
+	default:
+	{
+		const float baX = b.x - a.x;
+		const float baY = b.y - a.y;
+		const float lengthSquared = baX * baX + baY * baY;
+		const float inverse = lengthSquared > 0.0f ? 1.0f / lengthSquared : 0.0f;
+		const float paX = x - a.x;
+		const float paY = y - a.y;
+		const float h = std::min(std::max((paX * baX + paY * baY) * inverse, 0.0f), 1.0f);
+		const float dx = paX - baX * h;
+		const float dy = paY - baY * h;
+		return std::sqrt(dx * dx + dy * dy) - radius;
+	}
+	}
+}
+
+void Shape::GetBounds(float& minX, float& minY, float& maxX, float& maxY) const
+{
+	// Coverage reaches zero half a pixel outside the edge
+	switch (type)
+	{
+	case Type::RoundedRect:
+		minX = a.x - b.x - radius - 0.5f;
+		maxX = a.x + b.x + radius + 0.5f;
+		minY = a.y - b.y - radius - 0.5f;
+		maxY = a.y + b.y + radius + 0.5f;
+		break;
+	case Type::Ring:
+	{
+		const float extent = std::abs(radius) + halfWidth + 0.5f;
+		minX = a.x - extent;
+		maxX = a.x + extent;
+		minY = a.y - extent;
+		maxY = a.y + extent;
+		break;
+	}
+	case Type::Capsule:
+	default:
+		minX = std::min(a.x, b.x) - radius - 0.5f;
+		maxX = std::max(a.x, b.x) + radius + 0.5f;
+		minY = std::min(a.y, b.y) - radius - 0.5f;
+		maxY = std::max(a.y, b.y) + radius + 0.5f;
+		break;
+	}
+}
+
+void Shape::Cover(int x, int y, int count, uint32_t* colors) const
+{
+	int i = 0;
+#if PIX_SSE
+	const __m128 rowY = _mm_set1_ps(static_cast<float>(y));
+	const __m128 offsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 scale = _mm_set1_ps(256.0f);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i round = _mm_set1_epi16(128);
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 columnX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x + i)), offsets);
+		const __m128 distance = Distance4(*this, columnX, rowY);
+		const __m128 coverage = _mm_min_ps(_mm_max_ps(_mm_sub_ps(half, distance), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		const __m128i weights = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(coverage, scale), half));
+
+		// Each weight repeated for the four channels of its pixel, two pixels per register
+		__m128i weights16 = _mm_packs_epi32(weights, weights);
+		weights16 = _mm_unpacklo_epi16(weights16, weights16);
+		const __m128i low = _mm_unpacklo_epi32(weights16, weights16);
+		const __m128i high = _mm_unpackhi_epi32(weights16, weights16);
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + i));
+		const __m128i first = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), low), round), 8);
+		const __m128i second = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), high), round), 8);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(colors + i), _mm_packus_epi16(first, second));
+	}
+#endif
+	for (; i < count; ++i)
+		colors[i] = ScaleColor(colors[i], Coverage(Distance(static_cast<float>(x + i), static_cast<float>(y))));
+}
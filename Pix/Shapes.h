@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Vector2.h"
+
+#include <cstdint>
+
+// Signed distance shapes for the 2D drawing commands, in pixels with pixel centers on whole numbers.
+// Distances are exact and negative inside, so the distance at one point bounds it everywhere within that
+// radius. The rasterizer uses that to skip or fill whole tiles from a single evaluation.
+struct Shape
+{
+	enum class Type
+	{
+		RoundedRect,
+		Ring,
+		Capsule
+	};
+
+	// The corner radius is limited to the smaller half size
+	static Shape RoundedRect(const Vector2& center, const Vector2& halfSize, float cornerRadius);
+	static Shape Ring(const Vector2& center, float radius, float width);
+	static Shape Capsule(const Vector2& from, const Vector2& to, float radius);
+
+	float Distance(float x, float y) const;
+
+	// Bounds of the pixels with any coverage
+	void GetBounds(float& minX, float& minY, float& maxX, float& maxY) const;
+
+	// Scales the colors of count pixels along row y starting at x by their coverage, 4 at a time where SSE2 is
+	// available. Coverage falls from 1 to 0 across the pixel the edge goes through.
+	void Cover(int x, int y, int count, uint32_t* colors) const;
+
+	Type type = Type::RoundedRect;
+	Vector2 a;				// Center, or the first end of a capsule
+	Vector2 b;				// Half size of the rectangle inside the corners, or the second end of a capsule
+	float radius = 0.0f;	// Of the corners, the ring or the capsule
+	float halfWidth = 0.0f;	// Of the ring
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Vector3.h"
+
+struct Sphere
+{
+	Vector3 center;
+	float radius;
+
+	Sphere() : center(0.0f, 0.0f, 0.0f), radius(1.0f) {}
+	Sphere(const Vector3& center, float radius) : center(center), radius(radius) {}
+};
@@ -0,0 +1,95 @@
+#include "BlendTests.h"
+
+#include "Blend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	// A 512x512 frame, large enough that the timer resolution does not matter
+	const int kPixelCount = 512 * 512;
+
+	// Best of several runs, the others are slowed by whatever else the machine does
+	const int kRuns = 15;
+
+	struct Mode
+	{
+		BlendMode mode;
+		const char* name;
+	};
+
+	const Mode kModes[] =
+	{
+		{ BlendMode::Over, "Over" },
+		{ BlendMode::Add, "Add" },
+		{ BlendMode::Multiply, "Multiply" },
+		{ BlendMode::Screen, "Screen" }
+	};
+
+	template <class Kernel>
+	float GetBestMs(const std::vector<uint32_t>& dest, const std::vector<uint32_t>& source, Kernel kernel)
+	{
+		std::vector<uint32_t> pixels(dest.size());
+		float bestMs = 0.0f;
+		for (int run = 0; run < kRuns; ++run)
+		{
+			std::copy(dest.begin(), dest.end(), pixels.begin());
+			const auto start = std::chrono::high_resolution_clock::now();
+			kernel(pixels.data(), source.data(), static_cast<int>(source.size()));
+			const float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			bestMs = run == 0 ? ms : std::min(bestMs, ms);
+		}
+		return bestMs;
+	}
+}
+
+int BlendTests::Run()
+{
+	int failed = 0;
+
+	const uint32_t mismatches = Blend::CheckKernels();
+	std::printf("%s blend kernels: %u pixels differ from the scalar reference\n", mismatches == 0 ? "Passed   " : "Failed   ", mismatches);
+	if (mismatches != 0)
+		++failed;
+
+	// Premultiplied pixels from a fixed LCG, alpha spread over the whole range
+	uint32_t seed = 54321;
+	auto randomPixel = [&seed]()
+	{
+		seed = seed * 1664525u + 1013904223u;
+		const uint32_t alpha = seed >> 24;
+		uint32_t pixel = alpha << 24;
+		for (int shift = 0; shift < 24; shift += 8)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			pixel |= ((seed >> 24) * alpha / 255) << shift;
+		}
+		return pixel;
+	};
+	std::vector<uint32_t> source(kPixelCount);
+	std::vector<uint32_t> dest(kPixelCount);
+	std::generate(source.begin(), source.end(), randomPixel);
+	std::generate(dest.begin(), dest.end(), randomPixel);
+
+	for (const Mode& mode : kModes)
+	{
+		const float simdMs = GetBestMs(dest, source, [&mode](uint32_t* pixels, const uint32_t* colors, int count)
+		{
+			Blend::BlendPixels(mode.mode, pixels, colors, count);
+		});
+		const float referenceMs = GetBestMs(dest, source, [&mode](uint32_t* pixels, const uint32_t* colors, int count)
+		{
+			Blend::BlendPixelsReference(mode.mode, pixels, colors, count);
+		});
+
+		std::printf("Timed     blend %s: %.3f ms, %.3f ms scalar, %.2fx\n",
+			mode.name,
+			simdMs,
+			referenceMs,
+			simdMs > 0.0f ? referenceMs / simdMs : 0.0f);
+	}
+	return failed;
+}
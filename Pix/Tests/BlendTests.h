@@ -0,0 +1,9 @@
+#pragma once
+
+// Checks the SIMD blend kernels against the scalar reference, then times both on a frame sized span of
+// pixels. Only a kernel that differs from the reference fails, the timings are printed for comparison.
+namespace BlendTests
+{
+	// Prints one line per check, returns the number of failed checks
+	int Run();
+}
@@ -0,0 +1,160 @@
+#include "GoldenTests.h"
+
+#include "AccumulationBuffer.h"
+#include "FrameBuffer.h"
+#include "Graphics.h"
+#include "ImageCache.h"
+#include "ImageDiff.h"
+#include "ImageWriter.h"
+#include "ScriptParser.h"
+#include "VariableCache.h"
+
+#include <XEngine.h>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+	const char* const kGoldenFolder = "Golden";
+
+	// The second frame also runs the layer and image caches and the partial upload
+	const int kFrames = 2;
+}
+
+GoldenTests* GoldenTests::Get()
+{
+	static GoldenTests sInstance;
+	return &sInstance;
+}
+
+int GoldenTests::Run(const std::string& directory, int tolerance, bool record)
+{
+	XLOG("Running golden tests in [%s]...", directory.c_str());
+
+	mResults.clear();
+	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	// Sorted so the scripts always run in the same order and leave the same state behind
+	const std::filesystem::path root = directory;
+	const std::filesystem::path golden = root / kGoldenFolder;
+	std::vector<std::filesystem::path> scripts;
+	std::error_code error;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(root, error))
+	{
+		if (entry.is_regular_file() && entry.path().extension() == ".pix")
+			scripts.push_back(entry.path());
+	}
+	std::sort(scripts.begin(), scripts.end());
+	std::filesystem::create_directories(golden, error);
+
+	int failed = 0;
+	for (const std::filesystem::path& script : scripts)
+	{
+		Result result;
+		result.script = script.lexically_relative(root).generic_u8string();
+
+		// Scripts in folders are named with the folder, Benchmarks/blend_add.pix becomes Benchmarks_blend_add
+		std::string name = script.lexically_relative(root).replace_extension().generic_u8string();
+		std::replace(name.begin(), name.end(), '/', '_');
+		const std::filesystem::path reference = golden / (name + ".png");
+		const std::filesystem::path heatmapFile = golden / (name + ".diff.png");
+		const std::filesystem::path outputFile = golden / (name + ".out.png");
+
+		const auto scriptStart = std::chrono::high_resolution_clock::now();
+		std::ifstream file(script);
+		const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		// A script that throws fails on its own instead of ending the run
+		try
+		{
+			ScriptParser parser;
+			VariableCache::Get()->Clear();
+			FrameBuffer::Get()->SetPaletteMode(false);
+			parser.ParseScript(content);
+
+			// Frames are rendered as the render view does, with the extra samples of accumulating scripts
+			for (int frame = 0; frame < kFrames; ++frame)
+			{
+				Graphics::NewFrame();
+				parser.ExecuteScript();
+				for (int i = 1; i < AccumulationBuffer::Get()->GetSamplesPerFrame() && !AccumulationBuffer::Get()->IsConverged(); ++i)
+				{
+					Graphics::EndSample();
+					Graphics::NewFrame();
+					parser.ExecuteScript();
+				}
+				Graphics::EndFrame();
+			}
+		}
+		catch (const std::exception& exception)
+		{
+			result.error = exception.what();
+			XLOG("Failed [%s]: %s", result.script.c_str(), exception.what());
+			mResults.push_back(std::move(result));
+			++failed;
+			continue;
+		}
+
+		const FrameBuffer* frameBuffer = FrameBuffer::Get();
+		const uint32_t* pixels = frameBuffer->GetPresentedPixels();
+		const int width = frameBuffer->GetWidth();
+		const int height = frameBuffer->GetHeight();
+		std::unique_ptr<Image> expected = ImageCache::Load(reference.u8string());
+		if (expected == nullptr)
+		{
+			result.missing = true;
+			result.recorded = record;
+			result.passed = record;
+			ImageWriter::Get()->Save(record ? reference.u8string() : outputFile.u8string(), pixels, width, height);
+		}
+		else if (expected->width != width || expected->height != height)
+		{
+			result.differing = static_cast<uint32_t>(width * height);
+			result.maxDifference = 255;
+			ImageWriter::Get()->Save(outputFile.u8string(), pixels, width, height);
+		}
+		else
+		{
+			std::vector<uint32_t> heatmap(width * height);
+			const ImageDiff::Result diff = ImageDiff::Compare(pixels, expected->pixels.data(), width, height, tolerance, heatmap.data());
+			result.differing = diff.differing;
+			result.maxDifference = diff.maxDifference;
+			result.passed = diff.differing == 0;
+			if (!result.passed)
+			{
+				ImageWriter::Get()->Save(heatmapFile.u8string(), heatmap.data(), width, height);
+				ImageWriter::Get()->Save(outputFile.u8string(), pixels, width, height);
+			}
+		}
+		result.timeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - scriptStart).count();
+
+		// Output of an earlier failure is stale once the script passes
+		if (result.passed)
+		{
+			std::filesystem::remove(heatmapFile, error);
+			std::filesystem::remove(outputFile, error);
+		}
+		else
+		{
+			++failed;
+		}
+
+		XLOG("%s [%s]: %u pixels differ, max difference %d, %.2f ms",
+			result.recorded ? "Recorded" : (result.missing ? "Missing" : (result.passed ? "Passed" : "Failed")),
+			result.script.c_str(),
+			result.differing,
+			result.maxDifference,
+			result.timeMs);
+		mResults.push_back(std::move(result));
+	}
+
+	// References and heatmaps are on disk when the run returns
+	ImageWriter::Get()->Flush();
+	mTimeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	XLOG("Golden tests: %zu scripts, %d failed, %.2f ms", mResults.size(), failed, mTimeMs);
+	return failed;
+}
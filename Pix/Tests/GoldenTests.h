@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Renders every script under a directory without showing it and compares the last frame with a reference
+// PNG in the Golden folder there, a check that optimizations leave the pixels alone. A missing reference fails
+// the script unless the run records, which saves the current output as the reference. A failed script saves
+// its frame and a heatmap of the differing pixels next to the reference.
+class GoldenTests
+{
+public:
+	static GoldenTests* Get();
+
+public:
+	// Largest channel difference that still matches, room for compilers rounding differently
+	static constexpr int kDefaultTolerance = 2;
+
+	struct Result
+	{
+		std::string script;			// Relative to the directory
+		std::string error;			// What the script threw, if it did
+		uint32_t differing = 0;
+		int maxDifference = 0;
+		float timeMs = 0.0f;
+		bool missing = false;		// No reference yet
+		bool recorded = false;		// The frame became the missing reference
+		bool passed = false;
+	};
+
+	// Returns the number of failed scripts. Existing references are only compared, delete one to record it again.
+	int Run(const std::string& directory, int tolerance = kDefaultTolerance, bool record = false);
+
+	const std::vector<Result>& GetResults() const { return mResults; }
+	float GetTimeMs() const { return mTimeMs; }
+
+private:
+	std::vector<Result> mResults;
+	float mTimeMs = 0.0f;
+};
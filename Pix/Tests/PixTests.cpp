@@ -0,0 +1,56 @@
+#include "BlendTests.h"
+#include "GoldenTests.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// Runs the tests without a window, from the Pix folder so scripts find their images and meshes.
+// Usage: PixTests [--blend] [--golden] [--record] [directory], both suites run when neither is named.
+// --record saves references for scripts that have none yet.
+int main(int argc, char* argv[])
+{
+	std::string directory = "Scripts";
+	bool blend = false;
+	bool golden = false;
+	bool record = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--blend") == 0)
+			blend = true;
+		else if (std::strcmp(argv[i], "--golden") == 0)
+			golden = true;
+		else if (std::strcmp(argv[i], "--record") == 0)
+			record = true;
+		else
+			directory = argv[i];
+	}
+	if (!blend && !golden)
+		blend = golden = true;
+
+	int failed = 0;
+	if (blend)
+		failed += BlendTests::Run();
+	if (!golden)
+		return failed == 0 ? 0 : 1;
+
+	GoldenTests* goldenTests = GoldenTests::Get();
+	const int goldenFailed = goldenTests->Run(directory, GoldenTests::kDefaultTolerance, record);
+	failed += goldenFailed;
+	for (const GoldenTests::Result& result : goldenTests->GetResults())
+	{
+		if (result.recorded)
+			std::printf("Recorded  %s\n", result.script.c_str());
+		else if (result.missing)
+			std::printf("Missing   %s: no reference, run with --record to save one\n", result.script.c_str());
+		else if (!result.error.empty())
+			std::printf("Failed    %s: %s\n", result.script.c_str(), result.error.c_str());
+		else if (result.passed)
+			std::printf("Passed    %s (%.2f ms)\n", result.script.c_str(), result.timeMs);
+		else
+			std::printf("Failed    %s: %u pixels, max difference %d\n", result.script.c_str(), result.differing, result.maxDifference);
+	}
+	std::printf("%zu scripts, %d failed, %.2f ms\n", goldenTests->GetResults().size(), goldenFailed, goldenTests->GetTimeMs());
+
+	return failed == 0 ? 0 : 1;
+}
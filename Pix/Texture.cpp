@@ -0,0 +1,282 @@
+#include "Texture.h"
+
+#include "Simd.h"
+
+// X only compiles the stb_image implementation on platforms without WIC
+#ifdef _WIN32
+#define STB_IMAGE_IMPLEMENTATION
+#endif
+#include <stb/stb_image.h>
+
+namespace
+{
+	const float kInv255 = 1.0f / 255.0f;
+
+	int NextPowerOfTwo(int value)
+	{
+		int result = 1;
+		while (result < value)
+			result <<= 1;
+		return result;
+	}
+
+	int Log2(int powerOfTwo)
+	{
+		int result = 0;
+		while ((1 << result) < powerOfTwo)
+			++result;
+		return result;
+	}
+
+	int FastFloor(float value)
+	{
+		const int truncated = static_cast<int>(value);
+		return value < truncated ? truncated - 1 : truncated;
+	}
+
+	uint32_t PackColor(const X::Color& color)
+	{
+		const uint32_t r = static_cast<uint32_t>(X::Math::Clamp(color.x, 0.0f, 1.0f) * 255.0f + 0.5f);
+		const uint32_t g = static_cast<uint32_t>(X::Math::Clamp(color.y, 0.0f, 1.0f) * 255.0f + 0.5f);
+		const uint32_t b = static_cast<uint32_t>(X::Math::Clamp(color.z, 0.0f, 1.0f) * 255.0f + 0.5f);
+		const uint32_t a = static_cast<uint32_t>(X::Math::Clamp(color.w, 0.0f, 1.0f) * 255.0f + 0.5f);
+		return r | (g << 8) | (b << 16) | (a << 24);
+	}
+
+	X::Color UnpackColor(uint32_t texel)
+	{
+		return X::Color(
+			(texel & 0xff) * kInv255,
+			((texel >> 8) & 0xff) * kInv255,
+			((texel >> 16) & 0xff) * kInv255,
+			(texel >> 24) * kInv255);
+	}
+
+	// Weights the 2x2 footprint t00 t10 / t01 t11 by the fractional texel position
+	X::Color BlendTexels(uint32_t t00, uint32_t t10, uint32_t t01, uint32_t t11, float fx, float fy)
+	{
+#if PIX_SSE
+		// Widen all four texels at once: bytes to 16 bit lanes, then to 32 bit lanes
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i packed = _mm_set_epi32(static_cast<int>(t11), static_cast<int>(t01), static_cast<int>(t10), static_cast<int>(t00));
+		const __m128i low = _mm_unpacklo_epi8(packed, zero);
+		const __m128i high = _mm_unpackhi_epi8(packed, zero);
+		const __m128 c00 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero));
+		const __m128 c10 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero));
+		const __m128 c01 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero));
+		const __m128 c11 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero));
+
+		const __m128 wx = _mm_set1_ps(fx);
+		const __m128 top = _mm_add_ps(c00, _mm_mul_ps(_mm_sub_ps(c10, c00), wx));
+		const __m128 bottom = _mm_add_ps(c01, _mm_mul_ps(_mm_sub_ps(c11, c01), wx));
+		const __m128 result = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), _mm_set1_ps(fy)));
+
+		X::Color color;
+		_mm_storeu_ps(&color.x, _mm_mul_ps(result, _mm_set1_ps(kInv255)));
+		return color;
+#else
+		const X::Color top = UnpackColor(t00) + (UnpackColor(t10) - UnpackColor(t00)) * fx;
+		const X::Color bottom = UnpackColor(t01) + (UnpackColor(t11) - UnpackColor(t01)) * fx;
+		return top + (bottom - top) * fy;
+#endif
+	}
+
+	// Wrapping bilinear resample, used to bring level 0 to a power of two size
+	std::vector<X::Color> Resample(const std::vector<X::Color>& source, int sourceWidth, int sourceHeight, int width, int height)
+	{
+		std::vector<X::Color> result(width * height);
+		const float scaleX = static_cast<float>(sourceWidth) / width;
+		const float scaleY = static_cast<float>(sourceHeight) / height;
+		for (int y = 0; y < height; ++y)
+		{
+			const float sy = (y + 0.5f) * scaleY - 0.5f;
+			const int y0 = FastFloor(sy);
+			const float fy = sy - y0;
+			const int row0 = ((y0 % sourceHeight) + sourceHeight) % sourceHeight;
+			const int row1 = (row0 + 1) % sourceHeight;
+			for (int x = 0; x < width; ++x)
+			{
+				const float sx = (x + 0.5f) * scaleX - 0.5f;
+				const int x0 = FastFloor(sx);
+				const float fx = sx - x0;
+				const int column0 = ((x0 % sourceWidth) + sourceWidth) % sourceWidth;
+				const int column1 = (column0 + 1) % sourceWidth;
+
+				const X::Color top = source[row0 * sourceWidth + column0] * (1.0f - fx) + source[row0 * sourceWidth + column1] * fx;
+				const X::Color bottom = source[row1 * sourceWidth + column0] * (1.0f - fx) + source[row1 * sourceWidth + column1] * fx;
+				result[y * width + x] = top * (1.0f - fy) + bottom * fy;
+			}
+		}
+		return result;
+	}
+}
+
+bool Texture::Load(const char* fileName, TextureLayout layout)
+{
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	stbi_uc* pixels = stbi_load(fileName, &width, &height, &channels, 4);
+	if (pixels == nullptr)
+		return false;
+
+	std::vector<X::Color> colors(width * height);
+	for (int i = 0; i < width * height; ++i)
+		colors[i] = X::Color(pixels[i * 4] * kInv255, pixels[i * 4 + 1] * kInv255, pixels[i * 4 + 2] * kInv255, pixels[i * 4 + 3] * kInv255);
+	stbi_image_free(pixels);
+
+	const int levelWidth = NextPowerOfTwo(width);
+	const int levelHeight = NextPowerOfTwo(height);
+	if (levelWidth != width || levelHeight != height)
+	{
+		colors = Resample(colors, width, height, levelWidth, levelHeight);
+		width = levelWidth;
+		height = levelHeight;
+	}
+
+	mLayout = layout;
+	mLevels.clear();
+	mLevels.reserve(Log2(X::Math::Max(width, height)) + 1);
+
+	// Box filter each level down to 1x1
+	while (true)
+	{
+		BuildLevel(mLevels.emplace_back(), width, height, colors);
+		if (width == 1 && height == 1)
+			break;
+
+		const int nextWidth = X::Math::Max(width / 2, 1);
+		const int nextHeight = X::Math::Max(height / 2, 1);
+		const int stepX = width / nextWidth;
+		const int stepY = height / nextHeight;
+		std::vector<X::Color> nextColors(nextWidth * nextHeight);
+		for (int y = 0; y < nextHeight; ++y)
+		{
+			for (int x = 0; x < nextWidth; ++x)
+			{
+				const int x0 = x * stepX;
+				const int y0 = y * stepY;
+				const int x1 = x0 + stepX - 1;
+				const int y1 = y0 + stepY - 1;
+				nextColors[y * nextWidth + x] = (colors[y0 * width + x0] + colors[y0 * width + x1] + colors[y1 * width + x0] + colors[y1 * width + x1]) * 0.25f;
+			}
+		}
+
+		colors.swap(nextColors);
+		width = nextWidth;
+		height = nextHeight;
+	}
+	return true;
+}
+
+X::Color Texture::Sample(float u, float v, float lod, TextureFilter filter) const
+{
+	if (mLevels.empty())
+		return X::Colors::White;
+
+	const int maxLevel = GetLevelCount() - 1;
+	if (filter == TextureFilter::Trilinear && lod > 0.0f)
+	{
+		// Blend the two closest levels
+		const float clampedLod = X::Math::Min(lod, static_cast<float>(maxLevel));
+		const int level0 = static_cast<int>(clampedLod);
+		const int level1 = X::Math::Min(level0 + 1, maxLevel);
+		const float t = clampedLod - level0;
+		const X::Color color0 = SampleBilinear(mLevels[level0], u, v);
+		if (level0 == level1)
+			return color0;
+
+		const X::Color color1 = SampleBilinear(mLevels[level1], u, v);
+#if PIX_SSE
+		const __m128 c0 = _mm_loadu_ps(&color0.x);
+		const __m128 c1 = _mm_loadu_ps(&color1.x);
+		X::Color color;
+		_mm_storeu_ps(&color.x, _mm_add_ps(c0, _mm_mul_ps(_mm_sub_ps(c1, c0), _mm_set1_ps(t))));
+		return color;
+#else
+		return color0 + (color1 - color0) * t;
+#endif
+	}
+
+	// Nearest and bilinear pick the closest level
+	const int level = lod > 0.0f ? X::Math::Min(static_cast<int>(lod + 0.5f), maxLevel) : 0;
+	if (filter == TextureFilter::Nearest)
+		return SampleNearest(mLevels[level], u, v);
+	return SampleBilinear(mLevels[level], u, v);
+}
+
+uint32_t Texture::GetTexelsPerSample(TextureFilter filter)
+{
+	switch (filter)
+	{
+	case TextureFilter::Nearest: return 1;
+	case TextureFilter::Bilinear: return 4;
+	case TextureFilter::Trilinear: return 8;
+	}
+	return 0;
+}
+
+void Texture::BuildLevel(Level& level, int width, int height, const std::vector<X::Color>& colors) const
+{
+	level.width = width;
+	level.height = height;
+	level.offsetX.resize(width);
+	level.offsetY.resize(height);
+
+	if (mLayout == TextureLayout::Linear)
+	{
+		for (int x = 0; x < width; ++x)
+			level.offsetX[x] = x;
+		for (int y = 0; y < height; ++y)
+			level.offsetY[y] = y * width;
+	}
+	else
+	{
+		// Interleave the low bits of x and y, the extra bits of the longer side go on top
+		const int bitsX = Log2(width);
+		const int bitsY = Log2(height);
+		const int commonBits = X::Math::Min(bitsX, bitsY);
+		for (int x = 0; x < width; ++x)
+		{
+			uint32_t offset = 0;
+			for (int i = 0; i < bitsX; ++i)
+				offset |= ((x >> i) & 1u) << (i < commonBits ? i * 2 : commonBits + i);
+			level.offsetX[x] = offset;
+		}
+		for (int y = 0; y < height; ++y)
+		{
+			uint32_t offset = 0;
+			for (int i = 0; i < bitsY; ++i)
+				offset |= ((y >> i) & 1u) << (i < commonBits ? i * 2 + 1 : commonBits + i);
+			level.offsetY[y] = offset;
+		}
+	}
+
+	level.texels.resize(width * height);
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+			level.texels[level.offsetX[x] + level.offsetY[y]] = PackColor(colors[y * width + x]);
+	}
+}
+
+X::Color Texture::SampleNearest(const Level& level, float u, float v) const
+{
+	return UnpackColor(level.Fetch(FastFloor(u * level.width), FastFloor(v * level.height)));
+}
+
+X::Color Texture::SampleBilinear(const Level& level, float u, float v) const
+{
+	// Texel centers sit at half integers
+	const float x = u * level.width - 0.5f;
+	const float y = v * level.height - 0.5f;
+	const int x0 = FastFloor(x);
+	const int y0 = FastFloor(y);
+	return BlendTexels(
+		level.Fetch(x0, y0),
+		level.Fetch(x0 + 1, y0),
+		level.Fetch(x0, y0 + 1),
+		level.Fetch(x0 + 1, y0 + 1),
+		x - x0,
+		y - y0);
+}
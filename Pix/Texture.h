@@ -0,0 +1,59 @@
+#pragma once
+
+#include <XEngine.h>
+
+#include <cstdint>
+#include <vector>
+
+enum class TextureLayout
+{
+	Linear,
+	Morton
+};
+
+enum class TextureFilter
+{
+	Nearest,
+	Bilinear,
+	Trilinear
+};
+
+// RGBA8 image with a full mip chain, sampled with wrapping texture coordinates.
+// Levels are resampled to power of two sizes so addressing is a mask and two table lookups.
+class Texture
+{
+public:
+	bool Load(const char* fileName, TextureLayout layout);
+
+	// Level of detail is log2 of the texels covered by one pixel, level 0 when magnified
+	X::Color Sample(float u, float v, float lod, TextureFilter filter) const;
+
+	int GetWidth() const { return mLevels.empty() ? 0 : mLevels[0].width; }
+	int GetHeight() const { return mLevels.empty() ? 0 : mLevels[0].height; }
+	int GetLevelCount() const { return static_cast<int>(mLevels.size()); }
+	TextureLayout GetLayout() const { return mLayout; }
+
+	// Texels read per sample for each filter
+	static uint32_t GetTexelsPerSample(TextureFilter filter);
+
+private:
+	struct Level
+	{
+		int width = 0;
+		int height = 0;
+
+		// Texel index of (x, y) is offsetX[x] + offsetY[y] for either layout
+		std::vector<uint32_t> offsetX;
+		std::vector<uint32_t> offsetY;
+		std::vector<uint32_t> texels;
+
+		uint32_t Fetch(int x, int y) const { return texels[offsetX[x & (width - 1)] + offsetY[y & (height - 1)]]; }
+	};
+
+	void BuildLevel(Level& level, int width, int height, const std::vector<X::Color>& colors) const;
+	X::Color SampleNearest(const Level& level, float u, float v) const;
+	X::Color SampleBilinear(const Level& level, float u, float v) const;
+
+	std::vector<Level> mLevels;
+	TextureLayout mLayout = TextureLayout::Morton;
+};
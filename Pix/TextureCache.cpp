@@ -0,0 +1,24 @@
+#include "TextureCache.h"
+
+TextureCache* TextureCache::Get()
+{
+	static TextureCache sInstance;
+	return &sInstance;
+}
+
+const Texture* TextureCache::GetTexture(const std::string& fileName, TextureLayout layout)
+{
+	const auto key = std::make_pair(fileName, layout);
+	auto iter = mTextures.find(key);
+	if (iter == mTextures.end())
+	{
+		std::unique_ptr<Texture> texture = std::make_unique<Texture>();
+		if (!texture->Load(fileName.c_str(), layout))
+		{
+			XLOG("Failed to load texture: %s", fileName.c_str());
+			texture.reset();
+		}
+		iter = mTextures.emplace(key, std::move(texture)).first;
+	}
+	return iter->second.get();
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Texture.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+class TextureCache
+{
+public:
+	static TextureCache* Get();
+
+public:
+	// Textures are loaded once per layout and kept for later frames, failed loads are not retried
+	const Texture* GetTexture(const std::string& fileName, TextureLayout layout);
+
+private:
+	std::map<std::pair<std::string, TextureLayout>, std::unique_ptr<Texture>> mTextures;
+};
@@ -0,0 +1,99 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool* ThreadPool::Get()
+{
+	static ThreadPool sInstance;
+	return &sInstance;
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mWake.notify_all();
+	for (std::thread& thread : mThreads)
+		thread.join();
+}
+
+void ThreadPool::ParallelFor(int count, int grainSize, const Task& task, int maxThreads)
+{
+	if (count <= 0)
+		return;
+
+	if (!mStarted)
+		Start();
+
+	const int threadCount = maxThreads > 0 ? std::min(maxThreads, GetThreadCount()) : GetThreadCount();
+	const int chunkSize = std::max(grainSize, 1);
+	const int chunkCount = (count + chunkSize - 1) / chunkSize;
+	if (chunkCount == 1 || threadCount == 1)
+	{
+		task(0, count);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTask = &task;
+		mCount = count;
+		mChunkSize = chunkSize;
+		mChunkCount = chunkCount;
+		mNextChunk = 0;
+		mActiveWorkers = threadCount - 1;
+		mBusyWorkers = static_cast<int>(mThreads.size());
+		++mGeneration;
+	}
+	mWake.notify_all();
+
+	RunChunks();
+
+	// Workers still read the task until they check in
+	std::unique_lock<std::mutex> lock(mMutex);
+	mDone.wait(lock, [this]() { return mBusyWorkers == 0; });
+	mTask = nullptr;
+}
+
+void ThreadPool::Start()
+{
+	mStarted = true;
+	const unsigned int cores = std::thread::hardware_concurrency();
+	for (unsigned int i = 1; i < cores; ++i)
+		mThreads.emplace_back(&ThreadPool::WorkerLoop, this, static_cast<int>(i - 1));
+}
+
+void ThreadPool::WorkerLoop(int index)
+{
+	uint32_t generation = 0;
+	while (true)
+	{
+		bool active = false;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWake.wait(lock, [&]() { return mStop || mGeneration != generation; });
+			if (mStop)
+				return;
+			generation = mGeneration;
+			active = index < mActiveWorkers;
+		}
+
+		if (active)
+			RunChunks();
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (--mBusyWorkers == 0)
+			mDone.notify_one();
+	}
+}
+
+void ThreadPool::RunChunks()
+{
+	for (int chunk = mNextChunk++; chunk < mChunkCount; chunk = mNextChunk++)
+	{
+		const int begin = chunk * mChunkSize;
+		(*mTask)(begin, std::min(begin + mChunkSize, mCount));
+	}
+}
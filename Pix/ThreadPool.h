@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads for splitting per pixel work across cores. Workers start on first use and
+// sleep between calls. ParallelFor is not reentrant, tasks must not call it again.
+class ThreadPool
+{
+public:
+	static ThreadPool* Get();
+
+public:
+	using Task = std::function<void(int begin, int end)>;
+
+	~ThreadPool();
+
+	// Runs task over [0, count) in chunks of grainSize items. Idle threads take the next chunk, so
+	// chunks that cost more are balanced out. The calling thread takes chunks too and returns once
+	// every chunk is done. maxThreads limits the threads taking part, 0 uses all of them.
+	void ParallelFor(int count, int grainSize, const Task& task, int maxThreads = 0);
+
+	// Workers plus the calling thread
+	int GetThreadCount() const { return static_cast<int>(mThreads.size()) + 1; }
+
+private:
+	void Start();
+	void WorkerLoop(int index);
+	void RunChunks();
+
+	std::vector<std::thread> mThreads;
+	std::mutex mMutex;
+	std::condition_variable mWake;
+	std::condition_variable mDone;
+	const Task* mTask = nullptr;
+	std::atomic<int> mNextChunk{ 0 };
+	int mChunkCount = 0;
+	int mChunkSize = 0;
+	int mCount = 0;
+	int mActiveWorkers = 0;
+	int mBusyWorkers = 0;
+	uint32_t mGeneration = 0;
+	bool mStarted = false;
+	bool mStop = false;
+};
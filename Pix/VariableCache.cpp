@@ -12,6 +12,7 @@ VariableCache* VariableCache::Get()
 void VariableCache::Clear()
 {
 	mFloatVars.clear();
+	++mVersion;
 }
 
 bool VariableCache::IsVarName(const std::string& name) const
@@ -49,6 +50,19 @@ float VariableCache::GetFloat(const std::string& param)
 	return stof(param);
 }
 
+bool VariableCache::FindFloat(const std::string& name, float& value) const
+{
+	auto iter = std::find_if(mFloatVars.begin(), mFloatVars.end(), [&name](auto& var)
+	{
+		return var.name == name;
+	});
+	if (iter == mFloatVars.end())
+		return false;
+
+	value = (*iter).value;
+	return true;
+}
+
 void VariableCache::ShowEditor()
 {
 	if (mFloatVars.empty())
@@ -56,6 +70,9 @@ void VariableCache::ShowEditor()
 
 	ImGui::Begin("Variables", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
 	for (auto& var : mFloatVars)
-		ImGui::DragFloat(var.name.c_str(), &var.value, var.speed, var.min, var.max);
+	{
+		if (ImGui::DragFloat(var.name.c_str(), &var.value, var.speed, var.min, var.max))
+			++mVersion;
+	}
 	ImGui::End();
 }
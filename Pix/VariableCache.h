@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cfloat>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -17,8 +18,14 @@ public:
 	void AddFloat(const std::string& name, float value, float speed = 0.01f, float min = -FLT_MAX, float max = FLT_MAX);
 	float GetFloat(const std::string& param);
 
+	// Returns false for a name that was not added
+	bool FindFloat(const std::string& name, float& value) const;
+
 	void ShowEditor();
 
+	// Bumped when the variables are cleared or edited so users can tell the script inputs changed
+	uint32_t GetVersion() const { return mVersion; }
+
 private:
 	struct FloatVar
 	{
@@ -30,4 +37,5 @@ private:
 	};
 
 	std::vector<FloatVar> mFloatVars;
+	uint32_t mVersion = 0;
 };
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Vector2.h"
+#include "Vector3.h"
+
+#include <cstdint>
+
+struct Vertex
+{
+	Vector3 pos;
+	float w = 1.0f;
+	uint32_t color = 0xffffffff;	// Packed premultiplied RGBA8, see Blend.h
+	Vector2 uv;
+};
@@ -0,0 +1,48 @@
+#include "VertexBatch.h"
+
+#include "Simd.h"
+
+void VertexBatch::Resize(size_t size)
+{
+	const size_t paddedSize = (size + 3) & ~size_t(3);
+	x.resize(paddedSize);
+	y.resize(paddedSize);
+	z.resize(paddedSize);
+	w.resize(paddedSize);
+	count = size;
+}
+
+void VertexBatch::Transform(const Matrix4& m, const VertexBatch& input)
+{
+	Resize(input.count);
+
+	const size_t size = x.size();
+#if PIX_SSE
+	// Splat each matrix element once, then do four vertices per iteration
+	const __m128 m11 = _mm_set1_ps(m._11), m12 = _mm_set1_ps(m._12), m13 = _mm_set1_ps(m._13), m14 = _mm_set1_ps(m._14);
+	const __m128 m21 = _mm_set1_ps(m._21), m22 = _mm_set1_ps(m._22), m23 = _mm_set1_ps(m._23), m24 = _mm_set1_ps(m._24);
+	const __m128 m31 = _mm_set1_ps(m._31), m32 = _mm_set1_ps(m._32), m33 = _mm_set1_ps(m._33), m34 = _mm_set1_ps(m._34);
+	const __m128 m41 = _mm_set1_ps(m._41), m42 = _mm_set1_ps(m._42), m43 = _mm_set1_ps(m._43), m44 = _mm_set1_ps(m._44);
+	for (size_t i = 0; i < size; i += 4)
+	{
+		const __m128 vx = _mm_loadu_ps(&input.x[i]);
+		const __m128 vy = _mm_loadu_ps(&input.y[i]);
+		const __m128 vz = _mm_loadu_ps(&input.z[i]);
+		_mm_storeu_ps(&x[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m11), _mm_mul_ps(vy, m21)), _mm_add_ps(_mm_mul_ps(vz, m31), m41)));
+		_mm_storeu_ps(&y[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m12), _mm_mul_ps(vy, m22)), _mm_add_ps(_mm_mul_ps(vz, m32), m42)));
+		_mm_storeu_ps(&z[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m13), _mm_mul_ps(vy, m23)), _mm_add_ps(_mm_mul_ps(vz, m33), m43)));
+		_mm_storeu_ps(&w[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m14), _mm_mul_ps(vy, m24)), _mm_add_ps(_mm_mul_ps(vz, m34), m44)));
+	}
+#else
+	for (size_t i = 0; i < size; ++i)
+	{
+		const float vx = input.x[i];
+		const float vy = input.y[i];
+		const float vz = input.z[i];
+		x[i] = vx * m._11 + vy * m._21 + vz * m._31 + m._41;
+		y[i] = vx * m._12 + vy * m._22 + vz * m._32 + m._42;
+		z[i] = vx * m._13 + vy * m._23 + vz * m._33 + m._43;
+		w[i] = vx * m._14 + vy * m._24 + vz * m._34 + m._44;
+	}
+#endif
+}
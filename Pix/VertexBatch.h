@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Matrix4.h"
+
+#include <vector>
+
+// Positions stored as separate x, y, z, w arrays so four vertices transform per SIMD op.
+// Arrays are padded to a multiple of four, the padding lanes hold garbage.
+struct VertexBatch
+{
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+	std::vector<float> w;
+	size_t count = 0;
+
+	void Resize(size_t size);
+
+	// Transforms the points (x, y, z, 1) of input into homogeneous coordinates
+	void Transform(const Matrix4& m, const VertexBatch& input);
+};
@@ -10,7 +10,10 @@ Viewport* Viewport::Get()
 
 void Viewport::OnNewFrame()
 {
-	*this = {};
+	// Reset to the full screen, keeping the screen size
+	SetScreenSize(mScreenWidth, mScreenHeight);
+	mShowViewport = false;
+	mClipping = false;
 }
 
 void Viewport::DrawViewport()
@@ -19,10 +22,25 @@ void Viewport::DrawViewport()
 		X::DrawScreenRect({ mPosX, mPosY, mPosX + mWidth, mPosY + mHeight }, X::Colors::White);
 }
 
+void Viewport::SetScreenSize(int width, int height)
+{
+	mScreenWidth = X::Math::Max(width, 0);
+	mScreenHeight = X::Math::Max(height, 0);
+	mPosX = 0.0f;
+	mPosY = 0.0f;
+	mWidth = static_cast<float>(mScreenWidth);
+	mHeight = static_cast<float>(mScreenHeight);
+	++mVersion;
+}
+
 void Viewport::SetViewport(float x, float y, float width, float height)
 {
-	mPosX = X::Math::Max(x, 0.0f);
-	mPosY = X::Math::Max(y, 0.0f);
-	mWidth = X::Math::Max(width, 0.0f);
-	mHeight = X::Math::Max(height, 0.0f);
+	// Keep the viewport inside the screen so it can be used as a clip rect
+	const float screenWidth = static_cast<float>(mScreenWidth);
+	const float screenHeight = static_cast<float>(mScreenHeight);
+	mPosX = X::Math::Clamp(x, 0.0f, screenWidth);
+	mPosY = X::Math::Clamp(y, 0.0f, screenHeight);
+	mWidth = X::Math::Clamp(width, 0.0f, screenWidth - mPosX);
+	mHeight = X::Math::Clamp(height, 0.0f, screenHeight - mPosY);
+	++mVersion;
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 class Viewport
 {
 public:
@@ -10,19 +12,31 @@ public:
 
 	void DrawViewport();
 
+	void SetScreenSize(int width, int height);
 	void SetViewport(float x, float y, float width, float height);
 	void ShowViewport(bool show) { mShowViewport = show; }
+	void SetClipping(bool clip) { mClipping = clip; }
 
 	float GetMinX() const { return mPosX; }
 	float GetMaxX() const { return mPosX + mWidth; }
 	float GetMinY() const { return mPosY; }
 	float GetMaxY() const { return mPosY + mHeight; }
 
+	int GetScreenWidth() const { return mScreenWidth; }
+	int GetScreenHeight() const { return mScreenHeight; }
+	bool IsClipping() const { return mClipping; }
+
+	// Bumped whenever the viewport rect changes so users can cache what they derive from it
+	uint32_t GetVersion() const { return mVersion; }
+
 private:
 	float mPosX = 0.0f;
 	float mPosY = 0.0f;
 	float mWidth = 0.0f;
 	float mHeight = 0.0f;
+	int mScreenWidth = 0;
+	int mScreenHeight = 0;
 	bool mShowViewport = false;
 	bool mClipping = false;
+	uint32_t mVersion = 0;
 };
\ No newline at end of file
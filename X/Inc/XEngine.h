@@ -96,6 +96,10 @@ namespace X
 	uint32_t GetRenderTextureWidth();
 	uint32_t GetRenderTextureHeight();
 
+	// Uploads rectangles of a width x height RGBA8 image, each pixel scaled to pixelSize x pixelSize.
+	// The pixels persist under the render texture drawing until overwritten, returns the bytes uploaded.
+	uint32_t UpdateRenderPixels(const uint32_t* pixels, uint32_t width, uint32_t height, const Math::Rect* rects, uint32_t rectCount);
+
 	// Random Functions
 	int Random();
 	int Random(int min, int max);
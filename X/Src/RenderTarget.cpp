@@ -40,6 +40,7 @@ void RenderTarget::Initialize(uint32_t width, uint32_t height, Format format)
 {
 	mWidth = width;
 	mHeight = height;
+	mFormat = format;
 
 	D3D11_TEXTURE2D_DESC desc{};
 	desc.Width = width;
@@ -107,6 +108,20 @@ void RenderTarget::EndRender()
 	GraphicsSystem::Get()->ResetViewport();
 }
 
+void RenderTarget::CopyFrom(Texture& texture)
+{
+	XASSERT(mFormat == Format::RGBA_U8, "[RenderTarget] Copies need an RGBA_U8 target.");
+	XASSERT(texture.GetWidth() == mWidth && texture.GetHeight() == mHeight, "[RenderTarget] Texture size does not match.");
+
+	ID3D11Resource* source = nullptr;
+	ID3D11Resource* dest = nullptr;
+	texture.GetShaderResourceView()->GetResource(&source);
+	mShaderResourceView->GetResource(&dest);
+	GraphicsSystem::Get()->GetContext()->CopyResource(dest, source);
+	SafeRelease(dest);
+	SafeRelease(source);
+}
+
 void RenderTarget::BindPS(uint32_t slot)
 {
 	GraphicsSystem::Get()->GetContext()->PSSetShaderResources(slot, 1, &mShaderResourceView);
@@ -35,6 +35,9 @@ namespace X
 		void BeginRender(const Color& clearColor = Colors::Black);
 		void EndRender();
 
+		// Copies a texture of the same size into an RGBA_U8 target on the GPU
+		void CopyFrom(Texture& texture);
+
 		void BindPS(uint32_t slot);
 		void UnbindPS(uint32_t slot);
 
@@ -50,6 +53,7 @@ namespace X
 		D3D11_MAPPED_SUBRESOURCE mSubresource;
 		uint32_t mWidth = 0;
 		uint32_t mHeight = 0;
+		Format mFormat = Format::RGBA_U8;
 	};
 }
 
@@ -151,6 +151,20 @@ void Texture::Terminate()
 
 //----------------------------------------------------------------------------------------------------
 
+void Texture::Update(const void* data, uint32_t rowPitch, uint32_t left, uint32_t top, uint32_t right, uint32_t bottom)
+{
+	XASSERT(right <= mWidth && bottom <= mHeight, "[Texture] Update rectangle out of bounds.");
+
+	ID3D11Resource* resource = nullptr;
+	mShaderResourceView->GetResource(&resource);
+
+	D3D11_BOX box{ left, top, 0, right, bottom, 1 };
+	GraphicsSystem::Get()->GetContext()->UpdateSubresource(resource, 0, &box, data, rowPitch, 0);
+	SafeRelease(resource);
+}
+
+//----------------------------------------------------------------------------------------------------
+
 void Texture::BindVS(uint32_t index)
 {
 	GraphicsSystem::Get()->GetContext()->VSSetShaderResources(index, 1, &mShaderResourceView);
@@ -17,6 +17,9 @@ public:
 	bool Initialize(const char* fileName);
 	bool Initialize(const void* data, uint32_t width, uint32_t height);
 	void Terminate();
+
+	// Overwrites the rectangle [left, right) x [top, bottom) of a texture created from RGBA8 data
+	void Update(const void* data, uint32_t rowPitch, uint32_t left, uint32_t top, uint32_t right, uint32_t bottom);
 	
 	void BindVS(uint32_t index);
 	void BindPS(uint32_t index);
@@ -96,6 +96,11 @@ namespace
 
 	RenderTarget myRenderTarget;
 	bool useRenderTarget = false;
+	uint32_t myPixelSize = 1;
+
+	// Persistent pixels copied under the render texture drawing every frame
+	Texture myRenderPixels;
+	std::vector<uint32_t> myScaledPixels;
 
 	std::vector<SpriteCommand> mySpriteCommands;
 	std::vector<TextCommand> myTextCommands;
@@ -214,7 +219,11 @@ void X::Run(GameLoop gameLoop)
 
 		// Are we using render target?
 		if (useRenderTarget)
+		{
 			myRenderTarget.BeginRender(myBackgroundColor);
+			if (myRenderPixels.GetShaderResourceView() != nullptr)
+				myRenderTarget.CopyFrom(myRenderPixels);
+		}
 
 		TextureId id = 0;
 		Texture* texture = nullptr;
@@ -275,6 +284,7 @@ void X::Stop()
 	myFont.Terminate();
 
 	// Terminate render target
+	myRenderPixels.Terminate();
 	myRenderTarget.Terminate();
 
 	// Shutdown all engine systems
@@ -624,15 +634,27 @@ uint32_t X::GetScreenHeight()
 
 void X::InitRenderTexture(uint32_t width, uint32_t height, uint32_t pixelSize)
 {
+	// Render target no larger than the back buffer
+	const uint32_t bufferWidth = X::Math::Min(width * pixelSize, GetScreenWidth());
+	const uint32_t bufferHeight = X::Math::Min(height * pixelSize, GetScreenHeight());
+
+	// Keep the render target, and the pixels uploaded to it, if nothing changed
+	if (useRenderTarget &&
+		bufferWidth == myRenderTarget.GetWidth() &&
+		bufferHeight == myRenderTarget.GetHeight() &&
+		Math::Max(pixelSize, 1u) == myPixelSize)
+		return;
+
 	// Clear any old render target data
 	if (useRenderTarget)
+	{
+		myRenderPixels.Terminate();
 		myRenderTarget.Terminate();
+	}
 
 	useRenderTarget = true;
+	myPixelSize = Math::Max(pixelSize, 1u);
 
-	// Initialize render target (no larger than the back buffer)
-	const uint32_t bufferWidth = X::Math::Min(width * pixelSize, GetScreenWidth());
-	const uint32_t bufferHeight = X::Math::Min(height * pixelSize, GetScreenHeight());
 	myRenderTarget.Initialize(bufferWidth, bufferHeight, X::RenderTarget::Format::RGBA_U8);
 
 	// Set camera aspect ratio
@@ -658,6 +680,60 @@ uint32_t X::GetRenderTextureHeight()
 	return myRenderTarget.GetHeight();
 }
 
+uint32_t X::UpdateRenderPixels(const uint32_t* pixels, uint32_t width, uint32_t height, const Math::Rect* rects, uint32_t rectCount)
+{
+	if (!useRenderTarget)
+		return 0;
+
+	const uint32_t targetWidth = myRenderTarget.GetWidth();
+	const uint32_t targetHeight = myRenderTarget.GetHeight();
+
+	// A new texture gets the whole image
+	const Math::Rect fullRect(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
+	if (myRenderPixels.GetShaderResourceView() == nullptr)
+	{
+		myScaledPixels.assign(targetWidth * targetHeight, 0);
+		myRenderPixels.Initialize(myScaledPixels.data(), targetWidth, targetHeight);
+		rects = &fullRect;
+		rectCount = 1;
+	}
+
+	uint32_t bytesUploaded = 0;
+	for (uint32_t i = 0; i < rectCount; ++i)
+	{
+		// Scale to render texture pixels, clipped to the source image and the texture
+		const Math::Rect& rect = rects[i];
+		const uint32_t left = Math::Min(static_cast<uint32_t>(Math::Max(rect.left, 0.0f)), width) * myPixelSize;
+		const uint32_t top = Math::Min(static_cast<uint32_t>(Math::Max(rect.top, 0.0f)), height) * myPixelSize;
+		const uint32_t right = Math::Min(Math::Min(static_cast<uint32_t>(Math::Max(rect.right, 0.0f)), width) * myPixelSize, targetWidth);
+		const uint32_t bottom = Math::Min(Math::Min(static_cast<uint32_t>(Math::Max(rect.bottom, 0.0f)), height) * myPixelSize, targetHeight);
+		if (left >= right || top >= bottom)
+			continue;
+
+		// Repeat each pixel pixel size times, rows that map to the same source row are copied
+		const uint32_t rectWidth = right - left;
+		const uint32_t rectHeight = bottom - top;
+		myScaledPixels.resize(rectWidth * rectHeight);
+		for (uint32_t y = 0; y < rectHeight; ++y)
+		{
+			uint32_t* row = &myScaledPixels[y * rectWidth];
+			if (y > 0 && (top + y) % myPixelSize != 0)
+			{
+				memcpy(row, row - rectWidth, rectWidth * sizeof(uint32_t));
+				continue;
+			}
+
+			const uint32_t* source = &pixels[((top + y) / myPixelSize) * width];
+			for (uint32_t x = 0; x < rectWidth; ++x)
+				row[x] = source[(left + x) / myPixelSize];
+		}
+
+		myRenderPixels.Update(myScaledPixels.data(), rectWidth * sizeof(uint32_t), left, top, right, bottom);
+		bytesUploaded += rectWidth * rectHeight * sizeof(uint32_t);
+	}
+	return bytesUploaded;
+}
+
 int X::Random()
 {
 	return std::uniform_int_distribution<>{ 0, (std::numeric_limits<int>::max)() }(myRandomEngine);